@@ -0,0 +1,294 @@
+#ifndef _ASP_ARC_TABLE_HPP_
+#define _ASP_ARC_TABLE_HPP_
+
+#include "associative_container_aux.hpp"
+#include "hash_table.hpp"
+#include "list.hpp"
+
+#include "basic_io.hpp"
+
+namespace asp {
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<_Value>
+> struct arc_table;
+
+namespace {
+template <typename _ExtOp> struct _select_arc_iter_action {
+    // _Tp == std::pair<list iterator, segment>
+    template <typename _Tp> auto operator()(const _Tp& _x) const {
+        return _ExtOp()(*_x.first);
+    }
+};
+};
+
+/**
+ * @brief cache structure of ARC (adaptive replacement cache)
+ * @details
+ *   resident elements are in two LRU lists : T1 for the ones seen once recently, T2 for the ones seen at least twice.
+ *   the keys evicted from T1 (T2) are kept in the ghost list B1 (B2), without the value.
+ *   the target size %_m_p of T1 adapts : putting a key of B1 means T1 was too small, so %_m_p grows,
+ *   putting a key of B2 shrinks it (by the ratio of the ghost sizes, at least 1).
+ *   a miss evicts the LRU one of T1 if T1 exceeds %_m_p, of T2 otherwise, so the cache balances
+ *   between recency (T1) and frequency (T2) by itself.
+ *   |T1| + |T2| <= c, |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c, with c = %capacity().
+ *
+ *   the resident and the ghost keys have their own hash table, mapping a key to its list node and list,
+ *   nodes are moved between lists by %list::splice.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc>
+struct arc_table {
+    typedef arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc> self;
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef list<_Value, _Alloc> list_t;
+    typedef list<_Key, typename std::allocator_traits<_Alloc>::template rebind_alloc<_Key>> ghost_list_t;
+    typedef typename list_t::iterator iterator;
+    typedef typename list_t::const_iterator const_iterator;
+    typedef typename ghost_list_t::iterator ghost_iterator;
+    enum segment : unsigned char { __T1__ = 0, __T2__, __B1__, __B2__ };
+    typedef hash_table<_Key, std::pair<iterator, segment>, _select_arc_iter_action<_ExtKey>, true, _select_arc_iter_action<_ExtValue>, _Hash, _Alloc> hash_table_t;
+    typedef hash_table<_Key, std::pair<ghost_iterator, segment>, _select_arc_iter_action<_select_self>, true, _select_arc_iter_action<_select_self>, _Hash, _Alloc> ghost_table_t;
+    typedef asso_container::type_traits<_Value, true> _ContainerTypeTraits;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+
+protected:
+    list_t _m_lists[2]; // T1, T2
+    ghost_list_t _m_ghosts[2]; // B1, B2
+    hash_table_t _h;
+    ghost_table_t _g;
+    size_type _m_capacity;
+    size_type _m_p = 0; // target size of T1
+
+public:
+/// (de)constructor
+    arc_table(size_type _capacity) : _m_capacity(_capacity) {}
+    arc_table(const self& _rhs) : _m_capacity(_rhs._m_capacity) { _M_assign(_rhs); }
+    self& operator=(const self& _rhs);
+    virtual ~arc_table() = default;
+
+    size_type size() const { return _h.size(); }
+    size_type capacity() const { return _m_capacity; }
+    bool empty() const { return size() == 0; }
+    void clear();
+    void resize(size_type _new_capacity);
+    const_iterator get(const key_type& _k);
+    void put(const value_type& _v);
+
+    const_iterator cend() const { return _m_lists[__T1__].cend(); }
+    // the target size of T1
+    size_type target() const { return _m_p; }
+
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A>
+     friend std::ostream& operator<<(std::ostream& _os, const arc_table<_K, _T, _Ek, _Ev, _H, _A>& _x);
+
+    int check() const;
+
+protected:
+    size_type _M_l1_size() const { return _m_lists[__T1__].size() + _m_ghosts[0].size(); }
+    size_type _M_ghost_size() const { return _m_ghosts[0].size() + _m_ghosts[1].size(); }
+    void _M_assign(const self& _rhs);
+    // move %_i to the MRU end of T2
+    void _M_promote(std::pair<iterator, segment>& _i);
+    /**
+     * @brief evict the LRU one of T1 or T2 (by %_m_p) into its ghost list
+     * @param _in_b2 : whether the key being put is in B2, which favors evicting from T1
+    */
+    void _M_replace(bool _in_b2);
+    // drop the LRU key of ghost list %_s
+    void _M_pop_ghost(segment _s);
+    // keep the ghost lists within their bounds
+    void _M_trim_ghosts();
+    void _M_push_front(const value_type& _v, segment _s);
+};
+
+/// protected implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_assign(const self& _rhs) -> void {
+    _m_capacity = _rhs._m_capacity;
+    _m_p = _rhs._m_p;
+    for (unsigned _s = __T1__; _s <= __T2__; ++_s) {
+        _m_lists[_s] = _rhs._m_lists[_s];
+        for (iterator _i = _m_lists[_s].begin(); _i != _m_lists[_s].end(); ++_i) {
+            _h.insert({_i, segment(_s)});
+        }
+        _m_ghosts[_s] = _rhs._m_ghosts[_s];
+        for (ghost_iterator _i = _m_ghosts[_s].begin(); _i != _m_ghosts[_s].end(); ++_i) {
+            _g.insert({_i, segment(__B1__ + _s)});
+        }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_promote(std::pair<iterator, segment>& _i) -> void {
+    _m_lists[__T2__].splice(_m_lists[__T2__].cbegin(), _m_lists[_i.second], _i.first);
+    _i.second = __T2__;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_replace(bool _in_b2) -> void {
+    const size_type _t1 = _m_lists[__T1__].size();
+    const segment _s = (_t1 > 0 && (_t1 > _m_p || (_in_b2 && _t1 == _m_p))) || _m_lists[__T2__].empty() ? __T1__ : __T2__;
+    const key_type _k = _ExtKey()(_m_lists[_s].back());
+    _h.erase(_k);
+    _m_lists[_s].pop_back();
+    _m_ghosts[_s].push_front(_k);
+    _g.insert({_m_ghosts[_s].begin(), segment(__B1__ + _s)});
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_pop_ghost(segment _s) -> void {
+    ghost_list_t& _b = _m_ghosts[_s - __B1__];
+    _g.erase(_b.back());
+    _b.pop_back();
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_trim_ghosts() -> void {
+    while (_M_l1_size() > _m_capacity && !_m_ghosts[0].empty()) {
+        _M_pop_ghost(__B1__);
+    }
+    while (size() + _M_ghost_size() > 2 * _m_capacity) {
+        _M_pop_ghost(_m_ghosts[1].empty() ? __B1__ : __B2__);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_push_front(const value_type& _v, segment _s) -> void {
+    _m_lists[_s].push_front(_v);
+    _h.insert({_m_lists[_s].begin(), _s});
+};
+
+/// public implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::operator=(const self& _rhs) -> self& {
+    if (&_rhs == this) return *this;
+    clear();
+    _M_assign(_rhs);
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::clear() -> void {
+    _h.clear();
+    _g.clear();
+    for (unsigned _s = __T1__; _s <= __T2__; ++_s) {
+        _m_lists[_s].clear();
+        _m_ghosts[_s].clear();
+    }
+    _m_p = 0;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::resize(size_type _new_capacity) -> void {
+    _m_capacity = _new_capacity;
+    if (_m_p > _m_capacity) {
+        _m_p = _m_capacity;
+    }
+    while (size() > _m_capacity) {
+        _M_replace(false);
+    }
+    _M_trim_ghosts();
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::get(const key_type& _k) -> const_iterator {
+    auto _i = _h.find(_k);
+    if (_i == _h.end()) return cend();
+    _M_promote(*_i);
+    return _i->first;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::put(const value_type& _v) -> void {
+    if (_m_capacity == 0) return;
+    const key_type& _k = _ExtKey()(_v);
+    auto _i = _h.find(_k);
+    if (_i != _h.end()) {
+        // a hit, the value is replaced by a new node at the MRU end of T2
+        const segment _s = _i->second;
+        const iterator _n = _i->first;
+        _h.erase(_k);
+        _m_lists[_s].erase(_n);
+        _M_push_front(_v, __T2__);
+        return;
+    }
+    auto _j = _g.find(_k);
+    if (_j != _g.end()) {
+        // a ghost hit, adapt the target then fetch into T2
+        const size_type _b1 = _m_ghosts[0].size(), _b2 = _m_ghosts[1].size();
+        const bool _in_b2 = _j->second == __B2__;
+        if (!_in_b2) {
+            const size_type _d = _b2 > _b1 ? _b2 / _b1 : 1;
+            _m_p = _m_p + _d < _m_capacity ? _m_p + _d : _m_capacity;
+        }
+        else {
+            const size_type _d = _b1 > _b2 ? _b1 / _b2 : 1;
+            _m_p = _m_p > _d ? _m_p - _d : 0;
+        }
+        // the ghost table reads the key through the node, so it's erased first
+        const ghost_iterator _n = _j->first;
+        _g.erase(_k);
+        _m_ghosts[_in_b2].erase(_n);
+        if (size() >= _m_capacity) {
+            _M_replace(_in_b2);
+        }
+        _M_push_front(_v, __T2__);
+        return;
+    }
+    // a complete miss
+    if (_M_l1_size() >= _m_capacity) {
+        if (_m_lists[__T1__].size() < _m_capacity) {
+            _M_pop_ghost(__B1__);
+            if (size() >= _m_capacity) {
+                _M_replace(false);
+            }
+        }
+        else {
+            // T1 fills the cache, its LRU one leaves without a ghost
+            _h.erase(_ExtKey()(_m_lists[__T1__].back()));
+            _m_lists[__T1__].pop_back();
+        }
+    }
+    else if (size() + _M_ghost_size() >= _m_capacity) {
+        if (size() + _M_ghost_size() >= 2 * _m_capacity) {
+            _M_pop_ghost(__B2__);
+        }
+        if (size() >= _m_capacity) {
+            _M_replace(false);
+        }
+    }
+    _M_push_front(_v, __T1__);
+};
+
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A> auto
+operator<<(std::ostream& _os, const arc_table<_K, _T, _Ek, _Ev, _H, _A>& _x) -> std::ostream& {
+    typedef arc_table<_K, _T, _Ek, _Ev, _H, _A> _Table;
+    return _os << "{p: " << _x._m_p
+     << ", t1: " << _x._m_lists[_Table::__T1__] << ", t2: " << _x._m_lists[_Table::__T2__]
+     << ", b1: " << _x._m_ghosts[0] << ", b2: " << _x._m_ghosts[1] << '}';
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+arc_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::check() const -> int {
+    if (size() > _m_capacity || _m_p > _m_capacity) {
+        return 1;
+    }
+    if (_M_l1_size() > _m_capacity || size() + _M_ghost_size() > 2 * _m_capacity) {
+        return 2;
+    }
+    if (_h.size() != _m_lists[__T1__].size() + _m_lists[__T2__].size() || _g.size() != _M_ghost_size()) {
+        return 3;
+    }
+    for (unsigned _s = __T1__; _s <= __T2__; ++_s) {
+        for (const_iterator _i = _m_lists[_s].cbegin(); _i != _m_lists[_s].cend(); ++_i) {
+            const auto _j = _h.find(_ExtKey()(*_i));
+            if (_j == _h.cend() || const_iterator(_j->first) != _i || _j->second != _s) {
+                return 4;
+            }
+        }
+        for (auto _i = _m_ghosts[_s].cbegin(); _i != _m_ghosts[_s].cend(); ++_i) {
+            const auto _j = _g.find(*_i);
+            if (_j == _g.cend() || _j->second != __B1__ + _s || _h.find(*_i) != _h.cend()) {
+                return 5;
+            }
+        }
+    }
+    return 0;
+};
+
+};
+
+#endif // _ASP_ARC_TABLE_HPP_
@@ -0,0 +1,80 @@
+#ifndef _ASP_ART_SET_HPP_
+#define _ASP_ART_SET_HPP_
+
+#include "basic_param.hpp"
+#include "art_tree.hpp"
+
+namespace asp {
+
+/**
+ * @brief adaptive radix tree based set with the interface of ordered_set, see @art_tree
+ * @tparam _KeyTraits encoding of keys, see @art_key_traits
+*/
+template <typename _Tp,
+ typename _KeyTraits = art_key_traits<_Tp>,
+ typename _Alloc = std::allocator<_Tp>
+> class art_set;
+
+template <typename _Tp, typename _KeyTraits, typename _Alloc>
+class art_set {
+    typedef art_set<_Tp, _KeyTraits, _Alloc> self;
+    typedef art_tree<_Tp, _Tp, _select_self, _KeyTraits, _Alloc> set_at;
+    set_at _r;
+public:
+    typedef typename set_at::key_type key_type;
+    typedef typename set_at::value_type value_type;
+    typedef typename set_at::mapped_type mapped_type;
+    typedef typename set_at::key_compare key_compare;
+    typedef typename set_at::iterator iterator;
+    typedef typename set_at::const_iterator const_iterator;
+    typedef typename set_at::ireturn_type ireturn_type;
+    typedef typename set_at::insert_status insert_status;
+    typedef typename set_at::ext_iterator ext_iterator;
+    typedef typename set_at::ext_key ext_key;
+    typedef typename set_at::ext_value ext_value;
+    typedef typename set_at::allocator_type allocator_type;
+
+/// (de)constructor
+    art_set() = default;
+    art_set(const self& _x) : _r(_x._r) {}
+    virtual ~art_set() = default;
+
+/// implement
+    size_type size() const { return _r.size(); }
+    bool empty() const { return _r.empty(); }
+    iterator begin() { return _r.begin(); }
+    iterator end() { return _r.end(); }
+    const_iterator cbegin() const { return _r.cbegin(); }
+    const_iterator cend() const { return _r.cend(); }
+    ireturn_type insert(const value_type& _v) { return _r.insert(_v); }
+    ireturn_type set(const key_type& _k, const mapped_type& _m) { return _r.insert(value_type(_k, _m)); }
+    size_type erase(const key_type& _k) { return _r.erase(_k); }
+    size_type count(const key_type& _k) const { return _r.count(_k); }
+    void clear() { _r.clear(); }
+    iterator find(const key_type& _k) { return _r.find(_k); }
+    const_iterator find(const key_type& _k) const { return _r.find(_k); }
+    iterator lower_bound(const key_type& _k) { return _r.lower_bound(_k); }
+    const_iterator lower_bound(const key_type& _k) const { return _r.lower_bound(_k); }
+    iterator upper_bound(const key_type& _k) { return _r.upper_bound(_k); }
+    const_iterator upper_bound(const key_type& _k) const { return _r.upper_bound(_k); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k) { return _r.equal_range(_k); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const { return _r.equal_range(_k); }
+#ifdef _CONTAINER_CHECK_
+    int check() const { return _r.check(); }
+#endif // _CONTAINER_CHECK_
+
+/// output
+    template <typename _T, typename _KT, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const art_set<_T, _KT, _A>& _um);
+};
+
+template <typename _Tp, typename _KeyTraits, typename _Alloc> auto
+operator<<(std::ostream& os, const art_set<_Tp, _KeyTraits, _Alloc>& _um)
+-> std::ostream& {
+    os << _um._r;
+    return os;
+};
+
+};
+
+#endif // _ASP_ART_SET_HPP_
@@ -0,0 +1,917 @@
+#ifndef _ASP_ART_TREE_HPP_
+#define _ASP_ART_TREE_HPP_
+
+#include "basic_param.hpp"
+#include "basic_io.hpp"
+#include "iterator.hpp"
+#include "associative_container_aux.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace asp {
+
+template <typename _Key, typename = void> struct art_key_traits;
+struct art_inner_node;
+struct art_leaf_base;
+template <typename _Value> struct art_leaf;
+template <typename _Tp> struct art_iterator;
+template <typename _Tp> struct art_const_iterator;
+template <typename _Key, typename _Value, typename _ExtKey,
+ typename _KeyTraits = art_key_traits<_Key>, typename _Alloc = std::allocator<_Value>> class art_tree;
+
+/**
+ * @brief binary-comparable encoding of keys for @art_tree
+ * @details %_S_encode(_k, _out) appends the bytes of %_k to %_out,
+ *   whose lexicographical order (as unsigned char) is the order of keys,
+ *   and no encoded key is a prefix of another one.
+*/
+template <typename _Key> struct art_key_traits<_Key, std::enable_if_t<std::is_integral<_Key>::value && !std::is_same<_Key, bool>::value>> {
+    // big endian, with the sign bit flipped
+    static void _S_encode(const _Key& _k, std::string& _out) {
+        typedef std::make_unsigned_t<_Key> _Unsigned;
+        _Unsigned _u = static_cast<_Unsigned>(_k);
+        if (std::is_signed<_Key>::value) {
+            _u ^= _Unsigned(1) << (sizeof(_Unsigned) * 8 - 1);
+        }
+        for (int _i = sizeof(_Unsigned) - 1; _i >= 0; --_i) {
+            _out.push_back(static_cast<char>(_u >> (_i * 8)));
+        }
+    }
+};
+template <> struct art_key_traits<std::string> {
+    // '\0' is escaped as "\0\xff", and the key ends with "\0\0"
+    static void _S_encode(const std::string& _k, std::string& _out) {
+        for (char _c : _k) {
+            _out.push_back(_c);
+            if (_c == '\0') {
+                _out.push_back('\xff');
+            }
+        }
+        _out.push_back('\0');
+        _out.push_back('\0');
+    }
+};
+
+enum _Art_node_type : unsigned char { _S_node4, _S_node16, _S_node48, _S_node256 };
+
+/**
+ * @brief inner node of @art_tree
+ * @details the path compressed prefix of a node is %_prefix_len bytes, and only the first %_S_max_prefix are stored :
+ *   %find() and %erase() skip the rest optimistically and compare the whole key at the leaf,
+ *   the others read them from the minimum leaf of the subtree.
+*/
+struct art_inner_node {
+    static constexpr const size_type _S_max_prefix = 8;
+
+    explicit art_inner_node(_Art_node_type _t) : _type(_t) {}
+
+    _Art_node_type _type;
+    unsigned short _count = 0;
+    size_type _prefix_len = 0;
+    unsigned char _prefix[_S_max_prefix] = {};
+};
+// children are sorted by %_keys
+struct art_node4 : public art_inner_node {
+    static constexpr const size_type _S_capacity = 4;
+    art_node4() : art_inner_node(_S_node4) {}
+    unsigned char _keys[4] = {};
+    std::uintptr_t _child[4] = {};
+};
+struct art_node16 : public art_inner_node {
+    static constexpr const size_type _S_capacity = 16;
+    art_node16() : art_inner_node(_S_node16) {}
+    unsigned char _keys[16] = {};
+    std::uintptr_t _child[16] = {};
+};
+// %_index[_c] is 1 + the slot of the child of byte %_c, or 0
+struct art_node48 : public art_inner_node {
+    static constexpr const size_type _S_capacity = 48;
+    art_node48() : art_inner_node(_S_node48) {}
+    unsigned char _index[256] = {};
+    std::uintptr_t _child[48] = {};
+};
+struct art_node256 : public art_inner_node {
+    static constexpr const size_type _S_capacity = 256;
+    art_node256() : art_inner_node(_S_node256) {}
+    std::uintptr_t _child[256] = {};
+};
+
+/**
+ * @brief leaves of @art_tree are linked in key order, with the header of the tree as end().
+*/
+struct art_leaf_base {
+    art_leaf_base* _prev = this;
+    art_leaf_base* _next = this;
+};
+template <typename _Value> struct art_leaf : public art_leaf_base {
+    template <typename... _Args> art_leaf(_Args&&... _args) : _v(std::forward<_Args>(_args)...) {}
+    _Value _v;
+};
+
+template <typename _Tp> struct art_iterator {
+    typedef asp::bidirectional_iterator_tag iterator_category;
+    typedef _Tp value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef asp::difference_type difference_type;
+    typedef art_iterator<_Tp> self;
+
+    art_leaf_base* _ptr = nullptr;
+
+    art_iterator() = default;
+    art_iterator(art_leaf_base* _x) : _ptr(_x) {}
+    value_type& operator*() const { return static_cast<art_leaf<_Tp>*>(_ptr)->_v; }
+    value_type* operator->() const { return &static_cast<art_leaf<_Tp>*>(_ptr)->_v; }
+    self& operator++() { _ptr = _ptr->_next; return *this; }
+    self operator++(int) { self _ret = *this; _ptr = _ptr->_next; return _ret; }
+    self& operator--() { _ptr = _ptr->_prev; return *this; }
+    self operator--(int) { self _ret = *this; _ptr = _ptr->_prev; return _ret; }
+    operator bool() const { return _ptr != nullptr; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._ptr == _y._ptr; }
+    friend bool operator!=(const self& _x, const self& _y) { return _x._ptr != _y._ptr; }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const art_iterator<_T>& _r);
+};
+template <typename _Tp> struct art_const_iterator {
+    typedef asp::bidirectional_iterator_tag iterator_category;
+    typedef _Tp value_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+    typedef asp::difference_type difference_type;
+    typedef art_const_iterator<_Tp> self;
+    typedef art_iterator<_Tp> iterator;
+
+    const art_leaf_base* _ptr = nullptr;
+
+    art_const_iterator() = default;
+    art_const_iterator(const art_leaf_base* _x) : _ptr(_x) {}
+    art_const_iterator(const iterator& _i) : _ptr(_i._ptr) {}
+    const value_type& operator*() const { return static_cast<const art_leaf<_Tp>*>(_ptr)->_v; }
+    const value_type* operator->() const { return &static_cast<const art_leaf<_Tp>*>(_ptr)->_v; }
+    self& operator++() { _ptr = _ptr->_next; return *this; }
+    self operator++(int) { self _ret = *this; _ptr = _ptr->_next; return _ret; }
+    self& operator--() { _ptr = _ptr->_prev; return *this; }
+    self operator--(int) { self _ret = *this; _ptr = _ptr->_prev; return _ret; }
+    operator bool() const { return _ptr != nullptr; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._ptr == _y._ptr; }
+    friend bool operator!=(const self& _x, const self& _y) { return _x._ptr != _y._ptr; }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const art_const_iterator<_T>& _r);
+};
+
+/**
+ * @brief adaptive radix tree (Leis et al.), ordered container with unique keys and the interface of @rb_tree
+ * @details
+ *   keys are encoded into binary-comparable bytes by %_KeyTraits, and the tree branches on one byte per level,
+ *   so a lookup costs O(length of key) instead of O(log(n)) comparisons.
+ *   - adaptive nodes : an inner node is @art_node4, @art_node16, @art_node48 or @art_node256 by the number of children,
+ *     and grows or shrinks between them. @art_node16 is searched with SSE2 when available.
+ *   - path compression : an inner node with a single child is merged into the child as its prefix.
+ *   - lazy expansion : a leaf hangs at the first byte where its key differs from the others.
+ *   leaves are linked in key order for iteration, the iterators are only invalidated by erasing their element.
+ *   the order of keys is the order of the encoded bytes, which agrees with std::less for @art_key_traits.
+ * @tparam _KeyTraits encoding of keys, see @art_key_traits
+*/
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+class art_tree {
+public:
+    typedef art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc> self;
+    typedef _Alloc allocator_type;
+
+    typedef _Key key_type;
+    typedef std::less<_Key> key_compare;
+    typedef _Value value_type;
+    typedef art_leaf<value_type> leaf_type;
+
+    typedef art_iterator<value_type> iterator;
+    typedef art_const_iterator<value_type> const_iterator;
+
+    typedef std::pair<iterator, bool> ireturn_type;
+    typedef asso_container::type_traits<value_type, true> _ContainerTypeTraits;
+
+    typedef typename _ContainerTypeTraits::insert_status insert_status;
+    typedef typename _ContainerTypeTraits::ext_iterator ext_iterator;
+    typedef typename _ContainerTypeTraits::ext_value ext_value;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef _ExtKey ext_key;
+
+    // a child link, tagged with the lowest bit if it points to a leaf
+    typedef std::uintptr_t node_ptr;
+
+    _Alloc _m_alloc;
+    node_ptr _m_root = 0;
+    art_leaf_base _m_header;
+    size_type _m_element_count = 0;
+
+    static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
+
+    template <typename _K, typename _V, typename _EK, typename _KT, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const art_tree<_K, _V, _EK, _KT, _A>& _t);
+
+public:
+    art_tree() = default;
+    art_tree(const self& _t);
+    virtual ~art_tree() { clear(); }
+
+    iterator begin() { return iterator(_m_header._next); }
+    const_iterator cbegin() const { return const_iterator(_m_header._next); }
+    iterator end() { return iterator(&_m_header); }
+    const_iterator cend() const { return const_iterator(&_m_header); }
+    size_type size() const { return _m_element_count; }
+    bool empty() const { return _m_element_count == 0; }
+
+    iterator find(const key_type& _k) { return iterator(const_cast<art_leaf_base*>(_M_find(_k))); }
+    const_iterator find(const key_type& _k) const { return const_iterator(_M_find(_k)); }
+    size_type count(const key_type& _k) const { return _M_find(_k) != &_m_header; }
+    void clear();
+    ireturn_type insert(const value_type& _v);
+    size_type erase(const key_type& _k);
+
+    iterator lower_bound(const key_type& _k) { return iterator(const_cast<art_leaf_base*>(_M_lower_bound(_k))); }
+    const_iterator lower_bound(const key_type& _k) const { return const_iterator(_M_lower_bound(_k)); }
+    iterator upper_bound(const key_type& _k) { return iterator(const_cast<art_leaf_base*>(_M_upper_bound(_k))); }
+    const_iterator upper_bound(const key_type& _k) const { return const_iterator(_M_upper_bound(_k)); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k) { return std::make_pair(lower_bound(_k), upper_bound(_k)); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const {
+        return std::make_pair(lower_bound(_k), upper_bound(_k));
+    }
+
+    // used for test
+    int check() const;
+
+protected:
+    // @art_node48 shrinks to @art_node16 at %_S_shrink48 children, and so on
+    static constexpr const size_type _S_shrink16 = 3;
+    static constexpr const size_type _S_shrink48 = 12;
+    static constexpr const size_type _S_shrink256 = 37;
+
+    static bool _S_is_leaf(node_ptr _p) { return _p & 1; }
+    static leaf_type* _S_leaf(node_ptr _p) { return reinterpret_cast<leaf_type*>(_p & ~node_ptr(1)); }
+    static art_inner_node* _S_inner(node_ptr _p) { return reinterpret_cast<art_inner_node*>(_p); }
+    static node_ptr _S_link(leaf_type* _l) { return reinterpret_cast<node_ptr>(_l) | 1; }
+    static node_ptr _S_link(art_inner_node* _x) { return reinterpret_cast<node_ptr>(_x); }
+    static void _S_encode(const key_type& _k, std::string& _b) { _b.clear(); _KeyTraits::_S_encode(_k, _b); }
+
+    // the link of the child on byte %_c, nullptr if none
+    static node_ptr* _S_find_child(art_inner_node* _x, unsigned char _c);
+    // the first child on a byte greater than %_c (-1 for the minimum child), 0 if none
+    static node_ptr _S_next_child(const art_inner_node* _x, int _c);
+    static const leaf_type* _S_minimum(node_ptr _p);
+    // add a child to %_x, which is not full
+    static void _S_push_child(art_inner_node* _x, unsigned char _c, node_ptr _child);
+    static void _S_pop_child(art_inner_node* _x, unsigned char _c);
+
+    template <typename _Tp, typename... _Args> _Tp* _M_create(_Args&&... _args);
+    template <typename _Tp> void _M_destroy(_Tp* _p);
+    art_inner_node* _M_create_inner(_Art_node_type _t);
+    void _M_destroy_inner(art_inner_node* _x);
+    // destroy the subtree of %_p, with its leaves
+    void _M_destroy_subtree(node_ptr _p);
+    // move the children of %_x into a new node of type %_t
+    art_inner_node* _M_resize(art_inner_node* _x, _Art_node_type _t);
+    void _M_add_child(node_ptr& _ref, unsigned char _c, node_ptr _child);
+    // remove a child, and shrink or merge the node
+    void _M_remove_child(node_ptr& _ref, unsigned char _c);
+
+    /**
+     * @brief the whole prefix of %_x, which is at %_depth of the key.
+     * @param _buf holds the key of the minimum leaf if the prefix isn't all stored
+    */
+    static const unsigned char* _S_prefix(const art_inner_node* _x, size_type _depth, std::string& _buf);
+    // the first byte of the prefix %_q of %_x which differs from %_b at %_depth, %_prefix_len if none
+    static size_type _S_prefix_mismatch(const art_inner_node* _x, const unsigned char* _q, const std::string& _b, size_type _depth);
+
+    const art_leaf_base* _M_find(const key_type& _k) const;
+    const art_leaf_base* _M_lower_bound(const key_type& _k) const;
+    const art_leaf_base* _M_upper_bound(const key_type& _k) const;
+    static void _S_link_before(art_leaf_base* _x, art_leaf_base* _next);
+    int _M_check(node_ptr _p, size_type _depth, const art_leaf_base*& _expected, std::string& _buf) const;
+};
+
+
+/// art_tree static implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_find_child(art_inner_node* _x, unsigned char _c)
+-> node_ptr* {
+    switch (_x->_type) {
+    case _S_node4: {
+        art_node4* const _n = static_cast<art_node4*>(_x);
+        for (size_type _i = 0; _i < _n->_count; ++_i) {
+            if (_n->_keys[_i] == _c) { return &_n->_child[_i]; }
+        }
+        return nullptr;
+    }
+    case _S_node16: {
+        art_node16* const _n = static_cast<art_node16*>(_x);
+#if defined(__SSE2__)
+        const __m128i _cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(_c)),
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(_n->_keys)));
+        const unsigned _mask = _mm_movemask_epi8(_cmp) & ((1u << _n->_count) - 1);
+        return _mask != 0 ? &_n->_child[__builtin_ctz(_mask)] : nullptr;
+#else
+        for (size_type _i = 0; _i < _n->_count; ++_i) {
+            if (_n->_keys[_i] == _c) { return &_n->_child[_i]; }
+        }
+        return nullptr;
+#endif
+    }
+    case _S_node48: {
+        art_node48* const _n = static_cast<art_node48*>(_x);
+        return _n->_index[_c] != 0 ? &_n->_child[_n->_index[_c] - 1] : nullptr;
+    }
+    default: {
+        art_node256* const _n = static_cast<art_node256*>(_x);
+        return _n->_child[_c] != 0 ? &_n->_child[_c] : nullptr;
+    }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_next_child(const art_inner_node* _x, int _c)
+-> node_ptr {
+    switch (_x->_type) {
+    case _S_node4: {
+        const art_node4* const _n = static_cast<const art_node4*>(_x);
+        for (size_type _i = 0; _i < _n->_count; ++_i) {
+            if (int(_n->_keys[_i]) > _c) { return _n->_child[_i]; }
+        }
+        return 0;
+    }
+    case _S_node16: {
+        const art_node16* const _n = static_cast<const art_node16*>(_x);
+#if defined(__SSE2__)
+        if (_c < 0) { return _n->_count > 0 ? _n->_child[0] : 0; }
+        // unsigned comparison by signed comparison with the sign bits flipped
+        const __m128i _flip = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i _gt = _mm_cmpgt_epi8(
+         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_n->_keys)), _flip),
+         _mm_xor_si128(_mm_set1_epi8(static_cast<char>(_c)), _flip));
+        const unsigned _mask = _mm_movemask_epi8(_gt) & ((1u << _n->_count) - 1);
+        return _mask != 0 ? _n->_child[__builtin_ctz(_mask)] : 0;
+#else
+        for (size_type _i = 0; _i < _n->_count; ++_i) {
+            if (int(_n->_keys[_i]) > _c) { return _n->_child[_i]; }
+        }
+        return 0;
+#endif
+    }
+    case _S_node48: {
+        const art_node48* const _n = static_cast<const art_node48*>(_x);
+        for (int _i = _c + 1; _i < 256; ++_i) {
+            if (_n->_index[_i] != 0) { return _n->_child[_n->_index[_i] - 1]; }
+        }
+        return 0;
+    }
+    default: {
+        const art_node256* const _n = static_cast<const art_node256*>(_x);
+        for (int _i = _c + 1; _i < 256; ++_i) {
+            if (_n->_child[_i] != 0) { return _n->_child[_i]; }
+        }
+        return 0;
+    }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_minimum(node_ptr _p)
+-> const leaf_type* {
+    while (!_S_is_leaf(_p)) {
+        _p = _S_next_child(_S_inner(_p), -1);
+    }
+    return _S_leaf(_p);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_push_child(art_inner_node* _x, unsigned char _c, node_ptr _child)
+-> void {
+    switch (_x->_type) {
+    case _S_node4: case _S_node16: {
+        unsigned char* const _keys = _x->_type == _S_node4 ? static_cast<art_node4*>(_x)->_keys : static_cast<art_node16*>(_x)->_keys;
+        node_ptr* const _children = _x->_type == _S_node4 ? static_cast<art_node4*>(_x)->_child : static_cast<art_node16*>(_x)->_child;
+        size_type _i = _x->_count;
+        for (; _i > 0 && _keys[_i - 1] > _c; --_i) {
+            _keys[_i] = _keys[_i - 1];
+            _children[_i] = _children[_i - 1];
+        }
+        _keys[_i] = _c;
+        _children[_i] = _child;
+        break;
+    }
+    case _S_node48: {
+        art_node48* const _n = static_cast<art_node48*>(_x);
+        size_type _slot = 0;
+        while (_n->_child[_slot] != 0) { ++_slot; }
+        _n->_child[_slot] = _child;
+        _n->_index[_c] = _slot + 1;
+        break;
+    }
+    default:
+        static_cast<art_node256*>(_x)->_child[_c] = _child;
+    }
+    ++_x->_count;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_pop_child(art_inner_node* _x, unsigned char _c)
+-> void {
+    switch (_x->_type) {
+    case _S_node4: case _S_node16: {
+        unsigned char* const _keys = _x->_type == _S_node4 ? static_cast<art_node4*>(_x)->_keys : static_cast<art_node16*>(_x)->_keys;
+        node_ptr* const _children = _x->_type == _S_node4 ? static_cast<art_node4*>(_x)->_child : static_cast<art_node16*>(_x)->_child;
+        size_type _i = 0;
+        while (_keys[_i] != _c) { ++_i; }
+        for (; _i + 1 < _x->_count; ++_i) {
+            _keys[_i] = _keys[_i + 1];
+            _children[_i] = _children[_i + 1];
+        }
+        break;
+    }
+    case _S_node48: {
+        art_node48* const _n = static_cast<art_node48*>(_x);
+        _n->_child[_n->_index[_c] - 1] = 0;
+        _n->_index[_c] = 0;
+        break;
+    }
+    default:
+        static_cast<art_node256*>(_x)->_child[_c] = 0;
+    }
+    --_x->_count;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_prefix(const art_inner_node* _x, size_type _depth, std::string& _buf)
+-> const unsigned char* {
+    if (_x->_prefix_len <= art_inner_node::_S_max_prefix) {
+        return _x->_prefix;
+    }
+    _S_encode(_S_key(_S_minimum(_S_link(const_cast<art_inner_node*>(_x)))->_v), _buf);
+    return reinterpret_cast<const unsigned char*>(_buf.data()) + _depth;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_prefix_mismatch(const art_inner_node* _x, const unsigned char* _q, const std::string& _b, size_type _depth)
+-> size_type {
+    size_type _i = 0;
+    while (_i < _x->_prefix_len && _depth + _i < _b.size() && _q[_i] == static_cast<unsigned char>(_b[_depth + _i])) {
+        ++_i;
+    }
+    return _i;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_S_link_before(art_leaf_base* _x, art_leaf_base* _next)
+-> void {
+    _x->_next = _next;
+    _x->_prev = _next->_prev;
+    _next->_prev->_next = _x;
+    _next->_prev = _x;
+};
+
+/// art_tree protected implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+template <typename _Tp, typename... _Args> auto
+art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_create(_Args&&... _args) -> _Tp* {
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<_Tp> _Tp_alloc;
+    _Tp_alloc _a(_m_alloc);
+    _Tp* const _p = std::allocator_traits<_Tp_alloc>::allocate(_a, 1);
+    std::allocator_traits<_Tp_alloc>::construct(_a, _p, std::forward<_Args>(_args)...);
+    return _p;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+template <typename _Tp> auto
+art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_destroy(_Tp* _p) -> void {
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<_Tp> _Tp_alloc;
+    _Tp_alloc _a(_m_alloc);
+    std::allocator_traits<_Tp_alloc>::destroy(_a, _p);
+    std::allocator_traits<_Tp_alloc>::deallocate(_a, _p, 1);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_create_inner(_Art_node_type _t)
+-> art_inner_node* {
+    switch (_t) {
+    case _S_node4: return _M_create<art_node4>();
+    case _S_node16: return _M_create<art_node16>();
+    case _S_node48: return _M_create<art_node48>();
+    default: return _M_create<art_node256>();
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_destroy_inner(art_inner_node* _x)
+-> void {
+    switch (_x->_type) {
+    case _S_node4: _M_destroy(static_cast<art_node4*>(_x)); break;
+    case _S_node16: _M_destroy(static_cast<art_node16*>(_x)); break;
+    case _S_node48: _M_destroy(static_cast<art_node48*>(_x)); break;
+    default: _M_destroy(static_cast<art_node256*>(_x));
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_destroy_subtree(node_ptr _p)
+-> void {
+    if (_S_is_leaf(_p)) {
+        _M_destroy(_S_leaf(_p));
+        return;
+    }
+    art_inner_node* const _x = _S_inner(_p);
+    for (int _i = 0; _i < 256; ++_i) {
+        if (const node_ptr* const _l = _S_find_child(_x, _i)) {
+            _M_destroy_subtree(*_l);
+        }
+    }
+    _M_destroy_inner(_x);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_resize(art_inner_node* _x, _Art_node_type _t)
+-> art_inner_node* {
+    art_inner_node* const _y = _M_create_inner(_t);
+    _y->_prefix_len = _x->_prefix_len;
+    std::memcpy(_y->_prefix, _x->_prefix, art_inner_node::_S_max_prefix);
+    for (int _i = 0; _i < 256; ++_i) {
+        if (node_ptr* const _l = _S_find_child(_x, _i)) {
+            _S_push_child(_y, _i, *_l);
+        }
+    }
+    _M_destroy_inner(_x);
+    return _y;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_add_child(node_ptr& _ref, unsigned char _c, node_ptr _child)
+-> void {
+    art_inner_node* _x = _S_inner(_ref);
+    switch (_x->_type) {
+    case _S_node4:
+        if (_x->_count == art_node4::_S_capacity) { _x = _M_resize(_x, _S_node16); }
+        break;
+    case _S_node16:
+        if (_x->_count == art_node16::_S_capacity) { _x = _M_resize(_x, _S_node48); }
+        break;
+    case _S_node48:
+        if (_x->_count == art_node48::_S_capacity) { _x = _M_resize(_x, _S_node256); }
+        break;
+    default:
+        break;
+    }
+    _S_push_child(_x, _c, _child);
+    _ref = _S_link(_x);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_remove_child(node_ptr& _ref, unsigned char _c)
+-> void {
+    art_inner_node* _x = _S_inner(_ref);
+    _S_pop_child(_x, _c);
+    switch (_x->_type) {
+    case _S_node4:
+        if (_x->_count == 1) {
+            // merge %_x into its only child
+            art_node4* const _n = static_cast<art_node4*>(_x);
+            const node_ptr _child = _n->_child[0];
+            if (!_S_is_leaf(_child)) {
+                art_inner_node* const _y = _S_inner(_child);
+                unsigned char _prefix[art_inner_node::_S_max_prefix];
+                size_type _len = std::min(_x->_prefix_len, art_inner_node::_S_max_prefix);
+                std::memcpy(_prefix, _x->_prefix, _len);
+                if (_len < art_inner_node::_S_max_prefix) {
+                    _prefix[_len++] = _n->_keys[0];
+                }
+                const size_type _rest = std::min(_y->_prefix_len, art_inner_node::_S_max_prefix - _len);
+                std::memcpy(_prefix + _len, _y->_prefix, _rest);
+                std::memcpy(_y->_prefix, _prefix, _len + _rest);
+                _y->_prefix_len += _x->_prefix_len + 1;
+            }
+            _M_destroy_inner(_x);
+            _ref = _child;
+            return;
+        }
+        break;
+    case _S_node16:
+        if (_x->_count == _S_shrink16) { _x = _M_resize(_x, _S_node4); }
+        break;
+    case _S_node48:
+        if (_x->_count == _S_shrink48) { _x = _M_resize(_x, _S_node16); }
+        break;
+    default:
+        if (_x->_count == _S_shrink256) { _x = _M_resize(_x, _S_node48); }
+    }
+    _ref = _S_link(_x);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_find(const key_type& _k) const
+-> const art_leaf_base* {
+    std::string _b;
+    _S_encode(_k, _b);
+    node_ptr _p = _m_root;
+    size_type _depth = 0;
+    while (_p != 0 && !_S_is_leaf(_p)) {
+        art_inner_node* const _x = _S_inner(_p);
+        const size_type _stored = std::min(_x->_prefix_len, art_inner_node::_S_max_prefix);
+        if (_depth + _stored > _b.size() || std::memcmp(_x->_prefix, _b.data() + _depth, _stored) != 0) {
+            return &_m_header;
+        }
+        _depth += _x->_prefix_len;
+        if (_depth >= _b.size()) {
+            return &_m_header;
+        }
+        const node_ptr* const _l = _S_find_child(_x, _b[_depth]);
+        if (_l == nullptr) {
+            return &_m_header;
+        }
+        _p = *_l;
+        ++_depth;
+    }
+    if (_p == 0) {
+        return &_m_header;
+    }
+    const leaf_type* const _l = _S_leaf(_p);
+    const key_compare _comp;
+    return (_comp(_S_key(_l->_v), _k) || _comp(_k, _S_key(_l->_v))) ? &_m_header : _l;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_lower_bound(const key_type& _k) const
+-> const art_leaf_base* {
+    std::string _b, _buf;
+    _S_encode(_k, _b);
+    node_ptr _p = _m_root;
+    node_ptr _right = 0; // the nearest subtree after the path
+    size_type _depth = 0;
+    while (_p != 0) {
+        if (_S_is_leaf(_p)) {
+            _S_encode(_S_key(_S_leaf(_p)->_v), _buf);
+            if (_buf.compare(_b) >= 0) {
+                return _S_leaf(_p);
+            }
+            break;
+        }
+        const art_inner_node* const _x = _S_inner(_p);
+        const unsigned char* const _q = _S_prefix(_x, _depth, _buf);
+        const size_type _i = _S_prefix_mismatch(_x, _q, _b, _depth);
+        if (_i < _x->_prefix_len) {
+            if (_depth + _i >= _b.size() || _q[_i] > static_cast<unsigned char>(_b[_depth + _i])) {
+                return _S_minimum(_p);
+            }
+            break;
+        }
+        _depth += _x->_prefix_len;
+        if (_depth >= _b.size()) {
+            return _S_minimum(_p);
+        }
+        const unsigned char _c = _b[_depth];
+        if (const node_ptr _r = _S_next_child(_x, _c)) {
+            _right = _r;
+        }
+        const node_ptr* const _l = _S_find_child(const_cast<art_inner_node*>(_x), _c);
+        if (_l == nullptr) {
+            break;
+        }
+        _p = *_l;
+        ++_depth;
+    }
+    return _right != 0 ? _S_minimum(_right) : &_m_header;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_upper_bound(const key_type& _k) const
+-> const art_leaf_base* {
+    const art_leaf_base* const _l = _M_lower_bound(_k);
+    if (_l != &_m_header && !key_compare()(_k, _S_key(static_cast<const leaf_type*>(_l)->_v))) {
+        return _l->_next;
+    }
+    return _l;
+};
+
+
+/// art_tree public implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::art_tree(const self& _t) : _m_alloc(_t._m_alloc) {
+    for (const_iterator _i = _t.cbegin(); _i != _t.cend(); ++_i) {
+        insert(*_i);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc> auto
+art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::clear() -> void {
+    if (_m_root != 0) {
+        _M_destroy_subtree(_m_root);
+    }
+    _m_root = 0;
+    _m_header._prev = _m_header._next = &_m_header;
+    _m_element_count = 0;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc> auto
+art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::insert(const value_type& _v) -> ireturn_type {
+    std::string _b, _buf;
+    _S_encode(_S_key(_v), _b);
+    node_ptr* _ref = &_m_root;
+    node_ptr _right = 0; // the nearest subtree after the path
+    art_leaf_base* _next = nullptr; // the leaf after the new one
+    size_type _depth = 0;
+    leaf_type* _l = nullptr;
+    for (;;) {
+        const node_ptr _p = *_ref;
+        if (_p == 0) { // empty tree
+            _l = _M_create<leaf_type>(_v);
+            *_ref = _S_link(_l);
+            break;
+        }
+        if (_S_is_leaf(_p)) {
+            // lazy expansion, split the leaf by a new node at the first different byte
+            _S_encode(_S_key(_S_leaf(_p)->_v), _buf);
+            size_type _i = _depth;
+            while (_i < _b.size() && _i < _buf.size() && _b[_i] == _buf[_i]) { ++_i; }
+            if (_i == _b.size() && _i == _buf.size()) {
+                return ireturn_type(iterator(_S_leaf(_p)), false);
+            }
+            art_inner_node* const _x = _M_create_inner(_S_node4);
+            _x->_prefix_len = _i - _depth;
+            std::memcpy(_x->_prefix, _b.data() + _depth, std::min(_x->_prefix_len, art_inner_node::_S_max_prefix));
+            _l = _M_create<leaf_type>(_v);
+            _S_push_child(_x, _buf[_i], _p);
+            _S_push_child(_x, _b[_i], _S_link(_l));
+            if (static_cast<unsigned char>(_b[_i]) < static_cast<unsigned char>(_buf[_i])) {
+                _next = _S_leaf(_p);
+            }
+            *_ref = _S_link(_x);
+            break;
+        }
+        art_inner_node* const _x = _S_inner(_p);
+        const unsigned char* const _q = _S_prefix(_x, _depth, _buf);
+        const size_type _i = _S_prefix_mismatch(_x, _q, _b, _depth);
+        if (_i < _x->_prefix_len) {
+            // split the prefix of %_x by a new node at the %_i-th byte
+            const unsigned char _c = _q[_i];
+            art_inner_node* const _y = _M_create_inner(_S_node4);
+            _y->_prefix_len = _i;
+            std::memcpy(_y->_prefix, _b.data() + _depth, std::min(_i, art_inner_node::_S_max_prefix));
+            _x->_prefix_len -= _i + 1;
+            std::memmove(_x->_prefix, _q + _i + 1, std::min(_x->_prefix_len, art_inner_node::_S_max_prefix));
+            _l = _M_create<leaf_type>(_v);
+            _S_push_child(_y, _c, _p);
+            _S_push_child(_y, _b[_depth + _i], _S_link(_l));
+            if (static_cast<unsigned char>(_b[_depth + _i]) < _c) {
+                _next = const_cast<leaf_type*>(_S_minimum(_p));
+            }
+            *_ref = _S_link(_y);
+            break;
+        }
+        _depth += _x->_prefix_len;
+        const unsigned char _c = _b[_depth];
+        if (const node_ptr _r = _S_next_child(_x, _c)) {
+            _right = _r;
+        }
+        node_ptr* const _child = _S_find_child(_x, _c);
+        if (_child == nullptr) {
+            _l = _M_create<leaf_type>(_v);
+            _M_add_child(*_ref, _c, _S_link(_l));
+            break;
+        }
+        _ref = _child;
+        ++_depth;
+    }
+    if (_next == nullptr) {
+        _next = _right != 0 ? const_cast<leaf_type*>(_S_minimum(_right)) : &_m_header;
+    }
+    _S_link_before(_l, _next);
+    ++_m_element_count;
+    return ireturn_type(iterator(_l), true);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc> auto
+art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::erase(const key_type& _k) -> size_type {
+    std::string _b;
+    _S_encode(_k, _b);
+    node_ptr* _ref = &_m_root;
+    node_ptr* _parent = nullptr;
+    unsigned char _c = 0; // the byte of %_ref in %_parent
+    size_type _depth = 0;
+    while (*_ref != 0 && !_S_is_leaf(*_ref)) {
+        art_inner_node* const _x = _S_inner(*_ref);
+        const size_type _stored = std::min(_x->_prefix_len, art_inner_node::_S_max_prefix);
+        if (_depth + _stored > _b.size() || std::memcmp(_x->_prefix, _b.data() + _depth, _stored) != 0) {
+            return 0;
+        }
+        _depth += _x->_prefix_len;
+        if (_depth >= _b.size()) {
+            return 0;
+        }
+        node_ptr* const _l = _S_find_child(_x, _b[_depth]);
+        if (_l == nullptr) {
+            return 0;
+        }
+        _parent = _ref;
+        _c = _b[_depth];
+        _ref = _l;
+        ++_depth;
+    }
+    if (*_ref == 0) {
+        return 0;
+    }
+    leaf_type* const _l = _S_leaf(*_ref);
+    const key_compare _comp;
+    if (_comp(_S_key(_l->_v), _k) || _comp(_k, _S_key(_l->_v))) {
+        return 0;
+    }
+    if (_parent == nullptr) {
+        _m_root = 0;
+    }
+    else {
+        _M_remove_child(*_parent, _c);
+    }
+    _l->_prev->_next = _l->_next;
+    _l->_next->_prev = _l->_prev;
+    _M_destroy(_l);
+    --_m_element_count;
+    return 1;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::_M_check(node_ptr _p, size_type _depth, const art_leaf_base*& _expected, std::string& _buf) const
+-> int {
+    if (_S_is_leaf(_p)) {
+        if (_S_leaf(_p) != _expected) {
+            return 5;
+        }
+        _expected = _expected->_next;
+        return 0;
+    }
+    const art_inner_node* const _x = _S_inner(_p);
+    const size_type _capacity[] = {art_node4::_S_capacity, art_node16::_S_capacity, art_node48::_S_capacity, art_node256::_S_capacity};
+    size_type _n = 0;
+    for (int _i = 0; _i < 256; ++_i) {
+        _n += _S_find_child(const_cast<art_inner_node*>(_x), _i) != nullptr;
+    }
+    if (_n != _x->_count || _n < 2 || _n > _capacity[_x->_type]) {
+        return 2;
+    }
+    _S_encode(_S_key(_S_minimum(_p)->_v), _buf);
+    if (_buf.size() <= _depth + _x->_prefix_len ||
+     _buf.compare(_depth, std::min(_x->_prefix_len, art_inner_node::_S_max_prefix),
+      reinterpret_cast<const char*>(_x->_prefix), std::min(_x->_prefix_len, art_inner_node::_S_max_prefix)) != 0) {
+        return 4;
+    }
+    const size_type _next_depth = _depth + _x->_prefix_len + 1;
+    for (int _i = 0; _i < 256; ++_i) {
+        const node_ptr* const _l = _S_find_child(const_cast<art_inner_node*>(_x), _i);
+        if (_l == nullptr) {
+            continue;
+        }
+        _S_encode(_S_key(_S_minimum(*_l)->_v), _buf);
+        if (static_cast<unsigned char>(_buf[_next_depth - 1]) != _i) {
+            return 3;
+        }
+        if (int _ret = _M_check(*_l, _next_depth, _expected, _buf)) {
+            return _ret;
+        }
+    }
+    return 0;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _KeyTraits, typename _Alloc>
+auto art_tree<_Key, _Value, _ExtKey, _KeyTraits, _Alloc>::check() const -> int {
+    size_type _n = 0;
+    for (const art_leaf_base* _l = _m_header._next; _l != &_m_header; _l = _l->_next) {
+        if (_l->_next != &_m_header && !key_compare()(_S_key(static_cast<const leaf_type*>(_l)->_v),
+         _S_key(static_cast<const leaf_type*>(_l->_next)->_v))) {
+            return 1;
+        }
+        ++_n;
+    }
+    if (_n != _m_element_count) {
+        return 1;
+    }
+    if (_m_root == 0) {
+        return _n == 0 ? 0 : 5;
+    }
+    const art_leaf_base* _expected = _m_header._next;
+    std::string _buf;
+    if (int _ret = _M_check(_m_root, 0, _expected, _buf)) {
+        return _ret;
+    }
+    return _expected == &_m_header ? 0 : 5;
+};
+
+
+/// output implement
+template <typename _K, typename _V, typename _EK, typename _KT, typename _A>
+std::ostream& operator<<(std::ostream& os, const art_tree<_K, _V, _EK, _KT, _A>& _t) {
+    os << '[';
+    for (auto p = _t.cbegin(); p != _t.cend();) {
+        os << p;
+        if (++p != _t.cend()) {
+            os << ", ";
+        }
+    }
+    os << ']';
+    return os;
+};
+template <typename _T> std::ostream& operator<<(std::ostream& os, const art_iterator<_T>& _r) {
+    if (_r)
+        os << obj_string::_M_obj_2_string(*_r);
+    else
+        os << "null";
+    return os;
+};
+template <typename _T> std::ostream& operator<<(std::ostream& os, const art_const_iterator<_T>& _r) {
+    if (_r)
+        os << obj_string::_M_obj_2_string(*_r);
+    else
+        os << "null";
+    return os;
+};
+
+};
+
+#endif // _ASP_ART_TREE_HPP_
@@ -1,6 +1,7 @@
 #ifndef _ASP_ASSOCIATIVE_CONTAINER_AUX_HPP_
 #define _ASP_ASSOCIATIVE_CONTAINER_AUX_HPP_
 
+#include "basic_param.hpp"
 #include "type_traits.hpp"
 
 #include <utility>
@@ -61,6 +62,11 @@ struct _select_1x_ref {
     }
 };
 
+// every element weighs 1, so the capacity of a cache counts its elements
+struct _unit_weigher {
+    template <typename _Tp> size_type operator()(const _Tp&) const { return 1; }
+};
+
 /**
  * @brief type traits for associative container
 */
@@ -85,6 +91,41 @@ template <bool _b> struct bool_return {
     };
 };
 
+/**
+ * @brief interleaved execution of %_n independent lookups (asynchronous memory access chaining, AMAC)
+ * @details
+ *   a lookup in a node based container is a chain of dependent cache misses.
+ *   here %_Group lookups are in flight at the same time, each %_step advances one lookup by one node
+ *   and prefetches the node it visits next, then switches to the next lookup of the group,
+ *   so the memory latency of different lookups overlaps. a finished slot is refilled with the next lookup.
+ *   %_init(_State& _s, size_type _i) : start the %_i-th lookup in %_s.
+ *   %_step(_State& _s) -> bool : advance %_s, returns false if %_s is finished (and its result is written).
+ * @tparam _Group about the number of outstanding cache misses per core, 8 ~ 16
+*/
+template <size_type _Group, typename _State, typename _Init, typename _Step>
+void interleave(size_type _n, _Init _init, _Step _step) {
+    _State _s[_Group];
+    size_type _next = 0;
+    size_type _active = 0;
+    for (; _active < _Group && _next < _n; ++_active, ++_next) {
+        _init(_s[_active], _next);
+    }
+    while (_active > 0) {
+        for (size_type _j = 0; _j < _active;) {
+            if (_step(_s[_j])) {
+                ++_j;
+            }
+            else if (_next < _n) {
+                _init(_s[_j], _next++);
+                ++_j;
+            }
+            else {
+                _s[_j] = _s[--_active];
+            }
+        }
+    }
+};
+
 };
 
 };
@@ -0,0 +1,78 @@
+/**
+ * @brief %find_batch of @rb_tree and @skip_list against a loop of single %find calls
+ * @details g++ -std=c++17 -O2 -I.. batch_lookup_bench.cpp && ./a.out [size...]
+ *   the keys are random ints inserted in random order, the queries are uniform over the resident keys,
+ *   so trees much larger than the cache (e.g. 4M elements) show the overlap of the cache misses.
+ *   it prints ns per lookup of the single %find loop and of %find_batch with groups of 4, 8 and 16,
+ *   the results of every batch are compared with the single lookups.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_set>
+#include <vector>
+
+#include "../rb_tree.hpp"
+#include "../skip_list.hpp"
+#include "zipf_trace.hpp"
+
+template <typename _Tree, asp::size_type _Group> double _time_batch(const _Tree& _t, const std::vector<int>& _queries,
+ const std::vector<typename _Tree::const_iterator>& _expected) {
+    std::vector<typename _Tree::const_iterator> _out(_queries.size());
+    const double _ns = _elapsed_ns([&] {
+        _t.template find_batch<_Group>(_queries.data(), asp::size_type(_queries.size()), _out.data());
+    }) / _queries.size();
+    if (_out != _expected) {
+        std::printf("find_batch<%u> differs from find\n", _Group);
+        std::exit(1);
+    }
+    return _ns;
+};
+
+template <typename _Tree> void _bench(const char* _name, const std::vector<int>& _keys, const std::vector<int>& _queries) {
+    _Tree _t;
+    for (int _k : _keys) {
+        _t.insert(_k);
+    }
+    const _Tree& _ct = _t;
+    std::vector<typename _Tree::const_iterator> _expected(_queries.size());
+    const double _single = _elapsed_ns([&] {
+        for (std::size_t _i = 0; _i < _queries.size(); ++_i) {
+            _expected[_i] = _ct.find(_queries[_i]);
+        }
+    }) / _queries.size();
+    const double _g4 = _time_batch<_Tree, 4>(_ct, _queries, _expected);
+    const double _g8 = _time_batch<_Tree, 8>(_ct, _queries, _expected);
+    const double _g16 = _time_batch<_Tree, 16>(_ct, _queries, _expected);
+    std::printf("  %-10s find %7.1f ns  batch/4 %7.1f ns  batch/8 %7.1f ns  batch/16 %7.1f ns  (x%.2f at 8)\n",
+     _name, _single, _g4, _g8, _g16, _single / _g8);
+};
+
+int main(int argc, char** argv) {
+    std::vector<int> _sizes;
+    for (int _i = 1; _i < argc; ++_i) {
+        _sizes.push_back(std::atoi(argv[_i]));
+    }
+    if (_sizes.empty()) {
+        _sizes = {1 << 12, 1 << 16, 1 << 20};
+    }
+    for (int _size : _sizes) {
+        std::mt19937 _rng(7);
+        std::unordered_set<int> _seen;
+        std::vector<int> _keys;
+        while (int(_keys.size()) < _size) {
+            const int _k = int(_rng() >> 1);
+            if (_seen.insert(_k).second) {
+                _keys.push_back(_k);
+            }
+        }
+        std::vector<int> _queries(1 << 20);
+        for (int& _q : _queries) {
+            _q = _keys[_rng() % _keys.size()];
+        }
+        std::printf("size %d, %zu lookups\n", _size, _queries.size());
+        _bench<asp::rb_tree<int, int, asp::_select_self, true>>("rb_tree", _keys, _queries);
+        _bench<asp::skip_list<int, int, asp::_select_self, true>>("skip_list", _keys, _queries);
+    }
+    return 0;
+}
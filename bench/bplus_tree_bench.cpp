@@ -0,0 +1,81 @@
+/**
+ * @brief point lookups and range scans of @bplus_tree against @rb_tree
+ * @details g++ -std=c++17 -O2 -I.. bplus_tree_bench.cpp && ./a.out [size...]
+ *   each tree holds the same %size random keys, inserted in random order.
+ *   - find : uniform random keys (half of them missing), then zipf(0.99) over the resident keys;
+ *   - scan : %lower_bound of a random key then a walk over the next 100 elements.
+ *   it prints ns per lookup / per scanned element, a checksum keeps the loops from being optimized away.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../rb_tree.hpp"
+#include "../bplus_tree.hpp"
+#include "zipf_trace.hpp"
+
+static constexpr const int _S_scan_length = 100;
+
+template <typename _Tree> void _bench(const char* _name, const std::vector<int>& _keys,
+ const std::vector<int>& _uniform, const std::vector<int>& _skewed) {
+    _Tree _t;
+    for (int _k : _keys) {
+        _t.insert(_k);
+    }
+    if (_t.check() != 0) {
+        std::printf("%s: check failed\n", _name);
+        std::exit(1);
+    }
+    long long _sum = 0;
+    const double _find_ns = _elapsed_ns([&] {
+        for (int _k : _uniform) {
+            _sum += (_t.find(_k) != _t.end());
+        }
+    }) / _uniform.size();
+    const double _skewed_ns = _elapsed_ns([&] {
+        for (int _r : _skewed) {
+            _sum += (_t.find(_keys[_r]) != _t.end());
+        }
+    }) / _skewed.size();
+    const int _scans = int(_uniform.size() / _S_scan_length);
+    const double _scan_ns = _elapsed_ns([&] {
+        for (int _i = 0; _i < _scans; ++_i) {
+            auto _j = _t.lower_bound(_uniform[_i]);
+            for (int _n = 0; _n < _S_scan_length && _j != _t.end(); ++_n, ++_j) {
+                _sum += *_j;
+            }
+        }
+    }) / (double(_scans) * _S_scan_length);
+    std::printf("  %-10s find %6.1f ns  zipf find %6.1f ns  scan %5.2f ns/elem  (%lld)\n",
+     _name, _find_ns, _skewed_ns, _scan_ns, _sum);
+};
+
+int main(int argc, char** argv) {
+    std::vector<int> _sizes;
+    for (int _i = 1; _i < argc; ++_i) {
+        _sizes.push_back(std::atoi(argv[_i]));
+    }
+    if (_sizes.empty()) {
+        _sizes = {1000, 100000, 1000000};
+    }
+    for (int _size : _sizes) {
+        // even keys are resident, odd ones miss
+        std::vector<int> _keys(_size);
+        for (int _i = 0; _i < _size; ++_i) {
+            _keys[_i] = 2 * _i;
+        }
+        std::shuffle(_keys.begin(), _keys.end(), std::mt19937(7));
+        const int _lookups = std::max(_size, 1 << 20);
+        std::vector<int> _uniform(_lookups);
+        std::mt19937 _rng(11);
+        for (int& _k : _uniform) {
+            _k = int(_rng() % (2 * unsigned(_size)));
+        }
+        const std::vector<int> _skewed = _zipf_trace(_size, 0.99, _lookups, 13);
+        std::printf("size %d, %d lookups\n", _size, _lookups);
+        _bench<asp::rb_tree<int, int, asp::_select_self, true>>("rb_tree", _keys, _uniform, _skewed);
+        _bench<asp::bplus_tree<int, int, asp::_select_self, true>>("bplus_tree", _keys, _uniform, _skewed);
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @brief trace-driven hit ratio of the cache policies over capacities
+ * @details g++ -std=c++17 -O2 -I.. cache_hit_ratio_bench.cpp && ./a.out [trace length] [capacity...]
+ *   the trace is zipf(0.9) over 2^20 keys with a one-off scan of 2^14 keys every 2^19 accesses,
+ *   and a popularity shift halfway (see %_shifted_trace), every policy replays the same trace,
+ *   a miss is followed by a put. it prints the hit ratio and the time per access of each policy.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../lru_table.hpp"
+#include "../lfu_table.hpp"
+#include "../tinylfu_cache.hpp"
+#include "../arc_table.hpp"
+#include "../slru_table.hpp"
+#include "../clock_table.hpp"
+#include "zipf_trace.hpp"
+
+template <typename _Cache> void _replay(const char* _name, unsigned _capacity, const std::vector<int>& _trace) {
+    _Cache _c(_capacity);
+    std::size_t _hits = 0;
+    const double _ns = _elapsed_ns([&] {
+        for (int _k : _trace) {
+            if (_c.get(_k) != _c.cend()) { ++_hits; }
+            else { _c.put(_k); }
+        }
+    });
+    std::printf("  %-8s hit %.3f  %6.0f ns/op\n", _name, double(_hits) / _trace.size(), _ns / _trace.size());
+};
+
+int main(int argc, char** argv) {
+    using namespace asp;
+    const int _length = argc > 1 ? std::atoi(argv[1]) : 1 << 22;
+    std::vector<unsigned> _capacities;
+    for (int _i = 2; _i < argc; ++_i) {
+        _capacities.push_back(std::atoi(argv[_i]));
+    }
+    if (_capacities.empty()) {
+        _capacities = {1000, 10000, 100000};
+    }
+    const std::vector<int> _trace = _shifted_trace(1 << 20, 0.9, _length, 7, 1 << 19, 1 << 14);
+    for (unsigned _capacity : _capacities) {
+        std::printf("capacity %u, %d accesses\n", _capacity, _length);
+        _replay<lru_table<int, int, _select_self, _select_self>>("lru", _capacity, _trace);
+        _replay<clock_table<int, int, _select_self, _select_self>>("clock", _capacity, _trace);
+        _replay<lfu_table<int, int, _select_self, _select_self>>("lfu", _capacity, _trace);
+        _replay<slru_table<int, int, _select_self, _select_self>>("slru", _capacity, _trace);
+        _replay<slru_table<int, int, _select_self, _select_self, std::hash<int>, std::allocator<int>, true>>("2q", _capacity, _trace);
+        _replay<arc_table<int, int, _select_self, _select_self>>("arc", _capacity, _trace);
+        _replay<tinylfu_cache<int, int, _select_self, _select_self>>("tinylfu", _capacity, _trace);
+    }
+    return 0;
+}
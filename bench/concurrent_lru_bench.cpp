@@ -0,0 +1,61 @@
+/**
+ * @brief throughput of @concurrent_lru_map over thread counts under a zipf workload
+ * @details g++ -std=c++17 -O2 -pthread -I.. concurrent_lru_bench.cpp && ./a.out [capacity] [ops per thread] [max threads]
+ *   each thread replays its own zipf(0.99) trace over 8 * capacity keys, a miss is followed by a put.
+ *   the exclusive-lock and the buffered-read variants run with 1, 2, 4, ... up to [max threads] threads,
+ *   it prints the total throughput and the hit ratio of each run.
+ *   threads beyond the hardware threads only measure contention on time slices.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_lru.hpp"
+#include "zipf_trace.hpp"
+
+template <bool _BufferedReads> void _bench(unsigned _capacity, int _ops, unsigned _max_threads) {
+    const int _keys = int(8 * _capacity);
+    for (unsigned _n = 1; _n <= _max_threads; _n *= 2) {
+        std::vector<std::vector<int>> _traces;
+        for (unsigned _i = 0; _i < _n; ++_i) {
+            _traces.push_back(_zipf_trace(_keys, 0.99, _ops, 7 + _i));
+        }
+        asp::concurrent_lru_map<int, int, std::hash<int>, std::allocator<std::pair<const int, int>>, _BufferedReads> _c(_capacity);
+        // warm up, so the hit ratio isn't dominated by cold misses
+        for (int _k : _traces[0]) {
+            int _m;
+            if (!_c.get(_k, _m)) { _c.put({_k, _k}); }
+        }
+        const asp::size_type _hit0 = _c.hits(), _miss0 = _c.misses();
+        const double _ns = _elapsed_ns([&] {
+            std::vector<std::thread> _threads;
+            for (unsigned _i = 0; _i < _n; ++_i) {
+                _threads.emplace_back([&_c, &_trace = _traces[_i]] {
+                    for (int _k : _trace) {
+                        int _m;
+                        if (!_c.get(_k, _m)) { _c.put({_k, _k}); }
+                    }
+                });
+            }
+            for (auto& _t : _threads) { _t.join(); }
+        });
+        const double _hit = _c.hits() - _hit0, _miss = _c.misses() - _miss0;
+        std::printf("%-9s threads %2u shards %3u : %7.2f Mops/s, hit %.3f\n", _BufferedReads ? "buffered" : "exclusive",
+         _n, _c.shard_count(), 1e3 * double(_ops) * _n / _ns, _hit / (_hit + _miss));
+        if (_c.check() != 0) {
+            std::printf("check failed\n");
+            std::exit(1);
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    const unsigned _capacity = argc > 1 ? std::atoi(argv[1]) : 1 << 14;
+    const int _ops = argc > 2 ? std::atoi(argv[2]) : 1 << 20;
+    const unsigned _max_threads = argc > 3 ? std::atoi(argv[3]) : 8;
+    std::printf("capacity %u, %d ops per thread, %u hardware threads\n", _capacity, _ops, std::thread::hardware_concurrency());
+    _bench<false>(_capacity, _ops, _max_threads);
+    _bench<true>(_capacity, _ops, _max_threads);
+    return 0;
+}
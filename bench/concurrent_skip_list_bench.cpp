@@ -0,0 +1,139 @@
+/**
+ * @brief throughput of @concurrent_skip_list against a mutex-wrapped @skip_list and @ordered_set over thread counts
+ * @details g++ -std=c++17 -O2 -pthread -I.. concurrent_skip_list_bench.cpp && ./a.out [size] [ops per thread] [max threads]
+ *   the set is filled with %size keys out of [0, 2 * size), then each thread replays its own random operations
+ *   on uniform keys for each mix (find % / insert % / erase % / scan %, a scan reads 16 elements from %lower_bound),
+ *   the inserts and erases balance, so the size stays around %size.
+ *   it prints the total throughput of 1, 2, 4, ... up to [max threads] threads.
+ *   threads beyond the hardware threads only measure contention on time slices.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../concurrent_skip_list.hpp"
+#include "../skip_list.hpp"
+#include "../ordered_set.hpp"
+#include "zipf_trace.hpp"
+
+enum op_type : unsigned { __FIND__, __INSERT__, __ERASE__, __SCAN__ };
+static constexpr const int _S_scan_length = 16;
+
+struct lock_free_set {
+    asp::concurrent_skip_list<int, int, asp::_select_self, true> _s;
+
+    bool find(int _k) const { return _s.find(_k) != _s.cend(); }
+    void insert(int _k) { _s.insert(_k); }
+    void erase(int _k) { _s.erase(_k); }
+    long long scan(int _k) const {
+        auto _g = _s.guard();
+        long long _sum = 0;
+        auto _i = _s.lower_bound(_k);
+        for (int _n = 0; _n < _S_scan_length && _i != _s.cend(); ++_n, ++_i) {
+            _sum += *_i;
+        }
+        return _sum;
+    }
+    int check() const { return _s.check(); }
+};
+
+// every operation takes the lock
+template <typename _Set> struct mutex_set {
+    _Set _s;
+    mutable std::mutex _m;
+
+    bool find(int _k) const {
+        std::lock_guard<std::mutex> _g(_m);
+        return _s.find(_k) != _s.cend();
+    }
+    void insert(int _k) { std::lock_guard<std::mutex> _g(_m); _s.insert(_k); }
+    void erase(int _k) { std::lock_guard<std::mutex> _g(_m); _s.erase(_k); }
+    long long scan(int _k) const {
+        std::lock_guard<std::mutex> _g(_m);
+        long long _sum = 0;
+        auto _i = _s.lower_bound(_k);
+        for (int _n = 0; _n < _S_scan_length && _i != _s.cend(); ++_n, ++_i) {
+            _sum += *_i;
+        }
+        return _sum;
+    }
+    int check() const { return _s.check(); }
+};
+
+struct op_mix {
+    const char* _name;
+    unsigned _find, _insert, _erase, _scan; // percents
+};
+
+template <typename _Set> void _bench(const char* _name, const op_mix& _mix, int _size, int _ops, unsigned _max_threads) {
+    std::printf("  %-22s", _name);
+    for (unsigned _n = 1; _n <= _max_threads; _n *= 2) {
+        _Set _s;
+        std::mt19937 _rng(7);
+        for (int _i = 0; _i < _size; ++_i) {
+            _s.insert(int(_rng() % (2 * unsigned(_size))));
+        }
+        // (key << 2 | op) per operation, generated before timing
+        std::vector<std::vector<unsigned>> _traces(_n);
+        for (unsigned _t = 0; _t < _n; ++_t) {
+            std::mt19937 _r(11 + _t);
+            for (int _i = 0; _i < _ops; ++_i) {
+                const unsigned _p = _r() % 100;
+                const unsigned _op = _p < _mix._find ? __FIND__ :
+                 _p < _mix._find + _mix._insert ? __INSERT__ :
+                 _p < _mix._find + _mix._insert + _mix._erase ? __ERASE__ : __SCAN__;
+                _traces[_t].push_back((_r() % (2 * unsigned(_size))) << 2 | _op);
+            }
+        }
+        std::vector<long long> _sums(_n);
+        const double _ns = _elapsed_ns([&] {
+            std::vector<std::thread> _threads;
+            for (unsigned _t = 0; _t < _n; ++_t) {
+                _threads.emplace_back([&_s, &_trace = _traces[_t], &_sum = _sums[_t]] {
+                    for (unsigned _x : _trace) {
+                        const int _k = int(_x >> 2);
+                        switch (_x & 3) {
+                        case __FIND__: _sum += _s.find(_k); break;
+                        case __INSERT__: _s.insert(_k); break;
+                        case __ERASE__: _s.erase(_k); break;
+                        default: _sum += _s.scan(_k); break;
+                        }
+                    }
+                });
+            }
+            for (auto& _t : _threads) { _t.join(); }
+        });
+        if (_s.check() != 0) {
+            std::printf("\n%s: check failed\n", _name);
+            std::exit(1);
+        }
+        std::printf(" %8.2f", 1e3 * double(_ops) * _n / _ns);
+    }
+    std::printf("  Mops/s\n");
+};
+
+int main(int argc, char** argv) {
+    const int _size = argc > 1 ? std::atoi(argv[1]) : 1 << 16;
+    const int _ops = argc > 2 ? std::atoi(argv[2]) : 1 << 19;
+    const unsigned _max_threads = argc > 3 ? std::atoi(argv[3]) : 8;
+    const op_mix _mixes[] = {
+        {"read-mostly 90/5/5/0", 90, 5, 5, 0},
+        {"balanced 50/25/25/0", 50, 25, 25, 0},
+        {"scans 70/10/10/10", 70, 10, 10, 10},
+    };
+    std::printf("size %d, %d ops per thread, %u hardware threads, threads:", _size, _ops, std::thread::hardware_concurrency());
+    for (unsigned _n = 1; _n <= _max_threads; _n *= 2) {
+        std::printf(" %u", _n);
+    }
+    std::printf("\n");
+    for (const op_mix& _mix : _mixes) {
+        std::printf("%s\n", _mix._name);
+        _bench<lock_free_set>("concurrent_skip_list", _mix, _size, _ops, _max_threads);
+        _bench<mutex_set<asp::skip_list<int, int, asp::_select_self, true>>>("mutex + skip_list", _mix, _size, _ops, _max_threads);
+        _bench<mutex_set<asp::ordered_set<int>>>("mutex + ordered_set", _mix, _size, _ops, _max_threads);
+    }
+    return 0;
+}
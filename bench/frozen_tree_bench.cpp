@@ -0,0 +1,82 @@
+/**
+ * @brief %lower_bound of @frozen_tree (eytzinger / vEB layouts) against @rb_tree and std::lower_bound
+ * @details g++ -std=c++17 -O2 -I.. frozen_tree_bench.cpp && ./a.out [size...]
+ *   sizes are read as floating point, e.g. ./a.out 1e3 1e6 1e9, 1K to 1M by default.
+ *   the keys are the even numbers below 2 * size, the queries are uniform over [0, 2 * size),
+ *   so half of them fall between two keys. it prints ns per %lower_bound and a checksum.
+ *   the frozen trees are built from a sorted array (4 + ~8 bytes per element),
+ *   @rb_tree (~40 bytes per element) is skipped above %_S_rb_tree_limit elements.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../rb_tree.hpp"
+#include "../frozen_tree.hpp"
+#include "zipf_trace.hpp"
+
+static constexpr const std::size_t _S_rb_tree_limit = std::size_t(1) << 27;
+
+template <typename _Tree> void _time(const char* _name, const _Tree& _t, const std::vector<unsigned>& _queries) {
+    unsigned long long _sum = 0;
+    const double _ns = _elapsed_ns([&] {
+        for (unsigned _k : _queries) {
+            auto _i = _t.lower_bound(_k);
+            _sum += (_i != _t.cend()) ? *_i : 0;
+        }
+    }) / _queries.size();
+    std::printf("  %-16s %7.1f ns  (%llu)\n", _name, _ns, _sum);
+};
+
+template <typename _Layout> using frozen_t = asp::frozen_tree<unsigned, unsigned, asp::_select_self, true, std::less<unsigned>, std::allocator<unsigned>, _Layout>;
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> _sizes;
+    for (int _i = 1; _i < argc; ++_i) {
+        _sizes.push_back(std::size_t(std::strtod(argv[_i], nullptr)));
+    }
+    if (_sizes.empty()) {
+        _sizes = {1000, 10000, 100000, 1000000};
+    }
+    for (std::size_t _size : _sizes) {
+        std::vector<unsigned> _keys(_size);
+        for (std::size_t _i = 0; _i < _size; ++_i) {
+            _keys[_i] = unsigned(2 * _i);
+        }
+        std::vector<unsigned> _queries(1 << 22);
+        std::mt19937_64 _rng(11);
+        for (unsigned& _k : _queries) {
+            _k = unsigned(_rng() % (2 * _size));
+        }
+        std::printf("size %zu, %zu queries\n", _size, _queries.size());
+        {
+            // a thin wrapper, so the sorted array is timed by the same loop
+            struct sorted_array {
+                const std::vector<unsigned>& _v;
+                std::vector<unsigned>::const_iterator cend() const { return _v.cend(); }
+                std::vector<unsigned>::const_iterator lower_bound(unsigned _k) const { return std::lower_bound(_v.cbegin(), _v.cend(), _k); }
+            } _a{_keys};
+            _time("std::lower_bound", _a, _queries);
+        }
+        {
+            const frozen_t<asp::eytzinger_layout> _f(_keys.cbegin(), _keys.cend(), asp::size_type(_size));
+            _time("eytzinger", _f, _queries);
+        }
+        {
+            const frozen_t<asp::veb_layout> _f(_keys.cbegin(), _keys.cend(), asp::size_type(_size));
+            _time("veb", _f, _queries);
+        }
+        if (_size <= _S_rb_tree_limit) {
+            asp::rb_tree<unsigned, unsigned, asp::_select_self, true> _t;
+            for (unsigned _k : _keys) {
+                _t.insert(_k);
+            }
+            _time("rb_tree", static_cast<const decltype(_t)&>(_t), _queries);
+        }
+        else {
+            std::printf("  %-16s skipped\n", "rb_tree");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @brief cost and hit ratio of @lfu_table over capacities and aging factors, against the former table
+ * @details g++ -std=c++17 -O2 -I.. lfu_bench.cpp && ./a.out [trace length] [capacity...]
+ *   - replay : the trace of cache_hit_ratio_bench.cpp (zipf(0.9), one-off scans, popularity shift),
+ *     a miss is followed by a put, for @lfu_table_v0 (the table before the frequency buckets, no aging),
+ *     aging off (which evicts exactly as v0), aging factors 10 and 2, and @lru_table as the reference.
+ *   - hits : every key of a zipf trace over the capacity is resident, so each access only bumps a frequency,
+ *     an O(1) access keeps its ns/op flat as the capacity grows (apart from cache misses).
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../lru_table.hpp"
+#include "../lfu_table.hpp"
+#include "lfu_table_v0.hpp"
+#include "zipf_trace.hpp"
+
+template <typename _Cache> void _replay(const char* _name, _Cache& _c, const std::vector<int>& _trace) {
+    std::size_t _hits = 0;
+    const double _ns = _elapsed_ns([&] {
+        for (int _k : _trace) {
+            if (_c.get(_k) != _c.cend()) { ++_hits; }
+            else { _c.put(_k); }
+        }
+    });
+    std::printf("  %-12s hit %.3f  %6.0f ns/op\n", _name, double(_hits) / _trace.size(), _ns / _trace.size());
+};
+
+template <typename _Cache> void _resident(const char* _name, _Cache& _c, unsigned _capacity, const std::vector<int>& _trace) {
+    for (unsigned _k = 0; _k < _capacity; ++_k) {
+        _c.put(int(_k));
+    }
+    _replay(_name, _c, _trace);
+    if (_c.check() != 0) {
+        std::printf("%s: check failed\n", _name);
+        std::exit(1);
+    }
+};
+
+int main(int argc, char** argv) {
+    using namespace asp;
+    typedef lfu_table<int, int, _select_self, _select_self> lfu_t;
+    typedef lru_table<int, int, _select_self, _select_self> lru_t;
+    typedef lfu_table_v0<int, int, _select_self, _select_self> lfu_v0_t;
+    const int _length = argc > 1 ? std::atoi(argv[1]) : 1 << 21;
+    std::vector<unsigned> _capacities;
+    for (int _i = 2; _i < argc; ++_i) {
+        _capacities.push_back(std::atoi(argv[_i]));
+    }
+    if (_capacities.empty()) {
+        _capacities = {1000, 10000, 100000};
+    }
+    const std::vector<int> _trace = _shifted_trace(1 << 20, 0.9, _length, 7, 1 << 19, 1 << 14);
+    for (unsigned _capacity : _capacities) {
+        std::printf("capacity %u, %d accesses\n", _capacity, _length);
+        { lfu_v0_t _c(_capacity); _replay("lfu v0", _c, _trace); }
+        { lfu_t _c(_capacity, 0); _replay("lfu/no aging", _c, _trace); }
+        { lfu_t _c(_capacity, 10); _replay("lfu/aging 10", _c, _trace); }
+        { lfu_t _c(_capacity, 2); _replay("lfu/aging 2", _c, _trace); }
+        { lru_t _c(_capacity); _replay("lru", _c, _trace); }
+        const std::vector<int> _hits = _zipf_trace(int(_capacity), 0.9, _length, 11);
+        { lfu_v0_t _c(_capacity); _resident("lfu v0/hits", _c, _capacity, _hits); }
+        { lfu_t _c(_capacity, 0); _resident("lfu/hits", _c, _capacity, _hits); }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @brief memory per element and lookup cost of @skip_list (inline towers from per-height pools)
+ * @details g++ -std=c++17 -O2 -I.. skip_list_memory_bench.cpp && ./a.out [size...]
+ *   the heap is measured by replacing the global operator new / delete, with the usable size of each block
+ *   (glibc malloc_usable_size), so the malloc overhead of per-node allocations is counted as well.
+ *   @rb_tree and std::set are the per-node allocation references.
+ *   for each container it prints heap bytes and allocations per element, after filling with random ints,
+ *   and after a churn (erase half of the keys, insert as many new ones), then ns per %find of resident keys.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+#include "../rb_tree.hpp"
+#include "../skip_list.hpp"
+#include "zipf_trace.hpp"
+
+static std::size_t _s_heap_bytes = 0;
+static std::size_t _s_heap_blocks = 0;
+
+void* operator new(std::size_t _n) {
+    void* _p = std::malloc(_n == 0 ? 1 : _n);
+    if (_p == nullptr) { throw std::bad_alloc(); }
+    _s_heap_bytes += malloc_usable_size(_p);
+    ++_s_heap_blocks;
+    return _p;
+}
+// not inlined, or gcc pairs the free with the new-expression of the caller (-Wmismatched-new-delete)
+__attribute__((noinline)) static void _heap_free(void* _p) {
+    if (_p == nullptr) { return; }
+    _s_heap_bytes -= malloc_usable_size(_p);
+    --_s_heap_blocks;
+    std::free(_p);
+}
+void operator delete(void* _p) noexcept { _heap_free(_p); }
+void operator delete(void* _p, std::size_t) noexcept { _heap_free(_p); }
+
+template <typename _Tree> void _bench(const char* _name, const std::vector<int>& _keys, const std::vector<int>& _extra,
+ const std::vector<int>& _queries) {
+    const std::size_t _bytes0 = _s_heap_bytes, _blocks0 = _s_heap_blocks;
+    _Tree* _t = new _Tree;
+    for (int _k : _keys) {
+        _t->insert(_k);
+    }
+    const double _fill_bytes = double(_s_heap_bytes - _bytes0) / _keys.size();
+    const double _fill_blocks = double(_s_heap_blocks - _blocks0) / _keys.size();
+    const _Tree& _ct = *_t;
+    long long _found = 0;
+    const double _find_ns = _elapsed_ns([&] {
+        for (int _k : _queries) {
+            _found += (_ct.find(_k) != _ct.cend());
+        }
+    }) / _queries.size();
+    for (std::size_t _i = 0; _i < _keys.size(); _i += 2) {
+        _t->erase(_keys[_i]);
+    }
+    for (int _k : _extra) {
+        _t->insert(_k);
+    }
+    const double _churn_bytes = double(_s_heap_bytes - _bytes0) / _t->size();
+    std::printf("  %-10s %6.1f bytes %5.2f allocs per element, after churn %6.1f bytes  find %7.1f ns  (%lld)\n",
+     _name, _fill_bytes, _fill_blocks, _churn_bytes, _find_ns, _found);
+    delete _t;
+};
+
+// std::set with the interface used above
+struct std_set : std::set<int> {
+    void insert(int _k) { std::set<int>::insert(_k); }
+};
+
+int main(int argc, char** argv) {
+    std::vector<int> _sizes;
+    for (int _i = 1; _i < argc; ++_i) {
+        _sizes.push_back(std::atoi(argv[_i]));
+    }
+    if (_sizes.empty()) {
+        _sizes = {1 << 12, 1 << 16, 1 << 20};
+    }
+    for (int _size : _sizes) {
+        std::mt19937 _rng(7);
+        std::vector<int> _keys, _extra;
+        {
+            std::unordered_set<int> _seen;
+            while (int(_keys.size() + _extra.size()) < _size + (_size + 1) / 2) {
+                const int _k = int(_rng() >> 1);
+                if (_seen.insert(_k).second) {
+                    (int(_keys.size()) < _size ? _keys : _extra).push_back(_k);
+                }
+            }
+        }
+        std::vector<int> _queries(1 << 20);
+        for (int& _q : _queries) {
+            _q = _keys[_rng() % _keys.size()];
+        }
+        std::printf("size %d, %zu lookups\n", _size, _queries.size());
+        _bench<asp::skip_list<int, int, asp::_select_self, true>>("skip_list", _keys, _extra, _queries);
+        _bench<asp::rb_tree<int, int, asp::_select_self, true>>("rb_tree", _keys, _extra, _queries);
+        _bench<std_set>("std::set", _keys, _extra, _queries);
+    }
+    return 0;
+}
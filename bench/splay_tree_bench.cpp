@@ -0,0 +1,62 @@
+/**
+ * @brief lookups of @splay_tree against @rb_tree under zipf skews
+ * @details g++ -std=c++17 -O2 -I.. splay_tree_bench.cpp && ./a.out [size] [lookups]
+ *   every tree holds the same keys, the hot ranks of zipf(s) are spread over random keys.
+ *   the non-const %find is timed, so the splay trees restructure on every lookup,
+ *   except within the depth threshold of splay_balance_policy<_Semi, _Depth>.
+ *   s = 0 is the uniform reference, it prints ns per find for each skew.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../splay_tree.hpp"
+#include "zipf_trace.hpp"
+
+template <typename _Tree> void _bench(const char* _name, const std::vector<int>& _keys, const std::vector<std::vector<int>>& _traces) {
+    std::printf("  %-18s", _name);
+    for (const auto& _trace : _traces) {
+        _Tree _t;
+        for (int _k : _keys) {
+            _t.insert(_k);
+        }
+        long long _found = 0;
+        const double _ns = _elapsed_ns([&] {
+            for (int _r : _trace) {
+                _found += (_t.find(_keys[_r]) != _t.end());
+            }
+        }) / _trace.size();
+        if (_found != (long long)_trace.size() || _t.check() != 0) {
+            std::printf("\n%s: lookup or check failed\n", _name);
+            std::exit(1);
+        }
+        std::printf(" %8.1f", _ns);
+    }
+    std::printf("\n");
+};
+
+int main(int argc, char** argv) {
+    using namespace asp;
+    const int _size = argc > 1 ? std::atoi(argv[1]) : 1 << 18;
+    const int _lookups = argc > 2 ? std::atoi(argv[2]) : 1 << 21;
+    std::vector<int> _keys(_size);
+    for (int _i = 0; _i < _size; ++_i) {
+        _keys[_i] = _i;
+    }
+    std::shuffle(_keys.begin(), _keys.end(), std::mt19937(7));
+    const double _skews[] = {0, 0.8, 0.99, 1.2};
+    std::vector<std::vector<int>> _traces;
+    std::printf("size %d, %d lookups, ns per find\n  %-18s", _size, _lookups, "zipf s");
+    for (double _s : _skews) {
+        _traces.push_back(_zipf_trace(_size, _s, _lookups, 11));
+        std::printf(" %8.2f", _s);
+    }
+    std::printf("\n");
+    _bench<rb_tree<int, int, _select_self, true>>("rb_tree", _keys, _traces);
+    _bench<splay_tree<int, int, _select_self, true>>("splay_tree", _keys, _traces);
+    _bench<semi_splay_tree<int, int, _select_self, true>>("semi_splay_tree", _keys, _traces);
+    _bench<splay_tree<int, int, _select_self, true, std::less<int>, std::allocator<int>, splay_balance_policy<false, 8>>>("splay, depth > 8", _keys, _traces);
+    _bench<splay_tree<int, int, _select_self, true, std::less<int>, std::allocator<int>, splay_balance_policy<true, 8>>>("semi, depth > 8", _keys, _traces);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @brief average depth and lookup throughput of the balancing policies of @rb_tree
+ * @details g++ -std=c++17 -O2 -I.. tree_policy_bench.cpp && ./a.out [size...]
+ *   each of rb_tree, compact_rb_tree, avl_tree and wavl_tree is built from the same keys,
+ *   once inserted in random order and once in ascending order (the worst case of red-black).
+ *   it prints the average / maximum depth of the nodes (the root at 0), ns per insert,
+ *   and ns per %find of uniform random resident keys, which is read-only with every policy.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../rb_tree.hpp"
+#include "zipf_trace.hpp"
+
+template <typename _Tree> void _bench(const char* _name, const std::vector<int>& _keys, const std::vector<int>& _lookups) {
+    _Tree _t;
+    const double _insert_ns = _elapsed_ns([&] {
+        for (int _k : _keys) {
+            _t.insert(_k);
+        }
+    }) / _keys.size();
+    if (_t.check() != 0) {
+        std::printf("%s: check failed\n", _name);
+        std::exit(1);
+    }
+    // a node is the root iff its grandparent (through the header) is itself
+    double _depth_sum = 0;
+    unsigned _depth_max = 0;
+    for (auto _i = _t.cbegin(); _i != _t.cend(); ++_i) {
+        unsigned _d = 0;
+        for (auto _x = _i._ptr; _x->_M_parent()->_M_parent() != _x; _x = _x->_M_parent()) {
+            ++_d;
+        }
+        _depth_sum += _d;
+        _depth_max = std::max(_depth_max, _d);
+    }
+    long long _found = 0;
+    const double _find_ns = _elapsed_ns([&] {
+        for (int _k : _lookups) {
+            _found += (_t.find(_k) != _t.end());
+        }
+    }) / _lookups.size();
+    std::printf("  %-16s depth avg %5.2f max %2u  insert %6.1f ns  find %6.1f ns  (%lld)\n",
+     _name, _depth_sum / _t.size(), _depth_max, _insert_ns, _find_ns, _found);
+};
+
+template <typename _Key> void _bench_all(const std::vector<_Key>& _keys, const std::vector<_Key>& _lookups) {
+    using namespace asp;
+    _bench<rb_tree<int, int, _select_self, true>>("rb_tree", _keys, _lookups);
+    _bench<compact_rb_tree<int, int, _select_self, true>>("compact_rb_tree", _keys, _lookups);
+    _bench<avl_tree<int, int, _select_self, true>>("avl_tree", _keys, _lookups);
+    _bench<wavl_tree<int, int, _select_self, true>>("wavl_tree", _keys, _lookups);
+};
+
+int main(int argc, char** argv) {
+    std::vector<int> _sizes;
+    for (int _i = 1; _i < argc; ++_i) {
+        _sizes.push_back(std::atoi(argv[_i]));
+    }
+    if (_sizes.empty()) {
+        _sizes = {1000, 100000, 1000000};
+    }
+    for (int _size : _sizes) {
+        std::vector<int> _keys(_size);
+        for (int _i = 0; _i < _size; ++_i) {
+            _keys[_i] = _i;
+        }
+        std::vector<int> _lookups(std::max(_size, 1 << 20));
+        std::mt19937 _rng(11);
+        for (int& _k : _lookups) {
+            _k = int(_rng() % unsigned(_size));
+        }
+        std::printf("size %d, ascending inserts\n", _size);
+        _bench_all(_keys, _lookups);
+        std::shuffle(_keys.begin(), _keys.end(), std::mt19937(7));
+        std::printf("size %d, random inserts\n", _size);
+        _bench_all(_keys, _lookups);
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef _ASP_BENCH_ZIPF_TRACE_HPP_
+#define _ASP_BENCH_ZIPF_TRACE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief key traces shared by the benchmarks, generated up front so only the cache is timed
+ * @details
+ *   %_zipf_trace draws %_length keys from zipf(%_s) over [0, %_keys), rank 0 is the hottest.
+ *   %_shifted_trace adds what a plain zipf misses :
+ *     - every %_scan_period accesses, a one-off scan of %_scan_length keys never seen again;
+ *     - halfway, the popularity is shifted : rank r maps to another key, so the old hot set goes cold.
+*/
+inline std::vector<int> _zipf_trace(int _keys, double _s, int _length, std::uint64_t _seed) {
+    std::vector<double> _cdf(_keys);
+    double _sum = 0;
+    for (int _i = 0; _i < _keys; ++_i) {
+        _sum += 1.0 / std::pow(_i + 1, _s);
+        _cdf[_i] = _sum;
+    }
+    std::mt19937_64 _rng(_seed);
+    std::uniform_real_distribution<double> _u(0, _sum);
+    std::vector<int> _trace(_length);
+    for (int& _k : _trace) {
+        _k = int(std::lower_bound(_cdf.begin(), _cdf.end(), _u(_rng)) - _cdf.begin());
+        if (_k == _keys) { _k = _keys - 1; }
+    }
+    return _trace;
+};
+
+inline std::vector<int> _shifted_trace(int _keys, double _s, int _length, std::uint64_t _seed,
+ int _scan_period, int _scan_length) {
+    std::vector<int> _trace = _zipf_trace(_keys, _s, _length, _seed);
+    int _one_off = _keys;
+    for (int _t = 0; _t < _length; ++_t) {
+        if (_t % _scan_period >= _scan_period / 2 && _t % _scan_period < _scan_period / 2 + _scan_length) {
+            _trace[_t] = _one_off++;
+        }
+        else if (_t >= _length / 2) {
+            _trace[_t] = int((std::uint64_t(_trace[_t]) * 2654435761u) % std::uint64_t(_keys));
+        }
+    }
+    return _trace;
+};
+
+template <typename _Func> double _elapsed_ns(_Func&& _f) {
+    const auto _t0 = std::chrono::steady_clock::now();
+    _f();
+    const auto _t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(_t1 - _t0).count();
+};
+
+#endif // _ASP_BENCH_ZIPF_TRACE_HPP_
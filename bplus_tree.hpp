@@ -0,0 +1,981 @@
+#ifndef _ASP_BPLUS_TREE_HPP_
+#define _ASP_BPLUS_TREE_HPP_
+
+#include "basic_param.hpp"
+#include "iterator.hpp"
+#include "type_traits.hpp"
+#include "associative_container_aux.hpp"
+#include "basic_io.hpp"
+
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace asp {
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey,
+ typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>> class bplus_tree;
+template <typename _Key, typename _Value, typename _Alloc> struct bplus_tree_alloc;
+
+struct bplus_tree_node_base;
+struct bplus_tree_leaf_base;
+template <typename _Value> struct bplus_tree_leaf;
+template <typename _Key> struct bplus_tree_inner;
+
+template <typename _Tp> struct bplus_tree_iterator;
+template <typename _Tp> struct bplus_tree_const_iterator;
+
+/**
+ * @brief B+ tree, a cache-friendly alternative of @rb_tree
+ * @details
+ *   every node is sized to fill about %_S_node_bytes bytes, so that a level of lookup
+ *   costs a few cache lines instead of a cache miss per element.
+ *
+ *                       [ s0 | s1 ]                     (inner nodes, separators only)
+ *               ↙            ↓            ↘
+ *     [ v v v v ] ⇄ [ v v v v ] ⇄ [ v v v v ]           (leaves, all values, linked)
+ *          ↑                             ↑
+ *      _header._next                 _header._prev
+ *
+ *   - the leaves make up a circular doubly linked list with %_header, which is the end of traversation.
+ *   - for separator s[i], all keys in child[i] \le s[i] \le all keys in child[i+1].
+ *     in unique tree, keys in child[i] are strictly less than s[i].
+ *   - separators are not required to exist in leaves (erasing a leaf key keeps the stale separator).
+ *   - each non-root node is at least half full.
+ *   - iterators are invalidated by insertion and erasure.
+*/
+namespace __bplus_tree__ {
+static constexpr const size_type _S_node_bytes = 512;
+static constexpr const size_type _S_min_capacity = 4;
+
+constexpr size_type _S_capacity(size_type _header_bytes, size_type _slot_bytes) {
+    return (_S_node_bytes - _header_bytes) / _slot_bytes < _S_min_capacity ?
+        _S_min_capacity : (_S_node_bytes - _header_bytes) / _slot_bytes;
+};
+
+/**
+ * @brief branchless lower bound in a sorted array %_a[0, _n)
+ * @return the number of elements (_e) in %_a that %_comp(_e, _k)
+*/
+template <typename _Tp, typename _Key, typename _ExtKey, typename _Comp>
+size_type _S_branchless_lower_bound(const _Tp* _a, size_type _n, const _Key& _k, const _ExtKey& _ext, const _Comp& _comp);
+/**
+ * @brief branchless upper bound in a sorted array %_a[0, _n)
+ * @return the number of elements (_e) in %_a that !%_comp(_k, _e)
+*/
+template <typename _Tp, typename _Key, typename _ExtKey, typename _Comp>
+size_type _S_branchless_upper_bound(const _Tp* _a, size_type _n, const _Key& _k, const _ExtKey& _ext, const _Comp& _comp);
+};
+
+struct bplus_tree_node_base {
+    typedef bplus_tree_node_base self;
+    bplus_tree_node_base* _parent = nullptr;
+    size_type _count = 0; // elements in leaf, children in inner node
+    bool _leaf = true;
+
+    bplus_tree_node_base(bool _is_leaf) : _leaf(_is_leaf) {}
+};
+
+struct bplus_tree_leaf_base : public bplus_tree_node_base {
+    typedef bplus_tree_leaf_base self;
+    self* _prev = nullptr;
+    self* _next = nullptr;
+
+    bplus_tree_leaf_base() : bplus_tree_node_base(true) {}
+
+    // hook @this before @_p
+    void hook(self* const _p) {
+        _prev = _p->_prev;
+        _next = _p;
+        _p->_prev->_next = this;
+        _p->_prev = this;
+    }
+    void unhook() {
+        _prev->_next = _next;
+        _next->_prev = _prev;
+        _prev = nullptr;
+        _next = nullptr;
+    }
+};
+
+template <typename _Value> struct bplus_tree_leaf : public bplus_tree_leaf_base {
+    typedef bplus_tree_leaf<_Value> self;
+    typedef _Value value_type;
+    static constexpr const size_type _S_capacity =
+     __bplus_tree__::_S_capacity(sizeof(bplus_tree_leaf_base), sizeof(_Value));
+
+    alignas(_Value) unsigned char _storage[sizeof(_Value) * _S_capacity];
+
+    value_type* _M_values() { return reinterpret_cast<value_type*>(_storage); }
+    const value_type* _M_values() const { return reinterpret_cast<const value_type*>(_storage); }
+    value_type& val(size_type _i) { return _M_values()[_i]; }
+    const value_type& val(size_type _i) const { return _M_values()[_i]; }
+    value_type* valptr(size_type _i) { return _M_values() + _i; }
+    const value_type* valptr(size_type _i) const { return _M_values() + _i; }
+};
+
+template <typename _Key> struct bplus_tree_inner : public bplus_tree_node_base {
+    typedef bplus_tree_inner<_Key> self;
+    typedef _Key key_type;
+    // maximum number of children
+    static constexpr const size_type _S_capacity =
+     __bplus_tree__::_S_capacity(sizeof(bplus_tree_node_base), sizeof(_Key) + sizeof(void*));
+
+    alignas(_Key) unsigned char _storage[sizeof(_Key) * (_S_capacity - 1)];
+    bplus_tree_node_base* _child[_S_capacity];
+
+    bplus_tree_inner() : bplus_tree_node_base(false) {}
+
+    key_type* _M_keys() { return reinterpret_cast<key_type*>(_storage); }
+    const key_type* _M_keys() const { return reinterpret_cast<const key_type*>(_storage); }
+    key_type& key(size_type _i) { return _M_keys()[_i]; }
+    const key_type& key(size_type _i) const { return _M_keys()[_i]; }
+    // index of %_c in %_child
+    size_type _M_index(const bplus_tree_node_base* _c) const {
+        size_type _i = 0;
+        while (_child[_i] != _c) ++_i;
+        return _i;
+    }
+};
+
+template <typename _Tp> struct bplus_tree_iterator {
+    typedef asp::bidirectional_iterator_tag iterator_category;
+    typedef bplus_tree_leaf<_Tp> leaf_type;
+    typedef bplus_tree_leaf_base link_type;
+    typedef _Tp value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef asp::difference_type difference_type;
+    typedef bplus_tree_iterator<_Tp> self;
+
+    link_type* _node = nullptr;
+    size_type _pos = 0;
+
+    bplus_tree_iterator() = default;
+    bplus_tree_iterator(link_type* _n, size_type _p) : _node(_n), _pos(_p) {}
+    value_type& operator*() const { return static_cast<leaf_type*>(_node)->val(_pos); }
+    value_type* operator->() const { return static_cast<leaf_type*>(_node)->valptr(_pos); }
+    self& operator++() { _M_inc(); return *this; }
+    self operator++(int) { self _ret = *this; _M_inc(); return _ret; }
+    self& operator--() { _M_dec(); return *this; }
+    self operator--(int) { self _ret = *this; _M_dec(); return _ret; }
+    operator bool() const { return _node != nullptr && _pos < _node->_count; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._node == _y._node && _x._pos == _y._pos; }
+    friend bool operator!=(const self& _x, const self& _y) { return !(_x == _y); }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const bplus_tree_iterator<_T>& _r);
+
+    void _M_inc() { if (++_pos >= _node->_count) { _node = _node->_next; _pos = 0; } }
+    void _M_dec() {
+        if (_pos == 0) { _node = _node->_prev; _pos = _node->_count; }
+        --_pos;
+    }
+};
+template <typename _Tp> struct bplus_tree_const_iterator {
+    typedef asp::bidirectional_iterator_tag iterator_category;
+    typedef bplus_tree_leaf<_Tp> leaf_type;
+    typedef bplus_tree_leaf_base link_type;
+    typedef _Tp value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef asp::difference_type difference_type;
+    typedef bplus_tree_const_iterator<_Tp> self;
+    typedef bplus_tree_iterator<_Tp> iterator;
+
+    const link_type* _node = nullptr;
+    size_type _pos = 0;
+
+    bplus_tree_const_iterator() = default;
+    bplus_tree_const_iterator(const link_type* _n, size_type _p) : _node(_n), _pos(_p) {}
+    bplus_tree_const_iterator(const iterator& _i) : _node(_i._node), _pos(_i._pos) {}
+    const value_type& operator*() const { return static_cast<const leaf_type*>(_node)->val(_pos); }
+    const value_type* operator->() const { return static_cast<const leaf_type*>(_node)->valptr(_pos); }
+    iterator _const_cast() const { return iterator(const_cast<link_type*>(_node), _pos); }
+    self& operator++() { _M_inc(); return *this; }
+    self operator++(int) { self _ret = *this; _M_inc(); return _ret; }
+    self& operator--() { _M_dec(); return *this; }
+    self operator--(int) { self _ret = *this; _M_dec(); return _ret; }
+    operator bool() const { return _node != nullptr && _pos < _node->_count; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._node == _y._node && _x._pos == _y._pos; }
+    friend bool operator!=(const self& _x, const self& _y) { return !(_x == _y); }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const bplus_tree_const_iterator<_T>& _r);
+
+    void _M_inc() { if (++_pos >= _node->_count) { _node = _node->_next; _pos = 0; } }
+    void _M_dec() {
+        if (_pos == 0) { _node = _node->_prev; _pos = _node->_count; }
+        --_pos;
+    }
+};
+
+template <typename _Key, typename _Value, typename _Alloc> struct bplus_tree_alloc
+: public _Alloc {
+    typedef bplus_tree_leaf<_Value> leaf_type;
+    typedef bplus_tree_inner<_Key> inner_type;
+
+    typedef _Alloc elt_allocator_type;
+    typedef std::allocator_traits<elt_allocator_type> elt_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<leaf_type> leaf_allocator_type;
+    typedef std::allocator_traits<leaf_allocator_type> leaf_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<inner_type> inner_allocator_type;
+    typedef std::allocator_traits<inner_allocator_type> inner_alloc_traits;
+
+    elt_allocator_type& _M_get_elt_allocator() { return *static_cast<elt_allocator_type*>(this); }
+    const elt_allocator_type& _M_get_elt_allocator() const { return *static_cast<const elt_allocator_type*>(this); }
+    leaf_allocator_type _M_get_leaf_allocator() const { return leaf_allocator_type(_M_get_elt_allocator()); }
+    inner_allocator_type _M_get_inner_allocator() const { return inner_allocator_type(_M_get_elt_allocator()); }
+
+    leaf_type* _M_allocate_leaf() {
+        leaf_allocator_type _leaf_alloc = _M_get_leaf_allocator();
+        auto _ptr = leaf_alloc_traits::allocate(_leaf_alloc, 1);
+        leaf_type* _p = std::addressof(*_ptr);
+        leaf_alloc_traits::construct(_leaf_alloc, _p);
+        return _p;
+    }
+    // values in %_p should be destroyed before
+    void _M_deallocate_leaf(leaf_type* _p) {
+        leaf_allocator_type _leaf_alloc = _M_get_leaf_allocator();
+        leaf_alloc_traits::destroy(_leaf_alloc, _p);
+        leaf_alloc_traits::deallocate(_leaf_alloc, _p, 1);
+    }
+    inner_type* _M_allocate_inner() {
+        inner_allocator_type _inner_alloc = _M_get_inner_allocator();
+        auto _ptr = inner_alloc_traits::allocate(_inner_alloc, 1);
+        inner_type* _p = std::addressof(*_ptr);
+        inner_alloc_traits::construct(_inner_alloc, _p);
+        return _p;
+    }
+    // keys in %_p should be destroyed before
+    void _M_deallocate_inner(inner_type* _p) {
+        inner_allocator_type _inner_alloc = _M_get_inner_allocator();
+        inner_alloc_traits::destroy(_inner_alloc, _p);
+        inner_alloc_traits::deallocate(_inner_alloc, _p, 1);
+    }
+
+    template <typename... _Args> void _M_construct_value(_Value* _p, _Args&&... _args) {
+        elt_alloc_traits::construct(_M_get_elt_allocator(), _p, std::forward<_Args>(_args)...);
+    }
+    void _M_destroy_value(_Value* _p) {
+        elt_alloc_traits::destroy(_M_get_elt_allocator(), _p);
+    }
+    // move-construct %_src into uninitialized %_dst, and destroy %_src
+    void _M_relocate_value(_Value* _dst, _Value* _src) {
+        _M_construct_value(_dst, std::move(*_src));
+        _M_destroy_value(_src);
+    }
+    void _M_relocate_key(_Key* _dst, _Key* _src) {
+        ::new (static_cast<void*>(_dst)) _Key(std::move(*_src));
+        _src->~_Key();
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+class bplus_tree : public bplus_tree_alloc<_Key, _Value, _Alloc> {
+public:
+    typedef bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc> self;
+    typedef bplus_tree_alloc<_Key, _Value, _Alloc> base;
+    typedef typename base::elt_allocator_type elt_allocator_type;
+    typedef typename base::elt_alloc_traits elt_alloc_traits;
+
+    typedef _Key key_type;
+    typedef _Comp key_compare;
+    typedef _Value value_type;
+    typedef bplus_tree_node_base node_base;
+    typedef bplus_tree_leaf_base link_type;
+    typedef typename base::leaf_type leaf_type;
+    typedef typename base::inner_type inner_type;
+
+    typedef bplus_tree_iterator<value_type> iterator;
+    typedef bplus_tree_const_iterator<value_type> const_iterator;
+
+    typedef asp::conditional_t<_UniqueKey, std::pair<iterator, bool>, iterator> ireturn_type;
+
+    typedef asso_container::type_traits<value_type, _UniqueKey> _ContainerTypeTraits;
+
+    typedef typename _ContainerTypeTraits::insert_status insert_status;
+    typedef typename _ContainerTypeTraits::ext_iterator ext_iterator;
+    typedef typename _ContainerTypeTraits::ext_value ext_value;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef _ExtKey ext_key;
+
+    static constexpr const size_type _S_leaf_capacity = leaf_type::_S_capacity;
+    static constexpr const size_type _S_inner_capacity = inner_type::_S_capacity;
+    static constexpr const size_type _S_leaf_min = _S_leaf_capacity / 2;
+    static constexpr const size_type _S_inner_min = _S_inner_capacity / 2;
+
+    link_type _m_header;
+    node_base* _m_root = nullptr;
+    size_type _m_element_count = 0;
+    _ExtKey _m_extract_key;
+    _Comp _m_key_compare;
+
+    static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
+
+    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const bplus_tree<_K, _V, _EK, _UK, _C, _A>& _b);
+
+public:
+    bplus_tree() { _M_init_header(); }
+    bplus_tree(const self& _b);
+    self& operator=(const self& _b);
+    virtual ~bplus_tree();
+
+    iterator begin() { return iterator(_m_header._next, 0); }
+    const_iterator cbegin() const { return const_iterator(_m_header._next, 0); }
+    iterator end() { return iterator(&_m_header, 0); }
+    const_iterator cend() const { return const_iterator(&_m_header, 0); }
+    size_type size() const { return _m_element_count; }
+    bool empty() const { return _m_element_count == 0; }
+
+    iterator find(const key_type& _k);
+    const_iterator find(const key_type& _k) const;
+    size_type count(const key_type& _k) const;
+    void clear();
+    ireturn_type insert(const value_type& _v);
+    size_type erase(const key_type& _k);
+    iterator erase(const_iterator _p);
+
+    iterator lower_bound(const key_type& _k) { return _M_lower_bound(_k)._const_cast(); }
+    const_iterator lower_bound(const key_type& _k) const { return _M_lower_bound(_k); }
+    iterator upper_bound(const key_type& _k) { return _M_upper_bound(_k)._const_cast(); }
+    const_iterator upper_bound(const key_type& _k) const { return _M_upper_bound(_k); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k);
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const;
+
+    // used for test
+    int check() const;
+
+protected:
+    void _M_init_header() { _m_header._prev = &_m_header; _m_header._next = &_m_header; }
+    // return _x < _y;
+    bool _M_key_compare(const key_type& _x, const key_type& _y) const { return _m_key_compare(_x, _y); }
+
+    // child index of the first separator not less than %_k
+    size_type _M_inner_lower(const inner_type* _x, const key_type& _k) const;
+    // child index of the first separator greater than %_k
+    size_type _M_inner_upper(const inner_type* _x, const key_type& _k) const;
+    size_type _M_leaf_lower(const leaf_type* _x, const key_type& _k) const;
+    size_type _M_leaf_upper(const leaf_type* _x, const key_type& _k) const;
+
+    const_iterator _M_lower_bound(const key_type& _k) const;
+    const_iterator _M_upper_bound(const key_type& _k) const;
+    // move iterator to the head of next leaf if %_pos is out of range
+    const_iterator _M_normalize(const link_type* _x, size_type _pos) const;
+    /**
+     * @brief find the leaf where %_k should be inserted.
+     * @details descend with lower bound rule in multi tree, and upper bound rule in unique tree.
+    */
+    leaf_type* _M_insert_leaf(const key_type& _k);
+
+    // @brief unique_insert
+    std::pair<iterator, bool> _M_insert(const value_type& _v, asp::true_type);
+    // @brief multi_insert
+    iterator _M_insert(const value_type& _v, asp::false_type);
+    // insert %_v into %_x at %_pos, split if full.
+    iterator _M_insert_into_leaf(leaf_type* _x, size_type _pos, const value_type& _v);
+    // insert separator %_k and %_r as the next sibling of %_l
+    void _M_insert_into_parent(node_base* _l, const key_type& _k, node_base* _r);
+    // split %_x, return the new right node, %_k is the separator pushed up.
+    inner_type* _M_split_inner(inner_type* _x, key_type* _k);
+
+    void _M_rebalance_leaf(leaf_type* _x);
+    void _M_rebalance_inner(inner_type* _x);
+    // remove separator %_i and child %_i + 1 from %_p
+    void _M_remove_from_inner(inner_type* _p, size_type _i);
+
+    void _M_erase_subtree(node_base* _s);
+    node_base* _M_clone_subtree(const node_base* _s, inner_type* _p);
+
+    int _M_check_subtree(const node_base* _s, size_type _depth, size_type& _leaf_depth, size_type& _n) const;
+};
+
+/// __bplus_tree__ implement
+namespace __bplus_tree__ {
+template <typename _Tp, typename _Key, typename _ExtKey, typename _Comp>
+size_type _S_branchless_lower_bound(const _Tp* _a, size_type _n, const _Key& _k, const _ExtKey& _ext, const _Comp& _comp) {
+    if (_n == 0) return 0;
+    const _Tp* _base = _a;
+    while (_n > 1) {
+        const size_type _half = _n / 2;
+        _base = _comp(_ext(_base[_half - 1]), _k) ? _base + _half : _base;
+        _n -= _half;
+    }
+    return (_base - _a) + (_comp(_ext(*_base), _k) ? 1 : 0);
+};
+template <typename _Tp, typename _Key, typename _ExtKey, typename _Comp>
+size_type _S_branchless_upper_bound(const _Tp* _a, size_type _n, const _Key& _k, const _ExtKey& _ext, const _Comp& _comp) {
+    if (_n == 0) return 0;
+    const _Tp* _base = _a;
+    while (_n > 1) {
+        const size_type _half = _n / 2;
+        _base = !_comp(_k, _ext(_base[_half - 1])) ? _base + _half : _base;
+        _n -= _half;
+    }
+    return (_base - _a) + (!_comp(_k, _ext(*_base)) ? 1 : 0);
+};
+};
+
+/// bplus_tree protected implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_inner_lower(const inner_type* _x, const key_type& _k) const -> size_type {
+    return __bplus_tree__::_S_branchless_lower_bound(_x->_M_keys(), _x->_count - 1, _k, _select_self_ref(), _m_key_compare);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_inner_upper(const inner_type* _x, const key_type& _k) const -> size_type {
+    return __bplus_tree__::_S_branchless_upper_bound(_x->_M_keys(), _x->_count - 1, _k, _select_self_ref(), _m_key_compare);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_leaf_lower(const leaf_type* _x, const key_type& _k) const -> size_type {
+    return __bplus_tree__::_S_branchless_lower_bound(_x->_M_values(), _x->_count, _k, _m_extract_key, _m_key_compare);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_leaf_upper(const leaf_type* _x, const key_type& _k) const -> size_type {
+    return __bplus_tree__::_S_branchless_upper_bound(_x->_M_values(), _x->_count, _k, _m_extract_key, _m_key_compare);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_normalize(const link_type* _x, size_type _pos) const -> const_iterator {
+    if (_pos >= _x->_count) {
+        return const_iterator(_x->_next, 0);
+    }
+    return const_iterator(_x, _pos);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_lower_bound(const key_type& _k) const -> const_iterator {
+    if (_m_root == nullptr) return cend();
+    const node_base* _x = _m_root;
+    while (!_x->_leaf) {
+        const inner_type* _i = static_cast<const inner_type*>(_x);
+        _x = _i->_child[_M_inner_lower(_i, _k)];
+    }
+    const leaf_type* _l = static_cast<const leaf_type*>(_x);
+    return _M_normalize(_l, _M_leaf_lower(_l, _k));
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_upper_bound(const key_type& _k) const -> const_iterator {
+    if (_m_root == nullptr) return cend();
+    const node_base* _x = _m_root;
+    while (!_x->_leaf) {
+        const inner_type* _i = static_cast<const inner_type*>(_x);
+        _x = _i->_child[_M_inner_upper(_i, _k)];
+    }
+    const leaf_type* _l = static_cast<const leaf_type*>(_x);
+    return _M_normalize(_l, _M_leaf_upper(_l, _k));
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert_leaf(const key_type& _k) -> leaf_type* {
+    node_base* _x = _m_root;
+    while (!_x->_leaf) {
+        inner_type* _i = static_cast<inner_type*>(_x);
+        _x = _i->_child[_UniqueKey ? _M_inner_upper(_i, _k) : _M_inner_lower(_i, _k)];
+    }
+    return static_cast<leaf_type*>(_x);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert(const value_type& _v, asp::true_type) -> std::pair<iterator, bool> {
+    const key_type _k = _S_key(_v);
+    const_iterator _j = _M_lower_bound(_k);
+    if (_j != cend() && !_M_key_compare(_k, _S_key(*_j))) {
+        return std::make_pair(_j._const_cast(), false);
+    }
+    if (_m_root == nullptr) {
+        leaf_type* _l = this->_M_allocate_leaf();
+        _l->hook(&_m_header);
+        _m_root = _l;
+    }
+    leaf_type* _l = _M_insert_leaf(_k);
+    iterator _ret = _M_insert_into_leaf(_l, _M_leaf_lower(_l, _k), _v);
+    ++_m_element_count;
+    return std::make_pair(_ret, true);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert(const value_type& _v, asp::false_type) -> iterator {
+    const key_type _k = _S_key(_v);
+    if (_m_root == nullptr) {
+        leaf_type* _l = this->_M_allocate_leaf();
+        _l->hook(&_m_header);
+        _m_root = _l;
+    }
+    leaf_type* _l = _M_insert_leaf(_k);
+    iterator _ret = _M_insert_into_leaf(_l, _M_leaf_upper(_l, _k), _v);
+    ++_m_element_count;
+    return _ret;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert_into_leaf(leaf_type* _x, size_type _pos, const value_type& _v) -> iterator {
+    if (_x->_count == _S_leaf_capacity) { // split
+        leaf_type* _r = this->_M_allocate_leaf();
+        const size_type _h = _S_leaf_capacity / 2;
+        for (size_type _i = _h; _i < _x->_count; ++_i) {
+            this->_M_relocate_value(_r->valptr(_i - _h), _x->valptr(_i));
+        }
+        _r->_count = _x->_count - _h;
+        _x->_count = _h;
+        _r->hook(_x->_next);
+        // the key at %_pos is not less than %_k, so it's safe to insert %_v into the left leaf
+        leaf_type* _target = _x;
+        if (_pos > _h) {
+            _target = _r;
+            _pos -= _h;
+        }
+        iterator _ret = _M_insert_into_leaf(_target, _pos, _v);
+        _M_insert_into_parent(_x, _S_key(_r->val(0)), _r);
+        return _ret;
+    }
+    for (size_type _i = _x->_count; _i > _pos; --_i) {
+        this->_M_relocate_value(_x->valptr(_i), _x->valptr(_i - 1));
+    }
+    this->_M_construct_value(_x->valptr(_pos), _v);
+    ++_x->_count;
+    return iterator(_x, _pos);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert_into_parent(node_base* _l, const key_type& _k, node_base* _r) -> void {
+    inner_type* _p = static_cast<inner_type*>(_l->_parent);
+    if (_p == nullptr) { // grow a new root
+        _p = this->_M_allocate_inner();
+        ::new (static_cast<void*>(_p->_M_keys())) key_type(_k);
+        _p->_child[0] = _l;
+        _p->_child[1] = _r;
+        _p->_count = 2;
+        _l->_parent = _p;
+        _r->_parent = _p;
+        _m_root = _p;
+        return;
+    }
+    size_type _ci = _p->_M_index(_l);
+    if (_p->_count == _S_inner_capacity) {
+        alignas(key_type) unsigned char _buf[sizeof(key_type)];
+        key_type* _up = reinterpret_cast<key_type*>(_buf);
+        inner_type* _pr = _M_split_inner(_p, _up);
+        const size_type _h = _p->_count;
+        inner_type* _target = _p;
+        if (_ci >= _h) {
+            _target = _pr;
+            _ci -= _h;
+        }
+        for (size_type _i = _target->_count - 1; _i > _ci; --_i) {
+            this->_M_relocate_key(_target->_M_keys() + _i, _target->_M_keys() + _i - 1);
+            _target->_child[_i + 1] = _target->_child[_i];
+        }
+        ::new (static_cast<void*>(_target->_M_keys() + _ci)) key_type(_k);
+        _target->_child[_ci + 1] = _r;
+        _r->_parent = _target;
+        ++_target->_count;
+        _M_insert_into_parent(_p, *_up, _pr);
+        _up->~key_type();
+        return;
+    }
+    for (size_type _i = _p->_count - 1; _i > _ci; --_i) {
+        this->_M_relocate_key(_p->_M_keys() + _i, _p->_M_keys() + _i - 1);
+        _p->_child[_i + 1] = _p->_child[_i];
+    }
+    ::new (static_cast<void*>(_p->_M_keys() + _ci)) key_type(_k);
+    _p->_child[_ci + 1] = _r;
+    _r->_parent = _p;
+    ++_p->_count;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_split_inner(inner_type* _x, key_type* _k) -> inner_type* {
+    inner_type* _r = this->_M_allocate_inner();
+    const size_type _h = _x->_count / 2;
+    // children [0, _h) and keys [0, _h - 1) stay, key[_h - 1] goes up
+    for (size_type _i = _h; _i < _x->_count; ++_i) {
+        _r->_child[_i - _h] = _x->_child[_i];
+        _r->_child[_i - _h]->_parent = _r;
+    }
+    for (size_type _i = _h; _i < _x->_count - 1; ++_i) {
+        this->_M_relocate_key(_r->_M_keys() + _i - _h, _x->_M_keys() + _i);
+    }
+    this->_M_relocate_key(_k, _x->_M_keys() + _h - 1);
+    _r->_count = _x->_count - _h;
+    _x->_count = _h;
+    return _r;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_remove_from_inner(inner_type* _p, size_type _i) -> void {
+    _p->key(_i).~key_type();
+    for (size_type _j = _i; _j + 2 < _p->_count; ++_j) {
+        this->_M_relocate_key(_p->_M_keys() + _j, _p->_M_keys() + _j + 1);
+    }
+    for (size_type _j = _i + 1; _j + 1 < _p->_count; ++_j) {
+        _p->_child[_j] = _p->_child[_j + 1];
+    }
+    --_p->_count;
+    if (_p == _m_root) {
+        if (_p->_count == 1) { // shrink the root
+            _m_root = _p->_child[0];
+            _m_root->_parent = nullptr;
+            this->_M_deallocate_inner(_p);
+        }
+    }
+    else if (_p->_count < _S_inner_min) {
+        _M_rebalance_inner(_p);
+    }
+};
+/**
+ * @details
+ *   %_x has less than %_S_leaf_min elements (and isn't root).
+ *   case 1: borrow the last value of left sibling.
+ *   case 2: borrow the first value of right sibling.
+ *   case 3: merge with one of the siblings, and remove a separator from parent.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_rebalance_leaf(leaf_type* _x) -> void {
+    inner_type* _p = static_cast<inner_type*>(_x->_parent);
+    const size_type _ci = _p->_M_index(_x);
+    leaf_type* _l = _ci > 0 ? static_cast<leaf_type*>(_p->_child[_ci - 1]) : nullptr;
+    leaf_type* _r = _ci + 1 < _p->_count ? static_cast<leaf_type*>(_p->_child[_ci + 1]) : nullptr;
+    if (_l != nullptr && _l->_count > _S_leaf_min) { // case 1
+        for (size_type _i = _x->_count; _i > 0; --_i) {
+            this->_M_relocate_value(_x->valptr(_i), _x->valptr(_i - 1));
+        }
+        this->_M_relocate_value(_x->valptr(0), _l->valptr(_l->_count - 1));
+        --_l->_count; ++_x->_count;
+        _p->key(_ci - 1) = _S_key(_x->val(0));
+    }
+    else if (_r != nullptr && _r->_count > _S_leaf_min) { // case 2
+        this->_M_relocate_value(_x->valptr(_x->_count), _r->valptr(0));
+        for (size_type _i = 1; _i < _r->_count; ++_i) {
+            this->_M_relocate_value(_r->valptr(_i - 1), _r->valptr(_i));
+        }
+        --_r->_count; ++_x->_count;
+        _p->key(_ci) = _S_key(_r->val(0));
+    }
+    else { // case 3
+        leaf_type* _dst = _l != nullptr ? _l : _x;
+        leaf_type* _src = _l != nullptr ? _x : _r;
+        for (size_type _i = 0; _i < _src->_count; ++_i) {
+            this->_M_relocate_value(_dst->valptr(_dst->_count + _i), _src->valptr(_i));
+        }
+        _dst->_count += _src->_count;
+        _src->_count = 0;
+        _src->unhook();
+        this->_M_deallocate_leaf(_src);
+        _M_remove_from_inner(_p, _l != nullptr ? _ci - 1 : _ci);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_rebalance_inner(inner_type* _x) -> void {
+    inner_type* _p = static_cast<inner_type*>(_x->_parent);
+    const size_type _ci = _p->_M_index(_x);
+    inner_type* _l = _ci > 0 ? static_cast<inner_type*>(_p->_child[_ci - 1]) : nullptr;
+    inner_type* _r = _ci + 1 < _p->_count ? static_cast<inner_type*>(_p->_child[_ci + 1]) : nullptr;
+    if (_l != nullptr && _l->_count > _S_inner_min) { // rotate right through parent
+        for (size_type _i = _x->_count - 1; _i > 0; --_i) {
+            this->_M_relocate_key(_x->_M_keys() + _i, _x->_M_keys() + _i - 1);
+        }
+        for (size_type _i = _x->_count; _i > 0; --_i) {
+            _x->_child[_i] = _x->_child[_i - 1];
+        }
+        this->_M_relocate_key(_x->_M_keys(), _p->_M_keys() + _ci - 1);
+        this->_M_relocate_key(_p->_M_keys() + _ci - 1, _l->_M_keys() + _l->_count - 2);
+        _x->_child[0] = _l->_child[_l->_count - 1];
+        _x->_child[0]->_parent = _x;
+        --_l->_count; ++_x->_count;
+    }
+    else if (_r != nullptr && _r->_count > _S_inner_min) { // rotate left through parent
+        this->_M_relocate_key(_x->_M_keys() + _x->_count - 1, _p->_M_keys() + _ci);
+        this->_M_relocate_key(_p->_M_keys() + _ci, _r->_M_keys());
+        _x->_child[_x->_count] = _r->_child[0];
+        _x->_child[_x->_count]->_parent = _x;
+        for (size_type _i = 0; _i + 2 < _r->_count; ++_i) {
+            this->_M_relocate_key(_r->_M_keys() + _i, _r->_M_keys() + _i + 1);
+        }
+        for (size_type _i = 0; _i + 1 < _r->_count; ++_i) {
+            _r->_child[_i] = _r->_child[_i + 1];
+        }
+        --_r->_count; ++_x->_count;
+    }
+    else { // merge, pull the separator down
+        inner_type* _dst = _l != nullptr ? _l : _x;
+        inner_type* _src = _l != nullptr ? _x : _r;
+        const size_type _si = _l != nullptr ? _ci - 1 : _ci;
+        ::new (static_cast<void*>(_dst->_M_keys() + _dst->_count - 1)) key_type(_p->key(_si));
+        for (size_type _i = 0; _i + 1 < _src->_count; ++_i) {
+            this->_M_relocate_key(_dst->_M_keys() + _dst->_count + _i, _src->_M_keys() + _i);
+        }
+        for (size_type _i = 0; _i < _src->_count; ++_i) {
+            _dst->_child[_dst->_count + _i] = _src->_child[_i];
+            _src->_child[_i]->_parent = _dst;
+        }
+        _dst->_count += _src->_count;
+        _src->_count = 0;
+        this->_M_deallocate_inner(_src);
+        _M_remove_from_inner(_p, _si);
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_erase_subtree(node_base* _s) -> void {
+    if (_s == nullptr) return;
+    if (_s->_leaf) {
+        leaf_type* _l = static_cast<leaf_type*>(_s);
+        for (size_type _i = 0; _i < _l->_count; ++_i) {
+            this->_M_destroy_value(_l->valptr(_i));
+        }
+        this->_M_deallocate_leaf(_l);
+        return;
+    }
+    inner_type* _x = static_cast<inner_type*>(_s);
+    for (size_type _i = 0; _i < _x->_count; ++_i) {
+        _M_erase_subtree(_x->_child[_i]);
+    }
+    for (size_type _i = 0; _i + 1 < _x->_count; ++_i) {
+        _x->key(_i).~key_type();
+    }
+    this->_M_deallocate_inner(_x);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_clone_subtree(const node_base* _s, inner_type* _p) -> node_base* {
+    if (_s->_leaf) {
+        const leaf_type* _l = static_cast<const leaf_type*>(_s);
+        leaf_type* _top = this->_M_allocate_leaf();
+        for (size_type _i = 0; _i < _l->_count; ++_i) {
+            this->_M_construct_value(_top->valptr(_i), _l->val(_i));
+        }
+        _top->_count = _l->_count;
+        _top->_parent = _p;
+        _top->hook(&_m_header); // leaves are cloned in order
+        return _top;
+    }
+    const inner_type* _x = static_cast<const inner_type*>(_s);
+    inner_type* _top = this->_M_allocate_inner();
+    for (size_type _i = 0; _i + 1 < _x->_count; ++_i) {
+        ::new (static_cast<void*>(_top->_M_keys() + _i)) key_type(_x->key(_i));
+    }
+    for (size_type _i = 0; _i < _x->_count; ++_i) {
+        _top->_child[_i] = _M_clone_subtree(_x->_child[_i], _top);
+    }
+    _top->_count = _x->_count;
+    _top->_parent = _p;
+    return _top;
+};
+
+/**
+ * @returns 0 : normal ;
+ *   1 : error in parent pointer ;
+ *   2 : leaves in different depth ;
+ *   3 : node underflow or overflow ;
+ *   4 : separator out of order .
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_check_subtree(const node_base* _s, size_type _depth, size_type& _leaf_depth, size_type& _n) const -> int {
+    const bool _is_root = _s == _m_root;
+    if (_s->_leaf) {
+        if (_leaf_depth == 0) _leaf_depth = _depth;
+        if (_leaf_depth != _depth) return 2;
+        if (_s->_count > _S_leaf_capacity || _s->_count == 0 || (!_is_root && _s->_count < _S_leaf_min)) return 3;
+        _n += _s->_count;
+        return 0;
+    }
+    const inner_type* _x = static_cast<const inner_type*>(_s);
+    if (_x->_count > _S_inner_capacity || _x->_count < 2 || (!_is_root && _x->_count < _S_inner_min)) return 3;
+    for (size_type _i = 0; _i < _x->_count; ++_i) {
+        const node_base* _c = _x->_child[_i];
+        if (_c->_parent != _x) return 1;
+        // keys in _c must be in [key(_i - 1), key(_i)]
+        const node_base* _y = _c;
+        while (!_y->_leaf) _y = static_cast<const inner_type*>(_y)->_child[0];
+        const leaf_type* _first = static_cast<const leaf_type*>(_y);
+        _y = _c;
+        while (!_y->_leaf) _y = static_cast<const inner_type*>(_y)->_child[_y->_count - 1];
+        const leaf_type* _last = static_cast<const leaf_type*>(_y);
+        if (_i > 0 && _M_key_compare(_S_key(_first->val(0)), _x->key(_i - 1))) return 4;
+        if (_i + 1 < _x->_count) {
+            const key_type& _sep = _x->key(_i);
+            if (_M_key_compare(_sep, _S_key(_last->val(_last->_count - 1)))) return 4;
+            if (_UniqueKey && !_M_key_compare(_S_key(_last->val(_last->_count - 1)), _sep)) return 4;
+        }
+        int _ret = _M_check_subtree(_c, _depth + 1, _leaf_depth, _n);
+        if (_ret != 0) return _ret;
+    }
+    return 0;
+};
+
+/// bplus_tree public implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::bplus_tree(const self& _b)
+: base(_b), _m_key_compare(_b._m_key_compare) {
+    _M_init_header();
+    if (_b._m_root != nullptr) {
+        _m_root = _M_clone_subtree(_b._m_root, nullptr);
+    }
+    _m_element_count = _b._m_element_count;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::operator=(const self& _b) -> self& {
+    if (&_b == this) return *this;
+    clear();
+    if (_b._m_root != nullptr) {
+        _m_root = _M_clone_subtree(_b._m_root, nullptr);
+    }
+    _m_element_count = _b._m_element_count;
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::~bplus_tree() {
+    clear();
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find(const key_type& _k)
+-> iterator {
+    return static_cast<const self*>(this)->find(_k)._const_cast();
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find(const key_type& _k) const
+-> const_iterator {
+    const_iterator _j = _M_lower_bound(_k);
+    return (_j == cend() || _M_key_compare(_k, _S_key(*_j))) ? cend() : _j;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::count(const key_type& _k) const
+-> size_type {
+    std::pair<const_iterator, const_iterator> _res = equal_range(_k);
+    return asp::distance(_res.first, _res.second);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::clear()
+-> void {
+    _M_erase_subtree(_m_root);
+    _m_root = nullptr;
+    _m_element_count = 0;
+    _M_init_header();
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::insert(const value_type& _v)
+-> ireturn_type {
+    return this->_M_insert(_v, asp::bool_t<_UniqueKey>());
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::erase(const_iterator _p)
+-> iterator {
+    leaf_type* _x = static_cast<leaf_type*>(const_cast<link_type*>(_p._node));
+    const key_type _k = _S_key(*_p);
+    // rank of %_p in its equal range
+    const size_type _rank = asp::distance(_M_lower_bound(_k), _p);
+    this->_M_destroy_value(_x->valptr(_p._pos));
+    for (size_type _i = _p._pos + 1; _i < _x->_count; ++_i) {
+        this->_M_relocate_value(_x->valptr(_i - 1), _x->valptr(_i));
+    }
+    --_x->_count;
+    --_m_element_count;
+    if (_x == _m_root) {
+        if (_x->_count == 0) {
+            _x->unhook();
+            this->_M_deallocate_leaf(_x);
+            _m_root = nullptr;
+            return end();
+        }
+    }
+    else if (_x->_count < _S_leaf_min) {
+        _M_rebalance_leaf(_x);
+    }
+    // rebalancing moves values between leaves, so locate the successor again
+    const_iterator _j = _M_lower_bound(_k);
+    for (size_type _i = 0; _i < _rank; ++_i) ++_j;
+    return _j._const_cast();
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::erase(const key_type& _k)
+-> size_type {
+    size_type _ret = 0;
+    const_iterator _j = _M_lower_bound(_k);
+    while (_j != cend() && !_M_key_compare(_k, _S_key(*_j))) {
+        _j = erase(_j);
+        ++_ret;
+    }
+    return _ret;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key_type& _k)
+-> std::pair<iterator, iterator> {
+    return std::make_pair(lower_bound(_k), upper_bound(_k));
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key_type& _k) const
+-> std::pair<const_iterator, const_iterator> {
+    return std::make_pair(lower_bound(_k), upper_bound(_k));
+};
+
+/**
+ * @returns 0 : normal ;
+ *   1 ~ 4 : error in structure (see _M_check_subtree) ;
+ *   5 : error in %_m_element_count ;
+ *   6 : error in order (traversation through leaf links) .
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+bplus_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> int {
+    if (_m_root == nullptr) {
+        return (_m_element_count == 0 && _m_header._next == &_m_header) ? 0 : 5;
+    }
+    if (_m_root->_parent != nullptr) return 1;
+    size_type _leaf_depth = 0;
+    size_type _n = 0;
+    int _ret = _M_check_subtree(_m_root, 1, _leaf_depth, _n);
+    if (_ret != 0) return _ret;
+    if (_n != _m_element_count) return 5;
+    size_type _traversed = 0;
+    for (const_iterator _i = cbegin(); _i != cend(); ++_i, ++_traversed) {
+        const_iterator _j = _i; ++_j;
+        if (_j == cend()) continue;
+        if (_M_key_compare(_S_key(*_j), _S_key(*_i))) return 6;
+        if (_UniqueKey && !_M_key_compare(_S_key(*_i), _S_key(*_j))) return 6;
+    }
+    if (_traversed != _m_element_count) return 5;
+    return 0;
+};
+
+
+/// output implement
+template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
+std::ostream& operator<<(std::ostream& os, const bplus_tree<_K, _V, _EK, _UK, _C, _A>& _b) {
+    os << '[';
+    for (auto p = _b.cbegin(); p != _b.cend();) {
+        os << p;
+        if (++p != _b.cend()) {
+            os << ", ";
+        }
+    }
+    os << ']';
+    return os;
+};
+template <typename _T> std::ostream& operator<<(std::ostream& os, const bplus_tree_iterator<_T>& _r) {
+    if (_r)
+        os << obj_string::_M_obj_2_string(*_r);
+    else
+        os << "null";
+    return os;
+};
+template <typename _T> std::ostream& operator<<(std::ostream& os, const bplus_tree_const_iterator<_T>& _r) {
+    if (_r)
+        os << obj_string::_M_obj_2_string(*_r);
+    else
+        os << "null";
+    return os;
+};
+
+};
+
+#endif // _ASP_BPLUS_TREE_HPP_
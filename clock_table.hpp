@@ -0,0 +1,407 @@
+#ifndef _ASP_CLOCK_TABLE_HPP_
+#define _ASP_CLOCK_TABLE_HPP_
+
+#include "associative_container_aux.hpp"
+#include "hash_table.hpp"
+#include <atomic>
+#include <memory>
+
+#include "basic_io.hpp"
+
+namespace asp {
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<_Value>,
+ bool _ClockPro = false
+> struct clock_table;
+
+namespace {
+template <typename _ExtOp> struct _select_clock_slot_action {
+    // _Ptr == const value_type*
+    template <typename _Ptr> auto operator()(_Ptr _x) const {
+        return _ExtOp()(*_x);
+    }
+};
+};
+
+/**
+ * @brief cache structure evicting by CLOCK (second chance), an approximation of LRU
+ * @details
+ *   the elements live in a flat array of %capacity() slots, and the hash table maps a key to its slot.
+ *   each slot has a reference bit, a hit only sets the bit (no pointer is written),
+ *   a miss on a full table sweeps the hand over the slots : a referenced one gets its bit cleared (second chance),
+ *   the first one unreferenced is replaced.
+ *   the occupied slots are always %[0, size()), so the slot pointer is the iterator.
+ *   compared with @lru_table, an element saves the two links of the list node.
+ *   concurrent %get() calls are safe with each other (the bit is a relaxed atomic, the lookup is read only),
+ *   not with any other modification.
+ * @tparam _ClockPro
+ *   true to use a simplified CLOCK-Pro for scan resistance :
+ *   an element is cold on insertion, and becomes hot if it's referenced again while resident.
+ *   the cold hand only evicts cold slots, and the hot hand demotes unreferenced hot slots to keep
+ *   hot ones within %capacity() - %_m_cold_target.
+ *   keys of evicted cold slots stay in a ring of %capacity() non-resident keys (the test period),
+ *   reinserting such a key makes it hot and grows %_m_cold_target, a key leaving the ring unused shrinks it.
+ *   so a scan of keys used once only cycles through the cold slots.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro>
+struct clock_table {
+    typedef clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro> self;
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef const value_type* const_iterator;
+    typedef hash_table<_Key, const _Value*, _select_clock_slot_action<_ExtKey>, true, _select_clock_slot_action<_ExtValue>, _Hash, _Alloc> hash_table_t;
+    // non-resident key -> its sequence number in the ring
+    typedef hash_table<_Key, std::pair<const _Key, size_type>, _select_0x, true, _select_1x, _Hash, _Alloc> ghost_table_t;
+    typedef asso_container::type_traits<_Value, true> _ContainerTypeTraits;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+
+    enum slot_state : unsigned char { __EMPTY__ = 0, __COLD__, __HOT__ };
+
+protected:
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<_Value> value_allocator_type;
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<_Key> key_allocator_type;
+
+    value_allocator_type _m_alloc;
+    _Value* _m_values = nullptr;
+    std::atomic<unsigned char>* _m_ref = nullptr;
+    unsigned char* _m_state = nullptr;
+    size_type _m_capacity;
+    size_type _m_size = 0;
+    size_type _m_hand = 0;
+    hash_table_t _h;
+    // CLOCK-Pro only
+    size_type _m_hot_hand = 0;
+    size_type _m_hot = 0;
+    size_type _m_cold_target = 0;
+    _Key* _m_ghosts = nullptr;
+    size_type _m_ghost_seq = 0;
+    ghost_table_t _g;
+
+public:
+/// (de)constructor
+    clock_table(size_type _capacity) : _m_capacity(_capacity) { _M_allocate(); }
+    clock_table(const self& _rhs) : _m_capacity(_rhs._m_capacity) { _M_allocate(); _M_assign(_rhs); }
+    self& operator=(const self& _rhs);
+    virtual ~clock_table() { clear(); _M_deallocate(); }
+
+    size_type size() const { return _m_size; }
+    size_type capacity() const { return _m_capacity; }
+    bool empty() const { return _m_size == 0; }
+    void clear();
+    void resize(size_type _new_capacity);
+    const_iterator get(const key_type& _k);
+    void put(const value_type& _v);
+    // the element of %_k without setting the reference bit, cend() if none
+    const_iterator peek(const key_type& _k) const;
+
+    const_iterator cbegin() const { return _m_values; }
+    const_iterator cend() const { return _m_values + _m_size; }
+
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, bool _P>
+     friend std::ostream& operator<<(std::ostream& _os, const clock_table<_K, _T, _Ek, _Ev, _H, _A, _P>& _x);
+
+    int check() const;
+
+protected:
+    size_type _M_min_cold_target() const { return _m_capacity >= 32 ? _m_capacity / 32 : (_m_capacity > 0 ? 1 : 0); }
+    void _M_allocate();
+    void _M_deallocate();
+    void _M_assign(const self& _rhs);
+    /**
+     * @brief sweep the (cold) hand and destroy the victim
+     * @return the index of the emptied slot
+    */
+    size_type _M_evict();
+    // demote hot slots (referenced ones get a second chance) until there are %_target at most
+    void _M_demote_hot(size_type _target);
+    void _M_balance_hot() { _M_demote_hot(_m_capacity - _m_cold_target); }
+    // start the test period of %_k
+    void _M_push_ghost(const key_type& _k);
+};
+
+/// protected implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::_M_allocate() -> void {
+    _m_hand = _m_hot_hand = 0;
+    _m_cold_target = _M_min_cold_target();
+    if (_m_capacity == 0) { return; }
+    _m_values = std::allocator_traits<value_allocator_type>::allocate(_m_alloc, _m_capacity);
+    _m_ref = new std::atomic<unsigned char>[_m_capacity];
+    _m_state = new unsigned char[_m_capacity];
+    for (size_type _i = 0; _i < _m_capacity; ++_i) {
+        _m_ref[_i].store(0, std::memory_order_relaxed);
+        _m_state[_i] = __EMPTY__;
+    }
+    if (_ClockPro) {
+        key_allocator_type _ka(_m_alloc);
+        _m_ghosts = std::allocator_traits<key_allocator_type>::allocate(_ka, _m_capacity);
+        for (size_type _i = 0; _i < _m_capacity; ++_i) {
+            std::allocator_traits<key_allocator_type>::construct(_ka, _m_ghosts + _i);
+        }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::_M_deallocate() -> void {
+    if (_m_values == nullptr) { return; }
+    std::allocator_traits<value_allocator_type>::deallocate(_m_alloc, _m_values, _m_capacity);
+    delete[] _m_ref;
+    delete[] _m_state;
+    if (_ClockPro) {
+        key_allocator_type _ka(_m_alloc);
+        for (size_type _i = 0; _i < _m_capacity; ++_i) {
+            std::allocator_traits<key_allocator_type>::destroy(_ka, _m_ghosts + _i);
+        }
+        std::allocator_traits<key_allocator_type>::deallocate(_ka, _m_ghosts, _m_capacity);
+    }
+    _m_values = nullptr;
+    _m_ref = nullptr;
+    _m_state = nullptr;
+    _m_ghosts = nullptr;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::_M_assign(const self& _rhs) -> void {
+    // called on an empty table of the same capacity, the slots are copied in order
+    for (size_type _i = 0; _i < _rhs._m_size; ++_i) {
+        const size_type _j = _m_size++;
+        std::allocator_traits<value_allocator_type>::construct(_m_alloc, _m_values + _j, _rhs._m_values[_i]);
+        _m_ref[_j].store(_rhs._m_ref[_i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _m_state[_j] = _ClockPro ? _rhs._m_state[_i] : (unsigned char)__COLD__;
+        if (_m_state[_j] == __HOT__) {
+            ++_m_hot;
+        }
+        _h.insert(_m_values + _j);
+    }
+    if (_ClockPro) {
+        _M_balance_hot();
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::_M_evict() -> size_type {
+    for (;;) {
+        if (_ClockPro && _m_hot == _m_size) { // possible if not full, the cold hand needs a victim
+            _M_demote_hot(_m_size - 1);
+        }
+        const size_type _i = _m_hand;
+        _m_hand = _m_hand + 1 == _m_capacity ? 0 : _m_hand + 1;
+        if (_m_state[_i] == __EMPTY__ || (_ClockPro && _m_state[_i] == __HOT__)) {
+            continue;
+        }
+        if (_m_ref[_i].load(std::memory_order_relaxed) != 0) {
+            _m_ref[_i].store(0, std::memory_order_relaxed);
+            if (_ClockPro) { // referenced again while cold
+                _m_state[_i] = __HOT__;
+                ++_m_hot;
+                _M_balance_hot();
+            }
+            continue;
+        }
+        const key_type& _k = _ExtKey()(_m_values[_i]);
+        _h.erase(_k);
+        if (_ClockPro) {
+            _M_push_ghost(_k);
+        }
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _m_values + _i);
+        _m_state[_i] = __EMPTY__;
+        --_m_size;
+        return _i;
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::_M_demote_hot(size_type _target) -> void {
+    while (_m_hot > _target) {
+        const size_type _i = _m_hot_hand;
+        _m_hot_hand = _m_hot_hand + 1 == _m_capacity ? 0 : _m_hot_hand + 1;
+        if (_m_state[_i] != __HOT__) {
+            continue;
+        }
+        if (_m_ref[_i].load(std::memory_order_relaxed) != 0) {
+            _m_ref[_i].store(0, std::memory_order_relaxed);
+            continue;
+        }
+        _m_state[_i] = __COLD__;
+        --_m_hot;
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::_M_push_ghost(const key_type& _k) -> void {
+    key_type& _slot = _m_ghosts[_m_ghost_seq % _m_capacity];
+    if (_m_ghost_seq >= _m_capacity) {
+        // the oldest one leaves the test period, unless it has been reinserted (or pushed again) since
+        const auto _i = _g.find(_slot);
+        if (_i != _g.end() && _i->second + _m_capacity == _m_ghost_seq) {
+            _g.erase(_slot);
+            if (_m_cold_target > _M_min_cold_target()) {
+                --_m_cold_target;
+            }
+        }
+    }
+    _slot = _k;
+    _g.insert({_k, _m_ghost_seq++});
+};
+
+/// public implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::operator=(const self& _rhs) -> self& {
+    if (&_rhs == this) return *this;
+    clear();
+    _M_deallocate();
+    _m_capacity = _rhs._m_capacity;
+    _M_allocate();
+    _M_assign(_rhs);
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::clear() -> void {
+    _h.clear();
+    for (size_type _i = 0; _i < _m_size; ++_i) {
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _m_values + _i);
+        _m_ref[_i].store(0, std::memory_order_relaxed);
+        _m_state[_i] = __EMPTY__;
+    }
+    _m_size = 0;
+    _m_hand = _m_hot_hand = 0;
+    _m_hot = 0;
+    _m_cold_target = _M_min_cold_target();
+    _g.clear();
+    _m_ghost_seq = 0;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::resize(size_type _new_capacity) -> void {
+    if (_new_capacity == _m_capacity) { return; }
+    // evict by the policy first, then move the survivors into the new slots, keeping their order
+    while (_m_size > _new_capacity) {
+        _M_evict();
+    }
+    _Value* const _values = _m_values;
+    std::atomic<unsigned char>* const _ref = _m_ref;
+    unsigned char* const _state = _m_state;
+    _Key* const _ghosts = _m_ghosts;
+    const size_type _capacity = _m_capacity;
+    const size_type _size = _m_size;
+    _h.clear();
+    _g.clear();
+    _m_capacity = _new_capacity;
+    _m_values = nullptr;
+    _m_ref = nullptr;
+    _m_state = nullptr;
+    _m_ghosts = nullptr;
+    _M_allocate();
+    _m_size = _m_hot = _m_ghost_seq = 0;
+    for (size_type _i = 0; _i < _capacity && _m_size < _size; ++_i) {
+        if (_state[_i] == __EMPTY__) { continue; }
+        const size_type _j = _m_size++;
+        std::allocator_traits<value_allocator_type>::construct(_m_alloc, _m_values + _j, std::move(_values[_i]));
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _values + _i);
+        _m_ref[_j].store(_ref[_i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _m_state[_j] = _state[_i];
+        if (_m_state[_j] == __HOT__) {
+            ++_m_hot;
+        }
+        _h.insert(_m_values + _j);
+    }
+    if (_values != nullptr) {
+        std::allocator_traits<value_allocator_type>::deallocate(_m_alloc, _values, _capacity);
+        delete[] _ref;
+        delete[] _state;
+        if (_ClockPro) {
+            key_allocator_type _ka(_m_alloc);
+            for (size_type _i = 0; _i < _capacity; ++_i) {
+                std::allocator_traits<key_allocator_type>::destroy(_ka, _ghosts + _i);
+            }
+            std::allocator_traits<key_allocator_type>::deallocate(_ka, _ghosts, _capacity);
+        }
+    }
+    if (_ClockPro) {
+        _M_balance_hot();
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::get(const key_type& _k) -> const_iterator {
+    const const_iterator _p = peek(_k);
+    if (_p != cend()) {
+        std::atomic<unsigned char>& _r = _m_ref[_p - _m_values];
+        // skip the store if it's set, so that a hot slot stays clean in other caches
+        if (_r.load(std::memory_order_relaxed) == 0) {
+            _r.store(1, std::memory_order_relaxed);
+        }
+    }
+    return _p;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::peek(const key_type& _k) const -> const_iterator {
+    // the const find never steps the incremental rehash
+    const auto _i = _h.find(_k);
+    return _i == _h.cend() ? cend() : *_i;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::put(const value_type& _v) -> void {
+    if (_m_capacity == 0) { return; }
+    const key_type& _k = _ExtKey()(_v);
+    const const_iterator _p = peek(_k);
+    if (_p != cend()) {
+        // replace in place, the key is unchanged so the table holds the same slot
+        const size_type _i = _p - _m_values;
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _m_values + _i);
+        std::allocator_traits<value_allocator_type>::construct(_m_alloc, _m_values + _i, _v);
+        _m_ref[_i].store(1, std::memory_order_relaxed);
+        return;
+    }
+    bool _hot = false;
+    if (_ClockPro && _g.find(_k) != _g.end()) { // in its test period
+        _g.erase(_k);
+        _hot = true;
+        if (_m_cold_target < _m_capacity) {
+            ++_m_cold_target;
+        }
+    }
+    // the occupied slots stay in [0, size()), an eviction empties the slot to be filled
+    const size_type _i = _m_size == _m_capacity ? _M_evict() : _m_size;
+    std::allocator_traits<value_allocator_type>::construct(_m_alloc, _m_values + _i, _v);
+    _m_ref[_i].store(0, std::memory_order_relaxed);
+    _m_state[_i] = _hot ? __HOT__ : __COLD__;
+    ++_m_size;
+    _h.insert(_m_values + _i);
+    if (_hot) {
+        ++_m_hot;
+        _M_balance_hot();
+    }
+};
+
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, bool _P> auto
+operator<<(std::ostream& _os, const clock_table<_K, _T, _Ek, _Ev, _H, _A, _P>& _x) -> std::ostream& {
+    _os << '[';
+    for (auto _p = _x.cbegin(); _p != _x.cend(); ++_p) {
+        _os << obj_string::_M_obj_2_string(*_p);
+        if (_p + 1 != _x.cend()) {
+            _os << ", ";
+        }
+    }
+    return _os << ']';
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _ClockPro> auto
+clock_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _ClockPro>::check() const -> int {
+    if (_m_size > _m_capacity || _h.size() != _m_size) {
+        return 1;
+    }
+    size_type _hot = 0;
+    for (size_type _i = 0; _i < _m_capacity; ++_i) {
+        if ((_m_state[_i] == __EMPTY__) != (_i >= _m_size)) {
+            return 2;
+        }
+        if (_i < _m_size && peek(_ExtKey()(_m_values[_i])) != _m_values + _i) {
+            return 3;
+        }
+        _hot += _m_state[_i] == __HOT__;
+    }
+    if (_hot != _m_hot || (_ClockPro && _m_hot > _m_capacity - _m_cold_target)) {
+        return 4;
+    }
+    return 0;
+};
+
+};
+
+#endif // _ASP_CLOCK_TABLE_HPP_
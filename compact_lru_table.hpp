@@ -0,0 +1,309 @@
+#ifndef _ASP_COMPACT_LRU_TABLE_HPP_
+#define _ASP_COMPACT_LRU_TABLE_HPP_
+
+#include "associative_container_aux.hpp"
+#include <cstdint>
+#include <memory>
+
+#include "basic_io.hpp"
+
+namespace asp {
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<_Value>
+> struct compact_lru_table;
+
+/**
+ * @brief LRU cache in flat arrays linked by 32-bit slot numbers, nothing is allocated after construction
+ * @details
+ *   the elements live in %capacity() slots, the recency list links them by the indices in %_m_links,
+ *   whose last one (%capacity()) is the sentinel. the occupied slots are always %[0, size()),
+ *   so the slot pointer is the iterator. a miss on a full table reuses the slot of the least recently used in place.
+ *   the index is open addressing (linear probing) over 2^k >= 2 * %capacity() buckets holding slot numbers,
+ *   the key is compared through the slot, and an erased bucket is refilled by shifting its followers back (no tombstone).
+ *   memory per element : sizeof(_Value) + 8 bytes of links + 8 ~ 16 bytes of index (load factor 1/4 ~ 1/2),
+ *   e.g. 24 ~ 32 bytes for std::pair<const int, int>, against ~ 96 bytes (with the malloc overhead) of a list node and a hash node in @lru_table.
+ *   the capacity is less than 2^32 - 1.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc>
+struct compact_lru_table {
+    typedef compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc> self;
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef const value_type* const_iterator;
+    typedef asso_container::type_traits<_Value, true> _ContainerTypeTraits;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef std::uint32_t index_type;
+
+    struct slot_link {
+        index_type prev;
+        index_type next;
+    };
+    static constexpr const index_type _S_npos = index_type(-1);
+
+protected:
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<_Value> value_allocator_type;
+
+    value_allocator_type _m_alloc;
+    _Value* _m_values = nullptr;
+    slot_link* _m_links = nullptr;
+    index_type* _m_buckets = nullptr;
+    std::size_t _m_mask = 0;
+    unsigned _m_shift = 0;
+    size_type _m_capacity;
+    size_type _m_size = 0;
+
+public:
+/// (de)constructor
+    compact_lru_table(size_type _capacity) : _m_capacity(_capacity) { _M_allocate(); }
+    compact_lru_table(const self& _rhs) : _m_capacity(_rhs._m_capacity) { _M_allocate(); _M_assign(_rhs, _rhs._m_size); }
+    self& operator=(const self& _rhs);
+    virtual ~compact_lru_table() { clear(); _M_deallocate(); }
+
+    size_type size() const { return _m_size; }
+    size_type capacity() const { return _m_capacity; }
+    bool empty() const { return _m_size == 0; }
+    void clear();
+    // the slots are reallocated, keeping the most recently used
+    void resize(size_type _new_capacity);
+    const_iterator get(const key_type& _k);
+    void put(const value_type& _v);
+    // the element of %_k without updating the recency (read only), cend() if none
+    const_iterator peek(const key_type& _k) const;
+
+    // in the order of the slots, not of the recency
+    const_iterator cbegin() const { return _m_values; }
+    const_iterator cend() const { return _m_values + _m_size; }
+
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A>
+     friend std::ostream& operator<<(std::ostream& _os, const compact_lru_table<_K, _T, _Ek, _Ev, _H, _A>& _x);
+
+    int check() const;
+
+protected:
+    index_type _M_sentinel() const { return index_type(_m_capacity); }
+    void _M_allocate();
+    void _M_deallocate();
+    // put the %_n most recently used elements of %_rhs, into an empty table
+    void _M_assign(const self& _rhs, size_type _n);
+    void _M_swap(self& _rhs);
+    // fibonacci hashing, the high bits are the home bucket
+    std::size_t _M_home(const key_type& _k) const {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(_Hash()(_k)) * 0x9E3779B97F4A7C15ull) >> _m_shift);
+    }
+    // the bucket holding %_k, or the empty one ending its probe sequence
+    std::size_t _M_find(const key_type& _k) const;
+    void _M_erase_bucket(std::size_t _b);
+    void _M_unlink(index_type _i);
+    void _M_link_front(index_type _i);
+};
+
+/// protected implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_allocate() -> void {
+    std::size_t _n = 2;
+    _m_shift = 63;
+    while (_n < 2 * std::size_t(_m_capacity)) {
+        _n <<= 1;
+        --_m_shift;
+    }
+    _m_mask = _n - 1;
+    _m_buckets = new index_type[_n];
+    for (std::size_t _b = 0; _b < _n; ++_b) {
+        _m_buckets[_b] = _S_npos;
+    }
+    _m_links = new slot_link[std::size_t(_m_capacity) + 1];
+    _m_links[_M_sentinel()] = {_M_sentinel(), _M_sentinel()};
+    if (_m_capacity != 0) {
+        _m_values = std::allocator_traits<value_allocator_type>::allocate(_m_alloc, _m_capacity);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_deallocate() -> void {
+    if (_m_values != nullptr) {
+        std::allocator_traits<value_allocator_type>::deallocate(_m_alloc, _m_values, _m_capacity);
+    }
+    delete[] _m_links;
+    delete[] _m_buckets;
+    _m_values = nullptr;
+    _m_links = nullptr;
+    _m_buckets = nullptr;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_assign(const self& _rhs, size_type _n) -> void {
+    // from the least recently used kept to the most, each one is put ahead
+    index_type _i = _rhs._M_sentinel();
+    for (size_type _j = 0; _j < _n; ++_j) {
+        _i = _rhs._m_links[_i].next;
+    }
+    for (size_type _j = 0; _j < _n; ++_j) {
+        put(_rhs._m_values[_i]);
+        _i = _rhs._m_links[_i].prev;
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_swap(self& _rhs) -> void {
+    std::swap(_m_values, _rhs._m_values);
+    std::swap(_m_links, _rhs._m_links);
+    std::swap(_m_buckets, _rhs._m_buckets);
+    std::swap(_m_mask, _rhs._m_mask);
+    std::swap(_m_shift, _rhs._m_shift);
+    std::swap(_m_capacity, _rhs._m_capacity);
+    std::swap(_m_size, _rhs._m_size);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_find(const key_type& _k) const -> std::size_t {
+    std::size_t _b = _M_home(_k);
+    while (_m_buckets[_b] != _S_npos && !(_ExtKey()(_m_values[_m_buckets[_b]]) == _k)) {
+        _b = (_b + 1) & _m_mask;
+    }
+    return _b;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_erase_bucket(std::size_t _b) -> void {
+    // a follower moves into the hole, unless its home is cyclically in (hole, follower]
+    std::size_t _hole = _b;
+    for (std::size_t _j = (_b + 1) & _m_mask; _m_buckets[_j] != _S_npos; _j = (_j + 1) & _m_mask) {
+        const std::size_t _home = _M_home(_ExtKey()(_m_values[_m_buckets[_j]]));
+        if (((_j - _home) & _m_mask) >= ((_j - _hole) & _m_mask)) {
+            _m_buckets[_hole] = _m_buckets[_j];
+            _hole = _j;
+        }
+    }
+    _m_buckets[_hole] = _S_npos;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_unlink(index_type _i) -> void {
+    const slot_link _l = _m_links[_i];
+    _m_links[_l.prev].next = _l.next;
+    _m_links[_l.next].prev = _l.prev;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_link_front(index_type _i) -> void {
+    const index_type _s = _M_sentinel();
+    const index_type _first = _m_links[_s].next;
+    _m_links[_i] = {_s, _first};
+    _m_links[_first].prev = _i;
+    _m_links[_s].next = _i;
+};
+
+/// public implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::operator=(const self& _rhs) -> self& {
+    if (&_rhs == this) return *this;
+    self _t(_rhs);
+    _M_swap(_t);
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::clear() -> void {
+    // emptying the buckets one by one would cut the probe sequences of the others
+    for (std::size_t _b = 0; _b <= _m_mask; ++_b) {
+        _m_buckets[_b] = _S_npos;
+    }
+    for (size_type _i = 0; _i < _m_size; ++_i) {
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _m_values + _i);
+    }
+    _m_links[_M_sentinel()] = {_M_sentinel(), _M_sentinel()};
+    _m_size = 0;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::resize(size_type _new_capacity) -> void {
+    if (_new_capacity == _m_capacity) { return; }
+    self _t(_new_capacity);
+    _t._M_assign(*this, _m_size < _new_capacity ? _m_size : _new_capacity);
+    _M_swap(_t);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::get(const key_type& _k) -> const_iterator {
+    const index_type _i = _m_buckets[_M_find(_k)];
+    if (_i == _S_npos) return cend();
+    if (_m_links[_M_sentinel()].next != _i) {
+        _M_unlink(_i);
+        _M_link_front(_i);
+    }
+    return _m_values + _i;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::peek(const key_type& _k) const -> const_iterator {
+    const index_type _i = _m_buckets[_M_find(_k)];
+    return _i == _S_npos ? cend() : _m_values + _i;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::put(const value_type& _v) -> void {
+    if (_m_capacity == 0) { return; }
+    const key_type& _k = _ExtKey()(_v);
+    std::size_t _b = _M_find(_k);
+    index_type _i = _m_buckets[_b];
+    if (_i != _S_npos) {
+        // replace in place, the key is unchanged so the bucket holds the same slot
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _m_values + _i);
+        std::allocator_traits<value_allocator_type>::construct(_m_alloc, _m_values + _i, _v);
+        _M_unlink(_i);
+        _M_link_front(_i);
+        return;
+    }
+    if (_m_size == _m_capacity) {
+        // the slot of the least recently used is reused, the erase may shift the bucket of %_k
+        _i = _m_links[_M_sentinel()].prev;
+        _M_erase_bucket(_M_find(_ExtKey()(_m_values[_i])));
+        std::allocator_traits<value_allocator_type>::destroy(_m_alloc, _m_values + _i);
+        _M_unlink(_i);
+        _b = _M_find(_k);
+    }
+    else {
+        _i = _m_size++;
+    }
+    std::allocator_traits<value_allocator_type>::construct(_m_alloc, _m_values + _i, _v);
+    _m_buckets[_b] = _i;
+    _M_link_front(_i);
+};
+
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A> auto
+operator<<(std::ostream& _os, const compact_lru_table<_K, _T, _Ek, _Ev, _H, _A>& _x) -> std::ostream& {
+    // from the most recently used
+    _os << '[';
+    const auto _s = _x._M_sentinel();
+    for (auto _i = _x._m_links[_s].next; _i != _s; _i = _x._m_links[_i].next) {
+        _os << _x._m_values[_i];
+        if (_x._m_links[_i].next != _s) {
+            _os << ", ";
+        }
+    }
+    return _os << ']';
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+compact_lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::check() const -> int {
+    if (_m_size > _m_capacity) {
+        return 1;
+    }
+    // the recency list goes through each occupied slot once
+    size_type _n = 0;
+    for (index_type _i = _m_links[_M_sentinel()].next, _p = _M_sentinel(); _i != _M_sentinel(); _p = _i, _i = _m_links[_i].next) {
+        if (_i >= _m_size || _m_links[_i].prev != _p || ++_n > _m_size) {
+            return 2;
+        }
+    }
+    if (_n != _m_size) {
+        return 2;
+    }
+    size_type _used = 0;
+    for (std::size_t _b = 0; _b <= _m_mask; ++_b) {
+        _used += _m_buckets[_b] != _S_npos;
+    }
+    if (_used != _m_size) {
+        return 3;
+    }
+    for (size_type _i = 0; _i < _m_size; ++_i) {
+        if (_m_buckets[_M_find(_ExtKey()(_m_values[_i]))] != _i) {
+            return 3;
+        }
+    }
+    return 0;
+};
+
+};
+
+#endif // _ASP_COMPACT_LRU_TABLE_HPP_
@@ -0,0 +1,373 @@
+#ifndef _ASP_CONCURRENT_LRU_HPP_
+#define _ASP_CONCURRENT_LRU_HPP_
+
+#include "lru_table.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace asp {
+
+template <typename _Key, typename _Tp,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>,
+ bool _BufferedReads = false
+> class concurrent_lru_map;
+
+/**
+ * @brief thread-safe LRU map, whose keys are striped over shards of @lru_table
+ * @details
+ *   each shard is an independent @lru_table holding a slice of the capacity, guarded by its own lock,
+ *   and shards are aligned to cache lines, so operations on different shards neither contend nor false-share.
+ *   the eviction is LRU within each shard.
+ *   the slices follow the load : %rebalance() gives each shard a share of the capacity
+ *   proportional to its (decayed) accesses, it runs every %_S_rebalance_period operations on a stripe of a shard,
+ *   by whichever thread gets there first.
+ *   values are copied out under the lock, no iterator escapes.
+ * @tparam _BufferedReads
+ *   false : %get() locks the shard exclusively to move the element to the front.
+ *   true : %get() only looks up the element under a shared lock of the shard,
+ *     and records it in a lossy read buffer (one of %_S_stripes per shard, picked by the thread),
+ *     a record is dropped if the buffer is full.
+ *     a full buffer is drained by the reader if it gets the exclusive lock by try_lock,
+ *     and every writer drains all buffers of the shard before its update,
+ *     so the recorded reads are replayed in order before any later write, and a recorded node is never freed.
+ *     readers of a hot shard scale, at the cost of an approximate LRU order.
+*/
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads>
+class concurrent_lru_map {
+public:
+    typedef concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads> self;
+    typedef lru_table<_Key, std::pair<const _Key, _Tp>, _select_0x, _select_1x, _Hash, _Alloc> lru_t;
+    typedef typename lru_t::key_type key_type;
+    typedef typename lru_t::value_type value_type;
+    typedef typename lru_t::mapped_type mapped_type;
+
+    struct shard_stats {
+        size_type _capacity;
+        size_type _size;
+        size_type _hit;
+        size_type _miss;
+    };
+
+/// (de)constructor
+    /**
+     * @param _shards the number of shards, rounded to a power of 2 no more than %_capacity.
+     *   0 for 4 times the hardware threads.
+    */
+    explicit concurrent_lru_map(size_type _capacity, size_type _shards = 0);
+    concurrent_lru_map(const self&) = delete;
+    self& operator=(const self&) = delete;
+    virtual ~concurrent_lru_map() { delete[] _m_shards; }
+
+    size_type size() const;
+    size_type capacity() const { return _m_capacity; }
+    bool empty() const { return size() == 0; }
+    void clear();
+    void resize(size_type _new_capacity);
+    // copy the value of %_k into %_m, @returns false if it's missed
+    bool get(const key_type& _k, mapped_type& _m);
+    void put(const value_type& _v);
+
+    size_type shard_count() const { return size_type(1) << _m_shard_bits; }
+    shard_stats stats(size_type _i) const;
+    size_type hits() const;
+    size_type misses() const;
+    // redistribute the capacity over shards by their accesses
+    void rebalance();
+
+    int check() const;
+
+protected:
+    typedef asp::conditional_t<_BufferedReads, std::shared_mutex, std::mutex> lock_type;
+    typedef asp::conditional_t<_BufferedReads, std::shared_lock<lock_type>, std::unique_lock<lock_type>> read_lock_type;
+    typedef typename lru_t::const_iterator lru_iterator;
+    typedef const typename lru_t::node_type* lru_node;
+
+    static constexpr const size_type _S_cache_line = 64;
+    // operations on a stripe between two rebalances
+    static constexpr const size_type _S_rebalance_period = 1 << 14;
+    static constexpr const size_type _S_stripes = 4;
+    static constexpr const size_type _S_read_buffer = _BufferedReads ? 32 : 1;
+
+    /**
+     * @brief counters and the read buffer of the threads mapped to it
+     * @details a reader takes the slot %_tail++ under the shared lock, if it's within %_head + %_S_read_buffer.
+     *   %_head is only accessed under the exclusive lock.
+    */
+    struct alignas(_S_cache_line) _Stripe {
+        std::atomic<size_type> _hit{0};
+        std::atomic<size_type> _miss{0};
+        std::atomic<size_type> _put{0};
+        std::atomic<size_type> _ops{0};
+        std::atomic<size_type> _tail{0};
+        size_type _head = 0;
+        std::atomic<lru_node> _buffer[_S_read_buffer] = {};
+    };
+    struct alignas(_S_cache_line) _Shard {
+        mutable lock_type _lock;
+        lru_t _l;
+        // accesses since the last rebalance, and decayed, accessed under %_m_rebalance_lock
+        size_type _seen = 0;
+        size_type _access = 0;
+        _Stripe _stripes[_S_stripes];
+
+        _Shard() : _l(0) {}
+    };
+
+    _Shard* _m_shards;
+    size_type _m_shard_bits = 0;
+    size_type _m_capacity;
+    std::mutex _m_rebalance_lock;
+
+    size_type _M_shard_of(const key_type& _k) const;
+    static _Stripe& _S_stripe(_Shard& _s);
+    // count an operation on %_s, @returns true if a rebalance is due
+    static bool _S_count(_Stripe& _s);
+    // record a read of %_i in the read buffer, @returns true if the buffer is full
+    static bool _S_record(_Stripe& _s, lru_iterator _i);
+    // replay the read buffers of %_s, called with its exclusive lock held
+    static void _S_drain(_Shard& _s);
+    void _M_try_rebalance();
+    // called with %_m_rebalance_lock held
+    void _M_rebalance();
+};
+
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads>
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::concurrent_lru_map(size_type _capacity, size_type _shards)
+ : _m_capacity(_capacity) {
+    if (_shards == 0) {
+        _shards = 4 * std::max(1u, std::thread::hardware_concurrency());
+    }
+    while ((size_type(1) << _m_shard_bits) < _shards) {
+        ++_m_shard_bits;
+    }
+    while (_m_shard_bits > 0 && (size_type(1) << _m_shard_bits) > _capacity) {
+        --_m_shard_bits;
+    }
+    _m_shards = new _Shard[shard_count()];
+    std::lock_guard<std::mutex> _g(_m_rebalance_lock);
+    _M_rebalance();
+};
+
+/// protected implement
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_M_shard_of(const key_type& _k) const -> size_type {
+    if (_m_shard_bits == 0) {
+        return 0;
+    }
+    // fibonacci hashing, so that the shard doesn't correlate with the bucket in @lru_table
+    const std::uint64_t _h = static_cast<std::uint64_t>(_Hash()(_k)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_type>(_h >> (64 - _m_shard_bits));
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_S_stripe(_Shard& _s) -> _Stripe& {
+    thread_local const size_type _s_stripe = std::hash<std::thread::id>()(std::this_thread::get_id()) % _S_stripes;
+    return _s._stripes[_s_stripe];
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_S_count(_Stripe& _s) -> bool {
+    return (_s._ops.fetch_add(1, std::memory_order_relaxed) + 1) % _S_rebalance_period == 0;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_S_record(_Stripe& _s, lru_iterator _i) -> bool {
+    const size_type _t = _s._tail.fetch_add(1, std::memory_order_relaxed);
+    // %_head is stable while the shared lock is held
+    if (_t - _s._head >= _S_read_buffer) {
+        return true;
+    }
+    _s._buffer[_t % _S_read_buffer].store(_i._ptr, std::memory_order_relaxed);
+    return _t - _s._head + 1 == _S_read_buffer;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_S_drain(_Shard& _s) -> void {
+    if (!_BufferedReads) {
+        return;
+    }
+    for (size_type _j = 0; _j < _S_stripes; ++_j) {
+        _Stripe& _r = _s._stripes[_j];
+        const size_type _t = _r._tail.load(std::memory_order_relaxed);
+        const size_type _last = _t - _r._head < _S_read_buffer ? _t : _r._head + _S_read_buffer;
+        for (size_type _i = _r._head; _i != _last; ++_i) {
+            if (lru_node _n = _r._buffer[_i % _S_read_buffer].exchange(nullptr, std::memory_order_relaxed)) {
+                _s._l.touch(lru_iterator(_n));
+            }
+        }
+        _r._head = _t;
+    }
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_M_try_rebalance() -> void {
+    std::unique_lock<std::mutex> _g(_m_rebalance_lock, std::try_to_lock);
+    if (_g.owns_lock()) {
+        _M_rebalance();
+    }
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::_M_rebalance() -> void {
+    const size_type _n = shard_count();
+    size_type _total = 0;
+    size_type* const _access = new size_type[_n];
+    size_type* const _target = new size_type[_n];
+    for (size_type _i = 0; _i < _n; ++_i) {
+        _Shard& _s = _m_shards[_i];
+        size_type _now = 0;
+        for (size_type _j = 0; _j < _S_stripes; ++_j) {
+            _now += _s._stripes[_j]._hit.load(std::memory_order_relaxed) + _s._stripes[_j]._miss.load(std::memory_order_relaxed)
+             + _s._stripes[_j]._put.load(std::memory_order_relaxed);
+        }
+        _s._access = _s._access / 2 + (_now - _s._seen);
+        _s._seen = _now;
+        _access[_i] = _s._access;
+        _total += _access[_i];
+    }
+    // a quarter of the capacity is reserved evenly, so that an idle shard can warm up again
+    const size_type _floor = _m_capacity / (4 * _n);
+    const size_type _share = _m_capacity - _floor * _n;
+    size_type _left = _m_capacity;
+    for (size_type _i = 0; _i < _n; ++_i) {
+        _target[_i] = _floor + (_total == 0 ? _share / _n : static_cast<size_type>(std::uint64_t(_share) * _access[_i] / _total));
+        _left -= _target[_i];
+    }
+    for (size_type _i = 0; _left > 0; _i = (_i + 1) % _n, --_left) {
+        ++_target[_i];
+    }
+    // shrink before grow, so that the total never exceeds the capacity
+    for (int _grow = 0; _grow < 2; ++_grow) {
+        for (size_type _i = 0; _i < _n; ++_i) {
+            std::lock_guard<lock_type> _g(_m_shards[_i]._lock);
+            if ((_target[_i] > _m_shards[_i]._l.capacity()) == bool(_grow)) {
+                _S_drain(_m_shards[_i]);
+                _m_shards[_i]._l.resize(_target[_i]);
+            }
+        }
+    }
+    delete[] _access;
+    delete[] _target;
+};
+
+/// public implement
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::size() const -> size_type {
+    size_type _n = 0;
+    for (size_type _i = 0; _i < shard_count(); ++_i) {
+        std::lock_guard<lock_type> _g(_m_shards[_i]._lock);
+        _n += _m_shards[_i]._l.size();
+    }
+    return _n;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::clear() -> void {
+    for (size_type _i = 0; _i < shard_count(); ++_i) {
+        std::lock_guard<lock_type> _g(_m_shards[_i]._lock);
+        _S_drain(_m_shards[_i]);
+        _m_shards[_i]._l.clear();
+    }
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::resize(size_type _new_capacity) -> void {
+    std::lock_guard<std::mutex> _g(_m_rebalance_lock);
+    _m_capacity = _new_capacity;
+    _M_rebalance();
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::get(const key_type& _k, mapped_type& _m) -> bool {
+    _Shard& _s = _m_shards[_M_shard_of(_k)];
+    _Stripe& _r = _S_stripe(_s);
+    bool _hit;
+    if (_BufferedReads) {
+        bool _full = false;
+        {
+            read_lock_type _g(_s._lock);
+            const lru_iterator _i = _s._l.peek(_k);
+            _hit = _i != _s._l.cend();
+            if (_hit) {
+                _m = _select_1x()(*_i);
+                _full = _S_record(_r, _i);
+            }
+        }
+        if (_full) {
+            std::unique_lock<lock_type> _g(_s._lock, std::try_to_lock);
+            if (_g.owns_lock()) { _S_drain(_s); }
+        }
+    }
+    else {
+        std::lock_guard<lock_type> _g(_s._lock);
+        const lru_iterator _i = _s._l.get(_k);
+        _hit = _i != _s._l.cend();
+        if (_hit) {
+            _m = _select_1x()(*_i);
+        }
+    }
+    (_hit ? _r._hit : _r._miss).fetch_add(1, std::memory_order_relaxed);
+    if (_S_count(_r)) {
+        _M_try_rebalance();
+    }
+    return _hit;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::put(const value_type& _v) -> void {
+    _Shard& _s = _m_shards[_M_shard_of(_select_0x()(_v))];
+    _Stripe& _r = _S_stripe(_s);
+    {
+        std::lock_guard<lock_type> _g(_s._lock);
+        _S_drain(_s);
+        _s._l.put(_v);
+    }
+    _r._put.fetch_add(1, std::memory_order_relaxed);
+    if (_S_count(_r)) {
+        _M_try_rebalance();
+    }
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::stats(size_type _i) const -> shard_stats {
+    std::lock_guard<lock_type> _g(_m_shards[_i]._lock);
+    const _Shard& _s = _m_shards[_i];
+    shard_stats _ret{_s._l.capacity(), _s._l.size(), 0, 0};
+    for (size_type _j = 0; _j < _S_stripes; ++_j) {
+        _ret._hit += _s._stripes[_j]._hit.load(std::memory_order_relaxed);
+        _ret._miss += _s._stripes[_j]._miss.load(std::memory_order_relaxed);
+    }
+    return _ret;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::hits() const -> size_type {
+    size_type _n = 0;
+    for (size_type _i = 0; _i < shard_count(); ++_i) {
+        _n += stats(_i)._hit;
+    }
+    return _n;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::misses() const -> size_type {
+    size_type _n = 0;
+    for (size_type _i = 0; _i < shard_count(); ++_i) {
+        _n += stats(_i)._miss;
+    }
+    return _n;
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::rebalance() -> void {
+    std::lock_guard<std::mutex> _g(_m_rebalance_lock);
+    _M_rebalance();
+};
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, bool _BufferedReads> auto
+concurrent_lru_map<_Key, _Tp, _Hash, _Alloc, _BufferedReads>::check() const -> int {
+    size_type _capacity = 0;
+    for (size_type _i = 0; _i < shard_count(); ++_i) {
+        const shard_stats _s = stats(_i);
+        if (_s._size > _s._capacity) {
+            return 1;
+        }
+        _capacity += _s._capacity;
+    }
+    return _capacity == _m_capacity ? 0 : 2;
+};
+
+};
+
+#endif // _ASP_CONCURRENT_LRU_HPP_
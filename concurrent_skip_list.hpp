@@ -0,0 +1,570 @@
+#ifndef _ASP_CONCURRENT_SKIP_LIST_HPP_
+#define _ASP_CONCURRENT_SKIP_LIST_HPP_
+
+#include "basic_param.hpp"
+#include "iterator.hpp"
+#include "associative_container_aux.hpp"
+#include "basic_io.hpp"
+#include "epoch.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_set>
+
+namespace asp {
+
+template <typename _Value> struct concurrent_skip_list_node;
+template <typename _Tp> struct concurrent_skip_list_const_iterator;
+template <typename _Value, typename _Alloc = std::allocator<_Value>> struct concurrent_skip_list_alloc;
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey,
+ typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>> class concurrent_skip_list;
+
+/**
+ * @brief node of @concurrent_skip_list
+ * @details %_next[_i] is the link on level %_i, whose lowest bit marks this node deleted on that level
+ *   (a marked link is never changed again). the links are allocated with the node height.
+*/
+template <typename _Value> struct concurrent_skip_list_node {
+    typedef concurrent_skip_list_node<_Value> self;
+    typedef std::atomic<std::uintptr_t> link_type;
+    using value_type = _Value;
+    using pointer = _Value*;
+    using reference = _Value&;
+
+    static constexpr const std::uintptr_t _S_mark = 1;
+
+    template <typename... _Args> concurrent_skip_list_node(link_type* _next, size_type _height, _Args&&... _args)
+     : _next(_next), _height(_height), _v(std::forward<_Args>(_args)...) {}
+
+    link_type* _next;
+    size_type _height;
+    /**
+     * @brief held by the inserting thread and by the list, see @concurrent_skip_list::_M_release
+    */
+    std::atomic<size_type> _ref{2};
+
+    value_type& val() { return _v; }
+    const value_type& val() const { return _v; }
+    value_type* valptr() { return &_v; }
+    const value_type* valptr() const { return &_v; }
+
+    static self* _S_ptr(std::uintptr_t _l) { return reinterpret_cast<self*>(_l & ~_S_mark); }
+    static std::uintptr_t _S_link(const self* _x) { return reinterpret_cast<std::uintptr_t>(_x); }
+    static bool _S_marked(std::uintptr_t _l) { return _l & _S_mark; }
+    // the next node on level %_i which isn't deleted (on that level)
+    self* _M_next(size_type _i = 0) const {
+        std::uintptr_t _l = _next[_i].load(std::memory_order_acquire);
+        self* _x = _S_ptr(_l);
+        while (_x != nullptr && _S_marked(_l = _x->_next[_i].load(std::memory_order_acquire))) {
+            _x = _S_ptr(_l);
+        }
+        return _x;
+    }
+
+private:
+    static_assert(alignof(link_type) > _S_mark, "the lowest bit of node address must be free");
+    value_type _v;
+};
+
+/**
+ * @brief iterator of @concurrent_skip_list, skips deleted nodes on the main list.
+ * @details dereference it in the scope of %concurrent_skip_list::guard() only.
+*/
+template <typename _Tp> struct concurrent_skip_list_const_iterator {
+    typedef asp::forward_iterator_tag iterator_category;
+    typedef concurrent_skip_list_const_iterator<_Tp> self;
+    typedef concurrent_skip_list_node<_Tp> node_type;
+    typedef typename node_type::value_type value_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+    typedef asp::difference_type difference_type;
+
+    const node_type* _ptr = nullptr;
+
+    concurrent_skip_list_const_iterator() {}
+    concurrent_skip_list_const_iterator(const node_type* _n) : _ptr(_n) {}
+    const value_type& operator*() const { return _ptr->val(); }
+    const value_type* operator->() const { return _ptr->valptr(); }
+    self& operator++() { _ptr = _ptr->_M_next(); return *this; }
+    self operator++(int) { self _ret = *this; _ptr = _ptr->_M_next(); return _ret; }
+    operator bool() const { return _ptr != nullptr; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._ptr == _y._ptr; }
+    friend bool operator!=(const self& _x, const self& _y) { return _x._ptr != _y._ptr; }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const concurrent_skip_list_const_iterator<_T>& _i);
+};
+
+template <typename _Value, typename _Alloc> struct concurrent_skip_list_alloc : public _Alloc {
+    typedef concurrent_skip_list_node<_Value> node_type;
+    typedef typename node_type::link_type link_type;
+    typedef _Alloc elt_allocator_type;
+    typedef std::allocator_traits<elt_allocator_type> elt_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<node_type> node_allocator_type;
+    typedef std::allocator_traits<node_allocator_type> node_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<link_type> link_allocator_type;
+    typedef std::allocator_traits<link_allocator_type> link_alloc_traits;
+
+    elt_allocator_type& _M_get_elt_allocator() { return *static_cast<elt_allocator_type*>(this); }
+    const elt_allocator_type& _M_get_elt_allocator() const { return *static_cast<const elt_allocator_type*>(this); }
+    node_allocator_type _M_get_node_allocator() const { return node_allocator_type(_M_get_elt_allocator()); }
+    link_allocator_type _M_get_link_allocator() const { return link_allocator_type(_M_get_elt_allocator()); }
+
+    template <typename... _Args> node_type* _M_allocate_node(size_type _height, _Args&&... _args) {
+        link_allocator_type _link_alloc = _M_get_link_allocator();
+        link_type* _next = std::addressof(*link_alloc_traits::allocate(_link_alloc, _height));
+        for (size_type _i = 0; _i < _height; ++_i) {
+            ::new (static_cast<void*>(_next + _i)) link_type(0);
+        }
+        node_allocator_type _node_alloc = _M_get_node_allocator();
+        node_type* _p = std::addressof(*node_alloc_traits::allocate(_node_alloc, 1));
+        node_alloc_traits::construct(_node_alloc, _p, _next, _height, std::forward<_Args>(_args)...);
+        return _p;
+    }
+    void _M_deallocate_node(node_type* _p) {
+        link_allocator_type _link_alloc = _M_get_link_allocator();
+        link_alloc_traits::deallocate(_link_alloc, _p->_next, _p->_height);
+        node_allocator_type _node_alloc = _M_get_node_allocator();
+        node_alloc_traits::destroy(_node_alloc, _p);
+        node_alloc_traits::deallocate(_node_alloc, _p, 1);
+    }
+};
+
+/**
+ * @brief lock-free skip list (Fraser; Herlihy & Shavit), with the interface of @skip_list
+ * @details
+ *   %find, %lower_bound, %upper_bound, %count, %insert, %erase and %clear may be called from any thread.
+ *   - the links are updated by CAS, an insertion links the main list first (which is the linearization point),
+ *     and then the sub lists from bottom up.
+ *   - an erasure marks the links of the node from top down (logical deletion, the mark on the main list
+ *     decides the winner among concurrent erasures), and the searches passing by unlink it (physical deletion).
+ *   - lookups are wait-free, they skip marked nodes without unlinking them.
+ *   - nodes are reclaimed by @epoch_domain, every public member function is a critical section,
+ *     hold %guard() to keep iterators (and the values they refer to) valid across calls.
+ *   %_UniqueKey must be true, equal keys can't be ordered among concurrent insertions.
+ *   %size() is exact only when there is no concurrent writer.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+class concurrent_skip_list : public concurrent_skip_list_alloc<_Value, _Alloc> {
+    static_assert(_UniqueKey, "concurrent_skip_list supports unique keys only");
+public:
+    typedef concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc> self;
+    typedef concurrent_skip_list_alloc<_Value, _Alloc> base;
+    typedef typename base::elt_allocator_type elt_allocator_type;
+    typedef typename base::node_type node_type;
+    typedef typename base::link_type link_type;
+
+    typedef _Key key_type;
+    typedef _Comp key_compare;
+    typedef typename node_type::value_type value_type;
+
+    typedef concurrent_skip_list_const_iterator<value_type> iterator;
+    typedef concurrent_skip_list_const_iterator<value_type> const_iterator;
+
+    typedef std::pair<iterator, bool> ireturn_type;
+    typedef asso_container::type_traits<value_type, _UniqueKey> _ContainerTypeTraits;
+
+    typedef typename _ContainerTypeTraits::insert_status insert_status;
+    typedef typename _ContainerTypeTraits::ext_iterator ext_iterator;
+    typedef typename _ContainerTypeTraits::ext_value ext_value;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef _ExtKey ext_key;
+
+    struct _Reclaim {
+        self* _m_list;
+        void operator()(node_type* _p) const { _m_list->_M_deallocate_node(_p); }
+    };
+    typedef epoch_domain<node_type, _Reclaim> domain_type;
+    typedef typename domain_type::guard guard_type;
+
+    static constexpr const size_type _S_max_height = 32;
+
+    // %_m_head[_i] : the first link on level %_i
+    link_type _m_head[_S_max_height];
+    // no node is higher than %_m_height
+    std::atomic<size_type> _m_height{1};
+    std::atomic<size_type> _m_element_count{0};
+    _Comp _m_key_compare;
+    mutable domain_type _m_domain;
+
+    static key_type _S_key(const node_type* _x) { return _ExtKey()(_x->val()); }
+    static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
+
+    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const concurrent_skip_list<_K, _V, _EK, _UK, _C, _A>& _sl);
+public:
+    concurrent_skip_list();
+    concurrent_skip_list(const self&) = delete;
+    self& operator=(const self&) = delete;
+    virtual ~concurrent_skip_list();
+
+    /**
+     * @brief critical section of the calling thread, iterators stay valid until it's destroyed.
+    */
+    guard_type guard() const { return guard_type(_m_domain); }
+
+    const_iterator begin() const { guard_type _g(_m_domain); return const_iterator(_M_first()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(nullptr); }
+    const_iterator cend() const { return end(); }
+    size_type size() const { return _m_element_count.load(std::memory_order_relaxed); }
+    bool empty() const { guard_type _g(_m_domain); return _M_first() == nullptr; }
+
+    const_iterator find(const key_type& _k) const;
+    size_type count(const key_type& _k) const { return find(_k) != cend(); }
+    // erase the elements one by one, concurrent insertions may survive
+    void clear();
+    ireturn_type insert(const value_type& _v);
+    size_type erase(const key_type& _k);
+
+    const_iterator lower_bound(const key_type& _k) const { guard_type _g(_m_domain); return const_iterator(_M_bound(_k, false)); }
+    const_iterator upper_bound(const key_type& _k) const { guard_type _g(_m_domain); return const_iterator(_M_bound(_k, true)); }
+
+    // used for test, no concurrent writer
+    int check() const;
+
+protected:
+    // return _x < _y
+    bool _M_key_compare(const key_type& _x, const key_type& _y) const { return _m_key_compare(_x, _y); }
+    // the first node which isn't deleted on the main list
+    const node_type* _M_first() const;
+    /**
+     * @brief the first node not less (greater if %_upper) than %_k, without modifying links.
+    */
+    const node_type* _M_bound(const key_type& _k, bool _upper) const;
+    /**
+     * @brief find the predecessors and successors of %_k on each level below %_m_height, unlink marked nodes on the way.
+     * @details %_preds[_i] is the link array of the last node less than %_k on level %_i (or %_m_head),
+     *   %_succs[_i] is the next node of %_preds[_i] on level %_i, which is not marked when it's read.
+    */
+    void _M_search(const key_type& _k, link_type** _preds, node_type** _succs);
+    /**
+     * @brief unlink all marked nodes keyed %_k on every level.
+     * @details like %_M_search, but also walks past the nodes equal to %_k,
+     *   so a marked node behind an equal one is unlinked as well.
+    */
+    void _M_unlink(const key_type& _k);
+    /**
+     * @brief drop a reference of %_x, retire it when both references are dropped.
+     * @details one reference is held by the inserting thread, until it stops linking %_x,
+     *   the other is held by the list, until the erasing thread marked and unlinked %_x.
+     *   whoever comes last runs after every link of %_x is done and undone, so %_x is unreachable.
+    */
+    void _M_release(node_type* _x);
+    void _M_raise_height(size_type _h);
+
+private:
+    size_type _M_random_height() const;
+};
+
+/// concurrent_skip_list protected implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_first() const -> const node_type* {
+    const node_type* _x = node_type::_S_ptr(_m_head[0].load(std::memory_order_acquire));
+    while (_x != nullptr && node_type::_S_marked(_x->_next[0].load(std::memory_order_acquire))) {
+        _x = node_type::_S_ptr(_x->_next[0].load(std::memory_order_acquire));
+    }
+    return _x;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_bound(const key_type& _k, bool _upper) const -> const node_type* {
+    const link_type* _pred = _m_head;
+    const node_type* _curr = nullptr;
+    for (int _i = _m_height.load(std::memory_order_acquire) - 1; _i >= 0; --_i) {
+        _curr = node_type::_S_ptr(_pred[_i].load(std::memory_order_acquire));
+        while (_curr != nullptr) {
+            const std::uintptr_t _succ = _curr->_next[_i].load(std::memory_order_acquire);
+            if (node_type::_S_marked(_succ)) {
+                _curr = node_type::_S_ptr(_succ);
+                continue;
+            }
+            if (_upper ? _M_key_compare(_k, _S_key(_curr)) : !_M_key_compare(_S_key(_curr), _k)) {
+                break;
+            }
+            _pred = _curr->_next;
+            _curr = node_type::_S_ptr(_succ);
+        }
+    }
+    return _curr;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_search(const key_type& _k, link_type** _preds, node_type** _succs) -> void {
+retry:
+    link_type* _pred = _m_head;
+    for (int _i = _m_height.load(std::memory_order_acquire) - 1; _i >= 0; --_i) {
+        node_type* _curr = node_type::_S_ptr(_pred[_i].load(std::memory_order_acquire));
+        while (_curr != nullptr) {
+            const std::uintptr_t _succ = _curr->_next[_i].load(std::memory_order_acquire);
+            if (node_type::_S_marked(_succ)) {
+                // fails if %_pred is marked or changed
+                std::uintptr_t _expected = node_type::_S_link(_curr);
+                if (!_pred[_i].compare_exchange_strong(_expected, _succ & ~node_type::_S_mark)) {
+                    goto retry;
+                }
+                _curr = node_type::_S_ptr(_succ);
+                continue;
+            }
+            if (!_M_key_compare(_S_key(_curr), _k)) {
+                break;
+            }
+            _pred = _curr->_next;
+            _curr = node_type::_S_ptr(_succ);
+        }
+        _preds[_i] = _pred;
+        _succs[_i] = _curr;
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_unlink(const key_type& _k) -> void {
+retry:
+    link_type* _start = _m_head; // the last node less than %_k
+    for (int _i = _m_height.load(std::memory_order_acquire) - 1; _i >= 0; --_i) {
+        link_type* _pred = _start;
+        node_type* _curr = node_type::_S_ptr(_pred[_i].load(std::memory_order_acquire));
+        while (_curr != nullptr) {
+            const std::uintptr_t _succ = _curr->_next[_i].load(std::memory_order_acquire);
+            if (node_type::_S_marked(_succ)) {
+                std::uintptr_t _expected = node_type::_S_link(_curr);
+                if (!_pred[_i].compare_exchange_strong(_expected, _succ & ~node_type::_S_mark)) {
+                    goto retry;
+                }
+                _curr = node_type::_S_ptr(_succ);
+                continue;
+            }
+            if (_M_key_compare(_k, _S_key(_curr))) {
+                break;
+            }
+            if (_M_key_compare(_S_key(_curr), _k)) {
+                _start = _curr->_next;
+            }
+            _pred = _curr->_next;
+            _curr = node_type::_S_ptr(_succ);
+        }
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_release(node_type* _x) -> void {
+    if (_x->_ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _m_domain._M_retire(_x);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_raise_height(size_type _h) -> void {
+    size_type _cur = _m_height.load();
+    while (_cur < _h && !_m_height.compare_exchange_weak(_cur, _h));
+};
+
+/// concurrent_skip_list private implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_random_height() const -> size_type {
+    // xorshift per thread, the height is geometric with p = 1/2
+    thread_local std::uint32_t _s_seed = 0;
+    if (_s_seed == 0) {
+        _s_seed = static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+    }
+    _s_seed ^= _s_seed << 13;
+    _s_seed ^= _s_seed >> 17;
+    _s_seed ^= _s_seed << 5;
+    size_type _height = 1;
+    for (std::uint32_t _r = _s_seed; (_r & 1) && _height < _S_max_height; _r >>= 1) {
+        ++_height;
+    }
+    return _height;
+};
+
+/// concurrent_skip_list public implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::concurrent_skip_list()
+ : _m_domain(_Reclaim{this}) {
+    for (size_type _i = 0; _i < _S_max_height; ++_i) {
+        _m_head[_i].store(0, std::memory_order_relaxed);
+    }
+}
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::~concurrent_skip_list() {
+    // marked nodes still on the main list are reclaimed here, the unlinked ones by %_m_domain
+    node_type* _x = node_type::_S_ptr(_m_head[0].load());
+    while (_x != nullptr) {
+        node_type* _next = node_type::_S_ptr(_x->_next[0].load());
+        this->_M_deallocate_node(_x);
+        _x = _next;
+    }
+}
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+find(const key_type& _k) const -> const_iterator {
+    guard_type _g(_m_domain);
+    const node_type* _x = _M_bound(_k, false);
+    return (_x == nullptr || _M_key_compare(_k, _S_key(_x))) ? cend() : const_iterator(_x);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+clear() -> void {
+    guard_type _g(_m_domain);
+    for (const node_type* _x = _M_first(); _x != nullptr; _x = _M_first()) {
+        erase(_S_key(_x));
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+insert(const value_type& _v) -> ireturn_type {
+    guard_type _g(_m_domain);
+    const key_type _k = _S_key(_v);
+    const size_type _height = _M_random_height();
+    _M_raise_height(_height);
+    link_type* _preds[_S_max_height];
+    node_type* _succs[_S_max_height];
+    node_type* _x = nullptr;
+    for (;;) {
+        _M_search(_k, _preds, _succs);
+        if (_succs[0] != nullptr && !_M_key_compare(_k, _S_key(_succs[0]))) {
+            if (_x != nullptr) {
+                this->_M_deallocate_node(_x); // never published
+            }
+            return std::make_pair(iterator(_succs[0]), false);
+        }
+        if (_x == nullptr) {
+            _x = this->_M_allocate_node(_height, _v);
+        }
+        for (size_type _i = 0; _i < _height; ++_i) {
+            _x->_next[_i].store(node_type::_S_link(_succs[_i]), std::memory_order_relaxed);
+        }
+        std::uintptr_t _expected = node_type::_S_link(_succs[0]);
+        if (_preds[0][0].compare_exchange_strong(_expected, node_type::_S_link(_x))) {
+            break;
+        }
+    }
+    _m_element_count.fetch_add(1, std::memory_order_relaxed);
+    // link the sub lists, stop once %_x is marked by an erasure
+    for (size_type _i = 1; _i < _height; ++_i) {
+        for (;;) {
+            std::uintptr_t _old = _x->_next[_i].load();
+            if (node_type::_S_marked(_old)) { goto linked; }
+            if (node_type::_S_ptr(_old) != _succs[_i] &&
+             !_x->_next[_i].compare_exchange_strong(_old, node_type::_S_link(_succs[_i]))) {
+                goto linked; // only marking changes it
+            }
+            std::uintptr_t _expected = node_type::_S_link(_succs[_i]);
+            if (_preds[_i][_i].compare_exchange_strong(_expected, node_type::_S_link(_x))) {
+                break;
+            }
+            _M_search(_k, _preds, _succs);
+            if (_succs[0] != _x) { goto linked; } // erased and unlinked
+        }
+    }
+linked:
+    if (node_type::_S_marked(_x->_next[0].load())) {
+        _M_unlink(_k);
+    }
+    iterator _ret(_x);
+    _M_release(_x);
+    return std::make_pair(_ret, true);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+erase(const key_type& _k) -> size_type {
+    guard_type _g(_m_domain);
+    link_type* _preds[_S_max_height];
+    node_type* _succs[_S_max_height];
+    _M_search(_k, _preds, _succs);
+    node_type* const _x = _succs[0];
+    if (_x == nullptr || _M_key_compare(_k, _S_key(_x))) {
+        return 0;
+    }
+    for (size_type _i = _x->_height - 1; _i > 0; --_i) {
+        std::uintptr_t _l = _x->_next[_i].load();
+        while (!node_type::_S_marked(_l) && !_x->_next[_i].compare_exchange_weak(_l, _l | node_type::_S_mark));
+    }
+    std::uintptr_t _l = _x->_next[0].load();
+    for (;;) {
+        if (node_type::_S_marked(_l)) {
+            return 0; // erased by another thread
+        }
+        if (_x->_next[0].compare_exchange_weak(_l, _l | node_type::_S_mark)) {
+            break;
+        }
+    }
+    _m_element_count.fetch_sub(1, std::memory_order_relaxed);
+    _M_unlink(_k);
+    _M_release(_x);
+    return 1;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto concurrent_skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> int {
+    /**
+     * @returns 0 = normal;
+     * 1 = duplicate value in unique container;
+     * 2 = not in order;
+     * 3 = a marked node on the main list;
+     * 4 = the number of nodes on the main list is not equal to %_m_element_count;
+     * 5 = node's height is less than the list it's on, or greater than %_m_height;
+     * 6 = a node on a sub list isn't on the main list.
+    */
+    std::unordered_set<const node_type*> _main;
+    const size_type _height = _m_height.load();
+    for (size_type _i = 0; _i < _S_max_height; ++_i) {
+        const node_type* _p = node_type::_S_ptr(_m_head[_i].load());
+        const node_type* _last = nullptr;
+        size_type _count = 0;
+        for (; _p != nullptr; _last = _p, _p = node_type::_S_ptr(_p->_next[_i].load())) {
+            if (_p->_height <= _i || _p->_height > _height) {
+                return 5;
+            }
+            if (_last != nullptr) {
+                if (!_M_key_compare(_S_key(_last), _S_key(_p))) {
+                    return _M_key_compare(_S_key(_p), _S_key(_last)) ? 2 : 1;
+                }
+            }
+            if (_i == 0) {
+                if (node_type::_S_marked(_p->_next[0].load())) {
+                    return 3;
+                }
+                _main.insert(_p);
+            }
+            else if (!_main.count(_p)) {
+                return 6;
+            }
+            ++_count;
+        }
+        if (_i == 0 && _count != size()) {
+            return 4;
+        }
+    }
+    return 0;
+};
+
+
+/// output implement
+template <typename _T> std::ostream& operator<<(std::ostream& os, const concurrent_skip_list_const_iterator<_T>& _i) {
+    if (_i)
+        os << obj_string::_M_obj_2_string(*_i);
+    else
+        os << "null";
+    return os;
+}
+template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
+std::ostream& operator<<(std::ostream& os, const concurrent_skip_list<_K, _V, _EK, _UK, _C, _A>& _sl) {
+    auto _g = _sl.guard();
+    os << '[';
+    for (auto p = _sl.cbegin(); p != _sl.cend();) {
+        os << p;
+        if (++p != _sl.cend()) {
+            os << ", ";
+        }
+    }
+    os << ']';
+    return os;
+}
+
+};
+
+#endif  // _ASP_CONCURRENT_SKIP_LIST_HPP_
@@ -0,0 +1,195 @@
+#ifndef _ASP_EPOCH_HPP_
+#define _ASP_EPOCH_HPP_
+
+#include "basic_param.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace asp {
+
+template <typename _Node, typename _Reclaim> class epoch_domain;
+template <typename _Domain> class epoch_guard;
+
+/**
+ * @brief epoch based memory reclamation (Fraser)
+ * @details
+ *   a thread %_M_enter()s a critical section before it reads shared nodes, and %_M_leave()s afterwards.
+ *   a node unlinked from the shared structure is %_M_retire()d with the current global epoch,
+ *   and reclaimed by %_Reclaim once the global epoch has advanced twice since :
+ *     the global epoch only advances when every thread in a critical section has observed it,
+ *     so no thread can still hold a pointer to the node by then.
+ *   critical sections nest, and each thread leases a record of the domain on its first access,
+ *   which is identified by std::thread::id (a later thread with the same id reuses it).
+ *   records and the nodes left in them are freed with the domain.
+ * @tparam _Reclaim %void operator()(_Node*) const, frees a node
+*/
+template <typename _Node, typename _Reclaim> class epoch_domain {
+public:
+    typedef epoch_domain<_Node, _Reclaim> self;
+    typedef epoch_guard<self> guard;
+
+    explicit epoch_domain(const _Reclaim& _r) : _m_reclaim(_r), _m_id(_S_next_id()) {}
+    epoch_domain(const self&) = delete;
+    self& operator=(const self&) = delete;
+    ~epoch_domain();
+
+    void _M_enter();
+    void _M_leave();
+    // called in a critical section, after %_p is unreachable from the shared structure
+    void _M_retire(_Node* _p);
+
+protected:
+    // the thread tries to advance the global epoch every %_S_retire_threshold retirements
+    static constexpr const size_type _S_retire_threshold = 64;
+
+    struct _Record {
+        std::atomic<std::uint64_t> _epoch; // (observed epoch << 1) | in critical section
+        std::thread::id _owner;
+        _Record* _next = nullptr;
+        size_type _nest = 0;
+        size_type _retire_count = 0;
+        // %_retired[_e % 3] holds the nodes retired in epoch %_retired_epoch[_e % 3]
+        std::uint64_t _retired_epoch[3] = {0, 0, 0};
+        std::vector<_Node*> _retired[3];
+
+        _Record() : _epoch(0), _owner(std::this_thread::get_id()) {}
+    };
+
+    _Reclaim _m_reclaim;
+    const std::uint64_t _m_id;
+    std::atomic<std::uint64_t> _m_global{0};
+    std::atomic<_Record*> _m_records{nullptr};
+
+    static std::uint64_t _S_next_id() {
+        static std::atomic<std::uint64_t> _s_id{0};
+        return ++_s_id;
+    }
+    // the record leased by the calling thread
+    _Record* _M_record();
+    // advance the global epoch if every thread in a critical section has observed it
+    void _M_try_advance();
+    // reclaim the nodes of %_r retired at least two epochs before %_g
+    void _M_collect(_Record* _r, std::uint64_t _g);
+    void _M_free(std::vector<_Node*>& _l);
+};
+
+/**
+ * @brief critical section of @epoch_domain in a scope
+*/
+template <typename _Domain> class epoch_guard {
+public:
+    explicit epoch_guard(_Domain& _d) : _m_domain(&_d) { _m_domain->_M_enter(); }
+    epoch_guard(epoch_guard&& _g) : _m_domain(_g._m_domain) { _g._m_domain = nullptr; }
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+    ~epoch_guard() { if (_m_domain != nullptr) _m_domain->_M_leave(); }
+
+private:
+    _Domain* _m_domain;
+};
+
+
+/// epoch_domain implement
+template <typename _Node, typename _Reclaim> epoch_domain<_Node, _Reclaim>::~epoch_domain() {
+    _Record* _r = _m_records.load();
+    while (_r != nullptr) {
+        for (size_type _i = 0; _i < 3; ++_i) {
+            _M_free(_r->_retired[_i]);
+        }
+        _Record* _next = _r->_next;
+        delete _r;
+        _r = _next;
+    }
+};
+
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_record() -> _Record* {
+    // one-entry cache per thread, keyed by the id of domain (addresses may be reused)
+    thread_local std::uint64_t _s_domain = 0;
+    thread_local _Record* _s_record = nullptr;
+    if (_s_domain == _m_id) {
+        return _s_record;
+    }
+    const std::thread::id _self = std::this_thread::get_id();
+    _Record* _r = _m_records.load();
+    for (; _r != nullptr; _r = _r->_next) {
+        if (_r->_owner == _self) { break; }
+    }
+    if (_r == nullptr) {
+        _r = new _Record();
+        _Record* _head = _m_records.load();
+        do {
+            _r->_next = _head;
+        } while (!_m_records.compare_exchange_weak(_head, _r));
+    }
+    _s_domain = _m_id;
+    _s_record = _r;
+    return _r;
+};
+
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_enter() -> void {
+    _Record* const _r = _M_record();
+    if (_r->_nest++ > 0) { return; }
+    std::uint64_t _g = _m_global.load();
+    for (;;) {
+        _r->_epoch.store((_g << 1) | 1);
+        // the epoch must be published before the global epoch is re-read
+        const std::uint64_t _h = _m_global.load();
+        if (_h == _g) { break; }
+        _g = _h;
+    }
+    _M_collect(_r, _g);
+};
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_leave() -> void {
+    _Record* const _r = _M_record();
+    if (--_r->_nest > 0) { return; }
+    _r->_epoch.store(_r->_epoch.load(std::memory_order_relaxed) & ~std::uint64_t(1), std::memory_order_release);
+};
+
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_retire(_Node* _p) -> void {
+    _Record* const _r = _M_record();
+    const std::uint64_t _g = _m_global.load();
+    const size_type _s = _g % 3;
+    if (_r->_retired_epoch[_s] != _g) {
+        // retired at %_g - 3 or before
+        _M_free(_r->_retired[_s]);
+        _r->_retired_epoch[_s] = _g;
+    }
+    _r->_retired[_s].push_back(_p);
+    if (++_r->_retire_count >= _S_retire_threshold) {
+        _r->_retire_count = 0;
+        _M_try_advance();
+        _M_collect(_r, _m_global.load());
+    }
+};
+
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_try_advance() -> void {
+    std::uint64_t _g = _m_global.load();
+    for (_Record* _r = _m_records.load(); _r != nullptr; _r = _r->_next) {
+        const std::uint64_t _e = _r->_epoch.load();
+        if ((_e & 1) && (_e >> 1) != _g) {
+            return;
+        }
+    }
+    _m_global.compare_exchange_strong(_g, _g + 1);
+};
+
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_collect(_Record* _r, std::uint64_t _g) -> void {
+    for (size_type _i = 0; _i < 3; ++_i) {
+        if (!_r->_retired[_i].empty() && _r->_retired_epoch[_i] + 2 <= _g) {
+            _M_free(_r->_retired[_i]);
+        }
+    }
+};
+template <typename _Node, typename _Reclaim> auto epoch_domain<_Node, _Reclaim>::_M_free(std::vector<_Node*>& _l) -> void {
+    for (_Node* _p : _l) {
+        _m_reclaim(_p);
+    }
+    _l.clear();
+};
+
+};
+
+#endif // _ASP_EPOCH_HPP_
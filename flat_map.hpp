@@ -0,0 +1,93 @@
+#ifndef _ASP_FLAT_MAP_HPP_
+#define _ASP_FLAT_MAP_HPP_
+
+#include <functional>
+
+#include "basic_param.hpp"
+#include "flat_tree.hpp"
+#include "frozen_tree.hpp"
+
+namespace asp {
+
+/**
+ * @brief sorted @vector based map with the interface of ordered_map, see @flat_tree
+ * @tparam _Search @flat_branchless_search (default) or @flat_binary_search
+*/
+template <typename _Key, typename _Tp,
+ typename _Compare = std::less<_Key>,
+ typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>,
+ typename _Search = flat_branchless_search
+> class flat_map;
+
+template <typename _Key, typename _Tp, typename _Compare, typename _Alloc, typename _Search>
+class flat_map {
+    typedef flat_map<_Key, _Tp, _Compare, _Alloc, _Search> self;
+    typedef flat_tree<_Key, std::pair<const _Key, _Tp>, _select_0x, true, _Compare, _Alloc, _Search> map_ft;
+    map_ft _r;
+public:
+    typedef typename map_ft::key_type key_type;
+    typedef typename map_ft::value_type value_type;
+    typedef typename map_ft::mapped_type mapped_type;
+    typedef typename map_ft::key_compare key_compare;
+    typedef typename map_ft::iterator iterator;
+    typedef typename map_ft::const_iterator const_iterator;
+    typedef typename map_ft::ireturn_type ireturn_type;
+    typedef typename map_ft::insert_status insert_status;
+    typedef typename map_ft::ext_iterator ext_iterator;
+    typedef typename map_ft::ext_key ext_key;
+    typedef typename map_ft::ext_value ext_value;
+    typedef typename map_ft::allocator_type allocator_type;
+
+/// (de)constructor
+    flat_map() = default;
+    flat_map(const self& _x) : _r(_x._r) {}
+    virtual ~flat_map() = default;
+    
+/// implement
+    size_type size() const { return _r.size(); }
+    bool empty() const { return _r.empty(); }
+    iterator begin() { return _r.begin(); }
+    iterator end() { return _r.end(); }
+    const_iterator cbegin() const { return _r.cbegin(); }
+    const_iterator cend() const { return _r.cend(); }
+    ireturn_type insert(const value_type& _v) { return _r.insert(_v); }
+    ireturn_type set(const key_type& _k, const mapped_type& _m) { return _r.insert(value_type(_k, _m)); }
+    size_type erase(const key_type& _k) { return _r.erase(_k); }
+    size_type count(const key_type& _k) const { return _r.count(_k); }
+    void clear() { _r.clear(); }
+    // insert through the insert buffer, see @flat_tree::insert_buffered
+    bool insert_buffered(const value_type& _v) { return _r.insert_buffered(_v); }
+    void flush() { _r.flush(); }
+    void reserve(size_type _n) { _r.reserve(_n); }
+    // an immutable sorted copy for read-only lookups, see @frozen_tree
+    template <typename _Layout = eytzinger_layout> frozen_tree<key_type, value_type, ext_key, true, key_compare, allocator_type, _Layout> freeze() const {
+        return frozen_tree<key_type, value_type, ext_key, true, key_compare, allocator_type, _Layout>(cbegin(), cend(), size());
+    }
+    iterator find(const key_type& _k) { return _r.find(_k); }
+    const_iterator find(const key_type& _k) const { return _r.find(_k); }
+    iterator lower_bound(const key_type& _k) { return _r.lower_bound(_k); }
+    const_iterator lower_bound(const key_type& _k) const { return _r.lower_bound(_k); }
+    iterator upper_bound(const key_type& _k) { return _r.upper_bound(_k); }
+    const_iterator upper_bound(const key_type& _k) const { return _r.upper_bound(_k); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k) { return _r.equal_range(_k); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const { return _r.equal_range(_k); }
+#ifdef _CONTAINER_CHECK_
+    int check() const { return _r.check(); }
+#endif // _CONTAINER_CHECK_
+
+/// output
+    template <typename _K, typename _T, typename _C, typename _A, typename _S>
+     friend std::ostream& operator<<(std::ostream& os, const flat_map<_K, _T, _C, _A, _S>& _um);
+    // friend std::ostream& operator<<(std::ostream& os, const const_iterator& _i);
+};
+
+template <typename _Key, typename _Tp, typename _Comp, typename _Alloc, typename _Search> auto
+operator<<(std::ostream& os, const flat_map<_Key, _Tp, _Comp, _Alloc, _Search>& _um)
+-> std::ostream& {
+    os << _um._r;
+    return os;
+};
+
+};
+
+#endif // _ASP_FLAT_MAP_HPP_
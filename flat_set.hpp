@@ -0,0 +1,93 @@
+#ifndef _ASP_FLAT_SET_HPP_
+#define _ASP_FLAT_SET_HPP_
+
+#include <functional>
+
+#include "basic_param.hpp"
+#include "flat_tree.hpp"
+#include "frozen_tree.hpp"
+
+namespace asp {
+
+/**
+ * @brief sorted @vector based set with the interface of ordered_set, see @flat_tree
+ * @tparam _Search @flat_branchless_search (default) or @flat_binary_search
+*/
+template <typename _Tp,
+ typename _Compare = std::less<_Tp>,
+ typename _Alloc = std::allocator<_Tp>,
+ typename _Search = flat_branchless_search
+> class flat_set;
+
+template <typename _Tp, typename _Compare, typename _Alloc, typename _Search>
+class flat_set {
+    typedef flat_set<_Tp, _Compare, _Alloc, _Search> self;
+    typedef flat_tree<_Tp, _Tp, _select_self, true, _Compare, _Alloc, _Search> set_ft;
+    set_ft _r;
+public:
+    typedef typename set_ft::key_type key_type;
+    typedef typename set_ft::value_type value_type;
+    typedef typename set_ft::mapped_type mapped_type;
+    typedef typename set_ft::key_compare key_compare;
+    typedef typename set_ft::iterator iterator;
+    typedef typename set_ft::const_iterator const_iterator;
+    typedef typename set_ft::ireturn_type ireturn_type;
+    typedef typename set_ft::insert_status insert_status;
+    typedef typename set_ft::ext_iterator ext_iterator;
+    typedef typename set_ft::ext_key ext_key;
+    typedef typename set_ft::ext_value ext_value;
+    typedef typename set_ft::allocator_type allocator_type;
+
+/// (de)constructor
+    flat_set() = default;
+    flat_set(const self& _x) : _r(_x._r) {}
+    virtual ~flat_set() = default;
+    
+/// implement
+    size_type size() const { return _r.size(); }
+    bool empty() const { return _r.empty(); }
+    iterator begin() { return _r.begin(); }
+    iterator end() { return _r.end(); }
+    const_iterator cbegin() const { return _r.cbegin(); }
+    const_iterator cend() const { return _r.cend(); }
+    ireturn_type insert(const value_type& _v) { return _r.insert(_v); }
+    ireturn_type set(const key_type& _k, const mapped_type& _m) { return _r.insert(value_type(_k, _m)); }
+    size_type erase(const key_type& _k) { return _r.erase(_k); }
+    size_type count(const key_type& _k) const { return _r.count(_k); }
+    void clear() { _r.clear(); }
+    // insert through the insert buffer, see @flat_tree::insert_buffered
+    bool insert_buffered(const value_type& _v) { return _r.insert_buffered(_v); }
+    void flush() { _r.flush(); }
+    void reserve(size_type _n) { _r.reserve(_n); }
+    // an immutable sorted copy for read-only lookups, see @frozen_tree
+    template <typename _Layout = eytzinger_layout> frozen_tree<key_type, value_type, ext_key, true, key_compare, allocator_type, _Layout> freeze() const {
+        return frozen_tree<key_type, value_type, ext_key, true, key_compare, allocator_type, _Layout>(cbegin(), cend(), size());
+    }
+    iterator find(const key_type& _k) { return _r.find(_k); }
+    const_iterator find(const key_type& _k) const { return _r.find(_k); }
+    iterator lower_bound(const key_type& _k) { return _r.lower_bound(_k); }
+    const_iterator lower_bound(const key_type& _k) const { return _r.lower_bound(_k); }
+    iterator upper_bound(const key_type& _k) { return _r.upper_bound(_k); }
+    const_iterator upper_bound(const key_type& _k) const { return _r.upper_bound(_k); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k) { return _r.equal_range(_k); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const { return _r.equal_range(_k); }
+#ifdef _CONTAINER_CHECK_
+    int check() const { return _r.check(); }
+#endif // _CONTAINER_CHECK_
+
+/// output
+    template <typename _T, typename _C, typename _A, typename _S>
+     friend std::ostream& operator<<(std::ostream& os, const flat_set<_T, _C, _A, _S>& _um);
+    // friend std::ostream& operator<<(std::ostream& os, const const_iterator& _i);
+};
+
+template <typename _Tp, typename _Comp, typename _Alloc, typename _Search> auto
+operator<<(std::ostream& os, const flat_set<_Tp, _Comp, _Alloc, _Search>& _um)
+-> std::ostream& {
+    os << _um._r;
+    return os;
+};
+
+};
+
+#endif // _ASP_FLAT_SET_HPP_
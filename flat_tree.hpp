@@ -0,0 +1,346 @@
+#ifndef _ASP_FLAT_TREE_HPP_
+#define _ASP_FLAT_TREE_HPP_
+
+#include "basic_param.hpp"
+#include "iterator.hpp"
+#include "type_traits.hpp"
+#include "associative_container_aux.hpp"
+#include "basic_io.hpp"
+#include "vector.hpp"
+#include "algo.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace asp {
+
+struct flat_binary_search;
+struct flat_branchless_search;
+template <typename _Tp> struct flat_value;
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey,
+ typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>, typename _Search = flat_branchless_search> class flat_tree;
+
+/**
+ * @brief search policies of @flat_tree
+ * @details %_S_partition_point(_first, _n, _pred) : the first element in [_first, _first + _n) that %_pred is false,
+ *   where %_pred is true for a prefix of the range.
+ *   - @flat_binary_search : classic binary search, which stops at the first equal element.
+ *   - @flat_branchless_search : halves the range with a conditional move, the number of steps only depends on %_n,
+ *     so there's no branch misprediction.
+*/
+struct flat_binary_search {
+    template <typename _Tp, typename _Pred> static _Tp* _S_partition_point(_Tp* _first, size_type _n, _Pred _pred) {
+        while (_n > 0) {
+            const size_type _half = _n / 2;
+            if (_pred(_first[_half])) {
+                _first += _half + 1;
+                _n -= _half + 1;
+            }
+            else {
+                _n = _half;
+            }
+        }
+        return _first;
+    }
+};
+struct flat_branchless_search {
+    template <typename _Tp, typename _Pred> static _Tp* _S_partition_point(_Tp* _first, size_type _n, _Pred _pred) {
+        if (_n == 0) { return _first; }
+        while (_n > 1) {
+            const size_type _half = _n / 2;
+            _first += _pred(_first[_half - 1]) ? _half : 0;
+            _n -= _half;
+        }
+        return _first + _pred(*_first);
+    }
+};
+
+// the element type stored in @flat_tree, whose key is assignable (std::pair<const K, V> -> std::pair<K, V>)
+template <typename _Tp> struct flat_value { typedef _Tp type; };
+template <typename _Key, typename _Tp> struct flat_value<std::pair<const _Key, _Tp>> { typedef std::pair<_Key, _Tp> type; };
+
+/**
+ * @brief ordered container on a sorted @vector, with the interface of @rb_tree
+ * @details
+ *   lookups are binary searches on a contiguous array, which beats node based trees on small-to-medium,
+ *   read-mostly data. %insert() moves the tail of the array, O(n).
+ *   %insert_buffered() appends to an unsorted insert buffer instead, which is sorted with @asp::sort and
+ *   merged into the array from the back when it passes about sqrt(n) elements (O(sqrt(n)) amortized),
+ *   or before any other access. since the first access after buffered insertions merges the buffer
+ *   (even through const member functions), call %flush() before sharing it among concurrent readers.
+ *   the elements are stored as @flat_value<_Value> so that they can be moved in the array,
+ *   don't modify the key through iterators.
+ * @tparam _Search @flat_branchless_search (default) or @flat_binary_search
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+class flat_tree {
+public:
+    typedef flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search> self;
+    typedef typename flat_value<_Value>::type value_type;
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<value_type> allocator_type;
+    typedef asp::vector<value_type, allocator_type> vector_type;
+
+    typedef _Key key_type;
+    typedef _Comp key_compare;
+    typedef typename vector_type::iterator iterator;
+    typedef typename vector_type::const_iterator const_iterator;
+
+    typedef asp::conditional_t<_UniqueKey, std::pair<iterator, bool>, iterator> ireturn_type;
+
+    typedef asso_container::type_traits<value_type, _UniqueKey> _ContainerTypeTraits;
+
+    typedef typename _ContainerTypeTraits::insert_status insert_status;
+    typedef typename _ContainerTypeTraits::ext_iterator ext_iterator;
+    typedef typename _ContainerTypeTraits::ext_value ext_value;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef _ExtKey ext_key;
+
+    // buffered elements are merged at least every %_S_min_buffer insertions
+    static constexpr const size_type _S_min_buffer = 16;
+
+    mutable vector_type _m_data; // sorted
+    mutable vector_type _m_buffer; // unsorted, no key in %_m_data if unique
+    _Comp _m_key_compare;
+
+    static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
+
+    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A, typename _S>
+     friend std::ostream& operator<<(std::ostream& os, const flat_tree<_K, _V, _EK, _UK, _C, _A, _S>& _f);
+
+public:
+    flat_tree() = default;
+    flat_tree(const self& _f) : _m_data(_f._m_data), _m_buffer(_f._m_buffer), _m_key_compare(_f._m_key_compare) {}
+    self& operator=(const self& _f) {
+        _m_data = _f._m_data;
+        _m_buffer = _f._m_buffer;
+        _m_key_compare = _f._m_key_compare;
+        return *this;
+    }
+    virtual ~flat_tree() = default;
+
+    iterator begin() { _M_flush(); return _m_data.begin(); }
+    const_iterator cbegin() const { _M_flush(); return _m_data.cbegin(); }
+    iterator end() { _M_flush(); return _m_data.end(); }
+    const_iterator cend() const { _M_flush(); return _m_data.cend(); }
+    size_type size() const { return _m_data.size() + _m_buffer.size(); }
+    bool empty() const { return size() == 0; }
+    void reserve(size_type _n) { _m_data.reserve(_n); }
+
+    iterator find(const key_type& _k);
+    const_iterator find(const key_type& _k) const;
+    size_type count(const key_type& _k) const;
+    void clear() { _m_data.clear(); _m_buffer.clear(); }
+    ireturn_type insert(const value_type& _v);
+    /**
+     * @brief insert %_v into the insert buffer, O(log(n) + sqrt(n)) amortized.
+     * @returns false if the key exists in a unique container
+    */
+    bool insert_buffered(const value_type& _v);
+    // merge the insert buffer
+    void flush() { _M_flush(); }
+    size_type erase(const key_type& _k);
+
+    iterator lower_bound(const key_type& _k) { _M_flush(); return _m_data.begin() + _M_lower_bound(_k); }
+    const_iterator lower_bound(const key_type& _k) const { _M_flush(); return _m_data.cbegin() + _M_lower_bound(_k); }
+    iterator upper_bound(const key_type& _k) { _M_flush(); return _m_data.begin() + _M_upper_bound(_k); }
+    const_iterator upper_bound(const key_type& _k) const { _M_flush(); return _m_data.cbegin() + _M_upper_bound(_k); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k) { return std::make_pair(lower_bound(_k), upper_bound(_k)); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const {
+        return std::make_pair(lower_bound(_k), upper_bound(_k));
+    }
+
+    // used for test
+    int check() const;
+
+protected:
+    // index of the first element in %_m_data not less than %_k
+    size_type _M_lower_bound(const key_type& _k) const;
+    // index of the first element in %_m_data greater than %_k
+    size_type _M_upper_bound(const key_type& _k) const;
+    // @brief unique_insert
+    std::pair<iterator, bool> _M_insert(const value_type& _v, asp::true_type);
+    // @brief multi_insert
+    iterator _M_insert(const value_type& _v, asp::false_type);
+    /**
+     * @brief sort the insert buffer, and merge it into %_m_data from the back.
+     * @details elements before the first insertion point don't move,
+     *   equal keys from the buffer are placed after the existing ones.
+    */
+    void _M_flush() const;
+};
+
+
+/// flat_tree protected implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::_M_lower_bound(const key_type& _k) const -> size_type {
+    const value_type* const _first = _m_data.data();
+    const _Comp& _comp = _m_key_compare;
+    return _Search::_S_partition_point(_first, _m_data.size(),
+     [&_comp, &_k](const value_type& _v) { return _comp(_S_key(_v), _k); }) - _first;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::_M_upper_bound(const key_type& _k) const -> size_type {
+    const value_type* const _first = _m_data.data();
+    const _Comp& _comp = _m_key_compare;
+    return _Search::_S_partition_point(_first, _m_data.size(),
+     [&_comp, &_k](const value_type& _v) { return !_comp(_k, _S_key(_v)); }) - _first;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::_M_insert(const value_type& _v, asp::true_type) -> std::pair<iterator, bool> {
+    const size_type _i = _M_lower_bound(_S_key(_v));
+    if (_i != _m_data.size() && !_m_key_compare(_S_key(_v), _S_key(_m_data[_i]))) {
+        return std::make_pair(_m_data.begin() + _i, false);
+    }
+    return std::make_pair(_m_data.insert(_m_data.cbegin() + _i, _v), true);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::_M_insert(const value_type& _v, asp::false_type) -> iterator {
+    const size_type _i = _M_upper_bound(_S_key(_v));
+    return _m_data.insert(_m_data.cbegin() + _i, _v);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::_M_flush() const -> void {
+    const size_type _m = _m_buffer.size();
+    if (_m == 0) { return; }
+    const _Comp& _comp = _m_key_compare;
+    value_type* _b = _m_buffer.data();
+    // equal keys in the buffer keep no order, which is fine for multi containers
+    asp::sort(_b, _b + _m, [&_comp](const value_type& _x, const value_type& _y) {
+        return _comp(_S_key(_x), _S_key(_y));
+    });
+    size_type _i = _m_data.size();
+    _m_data.reserve(_i + _m);
+    for (size_type _j = 0; _j < _m; ++_j) { // construct the tail
+        _m_data.push_back(_b[_j]);
+    }
+    value_type* _d = _m_data.data();
+    size_type _k = _i + _m;
+    size_type _j = _m;
+    while (_j > 0 && _i > 0) {
+        if (_comp(_S_key(_b[_j - 1]), _S_key(_d[_i - 1]))) {
+            _d[--_k] = std::move(_d[--_i]);
+        }
+        else {
+            _d[--_k] = std::move(_b[--_j]);
+        }
+    }
+    while (_j > 0) {
+        _d[--_k] = std::move(_b[--_j]);
+    }
+    _m_buffer.clear();
+};
+
+
+/// flat_tree public implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::find(const key_type& _k) -> iterator {
+    _M_flush();
+    const size_type _i = _M_lower_bound(_k);
+    return (_i == _m_data.size() || _m_key_compare(_k, _S_key(_m_data[_i]))) ? _m_data.end() : _m_data.begin() + _i;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::find(const key_type& _k) const -> const_iterator {
+    _M_flush();
+    const size_type _i = _M_lower_bound(_k);
+    return (_i == _m_data.size() || _m_key_compare(_k, _S_key(_m_data[_i]))) ? _m_data.cend() : _m_data.cbegin() + _i;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::count(const key_type& _k) const -> size_type {
+    _M_flush();
+    return _M_upper_bound(_k) - _M_lower_bound(_k);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::insert(const value_type& _v) -> ireturn_type {
+    _M_flush();
+    return _M_insert(_v, asp::bool_t<_UniqueKey>());
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::insert_buffered(const value_type& _v) -> bool {
+    if (_UniqueKey) {
+        const key_type _k = _S_key(_v);
+        const size_type _i = _M_lower_bound(_k);
+        if (_i != _m_data.size() && !_m_key_compare(_k, _S_key(_m_data[_i]))) {
+            return false;
+        }
+        for (size_type _j = 0; _j < _m_buffer.size(); ++_j) {
+            const key_type _y = _S_key(_m_buffer[_j]);
+            if (!_m_key_compare(_k, _y) && !_m_key_compare(_y, _k)) {
+                return false;
+            }
+        }
+    }
+    _m_buffer.push_back(_v);
+    const size_type _limit = static_cast<size_type>(std::sqrt(static_cast<double>(_m_data.size())));
+    if (_m_buffer.size() >= (_limit > _S_min_buffer ? _limit : _S_min_buffer)) {
+        _M_flush();
+    }
+    return true;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>
+::erase(const key_type& _k) -> size_type {
+    _M_flush();
+    const size_type _l = _M_lower_bound(_k);
+    const size_type _u = _M_upper_bound(_k);
+    value_type* const _d = _m_data.data();
+    std::move(_d + _u, _d + _m_data.size(), _d + _l);
+    for (size_type _i = _l; _i < _u; ++_i) {
+        _m_data.pop_back();
+    }
+    return _u - _l;
+};
+
+/**
+ * @returns 0 : normal ;
+ *   1 : error in order (or duplicated keys in unique container) ;
+ *   2 : a buffered key exists in unique container .
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Search>
+auto flat_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Search>::check() const -> int {
+    for (size_type _i = 1; _i < _m_data.size(); ++_i) {
+        const key_type _x = _S_key(_m_data[_i - 1]), _y = _S_key(_m_data[_i]);
+        if (_m_key_compare(_y, _x) || (_UniqueKey && !_m_key_compare(_x, _y))) {
+            return 1;
+        }
+    }
+    if (_UniqueKey) {
+        for (size_type _j = 0; _j < _m_buffer.size(); ++_j) {
+            const key_type _k = _S_key(_m_buffer[_j]);
+            if (_M_lower_bound(_k) != _M_upper_bound(_k)) {
+                return 2;
+            }
+        }
+    }
+    return 0;
+};
+
+
+/// output implement
+template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A, typename _S>
+std::ostream& operator<<(std::ostream& os, const flat_tree<_K, _V, _EK, _UK, _C, _A, _S>& _f) {
+    os << '[';
+    for (auto p = _f.cbegin(); p != _f.cend();) {
+        os << p;
+        if (++p != _f.cend()) {
+            os << ", ";
+        }
+    }
+    os << ']';
+    return os;
+};
+
+};
+
+#endif // _ASP_FLAT_TREE_HPP_
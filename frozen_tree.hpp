@@ -0,0 +1,320 @@
+#ifndef _ASP_FROZEN_TREE_HPP_
+#define _ASP_FROZEN_TREE_HPP_
+
+#include "basic_param.hpp"
+#include "iterator.hpp"
+#include "type_traits.hpp"
+#include "associative_container_aux.hpp"
+#include "basic_io.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace asp {
+
+struct eytzinger_layout;
+struct veb_layout;
+template <typename _Tp> struct frozen_tree_const_iterator;
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey,
+ typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>, typename _Layout = eytzinger_layout> class frozen_tree;
+
+/**
+ * @brief immutable sorted array for read-only lookups, built by %freeze() of ordered_* containers
+ * @details
+ *   the values are kept in a sorted array (iterators are in order), and the keys are copied into
+ *   a complete binary search tree of height %_m_height, stored implicitly in an array by %_Layout.
+ *   the tree is padded with the max key to 2^h - 1 slots, so that every lookup descends exactly h levels
+ *   without branches (the comparison result is added to the BFS index), and the final BFS index
+ *   2^h + r tells the rank r of the result in the sorted array.
+ *     l0:                 1
+ *     l1:         2               3
+ *     l2:     4       5       6       7
+ *     leaf:  8 9    10 11   12 13   14 15  (r = index - 2^h)
+ *   - @eytzinger_layout stores the BFS order, the 16 descendants 4 levels below are contiguous,
+ *     so they're prefetched while comparing the current level.
+ *   - @veb_layout (van Emde Boas) stores the top half levels first, then each bottom subtree recursively,
+ *     any root-to-leaf path touches O(log_B(n)) blocks for any block size B, which is better for very large sets.
+ *   the index takes at most 2 * n keys.
+*/
+struct eytzinger_layout {
+    void _M_build(unsigned) {}
+    // storage position of BFS index %_i (1-based), the BFS order needs neither the depth nor the path
+    std::size_t _M_index(std::size_t _i, unsigned, std::size_t*) const { return _i - 1; }
+    template <typename _Key> void _M_prefetch(const _Key* _keys, std::size_t _i, std::size_t _slots) const {
+#if defined(__GNUC__)
+        if (16 * _i <= _slots) {
+            __builtin_prefetch(_keys + 16 * _i - 1);
+        }
+#endif
+    }
+};
+
+/**
+ * @details
+ *   a tree of height h is split into a top tree of height h/2 and 2^(h/2) bottom trees.
+ *   for each depth %_d where bottom trees are rooted, the position of a node is
+ *     pos[_d] = pos[_m_top[_d]] + _m_top_size[_d] + (_i & _m_top_size[_d]) * _m_bottom_size[_d]
+ *   in which pos[_m_top[_d]] is the position of the root of the top tree on the current path,
+ *   and (_i & _m_top_size[_d]) is the order of the bottom tree under the top tree (Brodal et al.).
+*/
+struct veb_layout {
+    unsigned _m_top[64] = {0}; // depth of the root of the top tree
+    std::size_t _m_top_size[64] = {0};
+    std::size_t _m_bottom_size[64] = {0};
+
+    void _M_build(unsigned _h) { _M_split(0, _h); }
+    std::size_t _M_index(std::size_t _i, unsigned _d, std::size_t* _pos) const {
+        _pos[_d] = (_d == 0) ? 0 :
+         _pos[_m_top[_d]] + _m_top_size[_d] + (_i & _m_top_size[_d]) * _m_bottom_size[_d];
+        return _pos[_d];
+    }
+    template <typename _Key> void _M_prefetch(const _Key*, std::size_t, std::size_t) const {}
+
+private:
+    // the subtree rooted at depth %_d with height %_h
+    void _M_split(unsigned _d, unsigned _h) {
+        if (_h <= 1) { return; }
+        const unsigned _ht = _h / 2;
+        const unsigned _hb = _h - _ht;
+        _m_top[_d + _ht] = _d;
+        _m_top_size[_d + _ht] = (std::size_t(1) << _ht) - 1;
+        _m_bottom_size[_d + _ht] = (std::size_t(1) << _hb) - 1;
+        _M_split(_d, _ht);
+        _M_split(_d + _ht, _hb);
+    }
+};
+
+template <typename _Tp> struct frozen_tree_const_iterator {
+    typedef asp::random_access_iterator_tag iterator_category;
+    typedef _Tp value_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+    typedef asp::difference_type difference_type;
+    typedef frozen_tree_const_iterator<_Tp> self;
+
+    const value_type* _ptr = nullptr;
+
+    frozen_tree_const_iterator() = default;
+    frozen_tree_const_iterator(const value_type* _p) : _ptr(_p) {}
+    const value_type& operator*() const { return *_ptr; }
+    const value_type* operator->() const { return _ptr; }
+    self& operator++() { ++_ptr; return *this; }
+    self operator++(int) { self _ret = *this; ++_ptr; return _ret; }
+    self& operator--() { --_ptr; return *this; }
+    self operator--(int) { self _ret = *this; --_ptr; return _ret; }
+    self operator+(difference_type _n) const { return self(_ptr + _n); }
+    self operator-(difference_type _n) const { return self(_ptr - _n); }
+    operator bool() const { return _ptr != nullptr; }
+    friend difference_type operator-(const self& _x, const self& _y) { return _x._ptr - _y._ptr; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._ptr == _y._ptr; }
+    friend bool operator!=(const self& _x, const self& _y) { return _x._ptr != _y._ptr; }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const frozen_tree_const_iterator<_T>& _r);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+class frozen_tree : public _Alloc {
+public:
+    typedef frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout> self;
+    typedef _Alloc elt_allocator_type;
+    typedef std::allocator_traits<elt_allocator_type> elt_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<_Key> key_allocator_type;
+    typedef std::allocator_traits<key_allocator_type> key_alloc_traits;
+
+    typedef _Key key_type;
+    typedef _Comp key_compare;
+    typedef _Value value_type;
+    typedef frozen_tree_const_iterator<value_type> const_iterator;
+    typedef const_iterator iterator;
+
+    typedef asso_container::type_traits<value_type, _UniqueKey> _ContainerTypeTraits;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef _ExtKey ext_key;
+
+    value_type* _m_values = nullptr;
+    size_type _m_count = 0;
+    key_type* _m_keys = nullptr;
+    std::size_t _m_slots = 0; // 2^_m_height - 1
+    unsigned _m_height = 0;
+    _Layout _m_layout;
+    _Comp _m_key_compare;
+
+    static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
+
+    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A, typename _L>
+     friend std::ostream& operator<<(std::ostream& os, const frozen_tree<_K, _V, _EK, _UK, _C, _A, _L>& _f);
+
+public:
+    frozen_tree() = default;
+    /**
+     * @brief build from %_n values in sorted order (e.g. the iterators of an ordered_* container)
+    */
+    template <typename _InputIterator> frozen_tree(_InputIterator _first, _InputIterator _last, size_type _n);
+    frozen_tree(const self& _f) : frozen_tree(_f.cbegin(), _f.cend(), _f.size()) {}
+    frozen_tree(self&& _f) { _M_swap(_f); }
+    self& operator=(self _f) { _M_swap(_f); return *this; }
+    virtual ~frozen_tree();
+
+    const_iterator begin() const { return const_iterator(_m_values); }
+    const_iterator end() const { return const_iterator(_m_values + _m_count); }
+    const_iterator cbegin() const { return const_iterator(_m_values); }
+    const_iterator cend() const { return const_iterator(_m_values + _m_count); }
+    size_type size() const { return _m_count; }
+    bool empty() const { return _m_count == 0; }
+
+    const_iterator find(const key_type& _k) const;
+    size_type count(const key_type& _k) const { return _M_rank<true>(_k) - _M_rank<false>(_k); }
+    const_iterator lower_bound(const key_type& _k) const { return const_iterator(_m_values + _M_rank<false>(_k)); }
+    const_iterator upper_bound(const key_type& _k) const { return const_iterator(_m_values + _M_rank<true>(_k)); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const {
+        return std::make_pair(lower_bound(_k), upper_bound(_k));
+    }
+
+    // used for test
+    int check() const;
+
+protected:
+    /**
+     * @brief the number of values whose keys are less than (or equal to, if upper) %_k
+    */
+    template <bool _Upper> size_type _M_rank(const key_type& _k) const;
+    // construct the keys of subtree rooted at BFS index %_i (depth %_d)
+    void _M_fill(std::size_t _i, unsigned _d, std::size_t* _pos);
+    void _M_swap(self& _f);
+};
+
+
+/// frozen_tree implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+template <typename _InputIterator> frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>
+::frozen_tree(_InputIterator _first, _InputIterator _last, size_type _n) {
+    if (_n == 0) { return; }
+    _m_values = elt_alloc_traits::allocate(*this, _n);
+    for (; _first != _last && _m_count < _n; ++_first, ++_m_count) {
+        elt_alloc_traits::construct(*this, _m_values + _m_count, *_first);
+    }
+    while (_m_slots < _m_count) {
+        ++_m_height;
+        _m_slots = (std::size_t(1) << _m_height) - 1;
+    }
+    _m_layout._M_build(_m_height);
+    key_allocator_type _key_alloc(*this);
+    _m_keys = key_alloc_traits::allocate(_key_alloc, _m_slots);
+    std::size_t _pos[64];
+    _M_fill(1, 0, _pos);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>::~frozen_tree() {
+    if (_m_keys != nullptr) {
+        key_allocator_type _key_alloc(*this);
+        for (std::size_t _i = 0; _i < _m_slots; ++_i) {
+            key_alloc_traits::destroy(_key_alloc, _m_keys + _i);
+        }
+        key_alloc_traits::deallocate(_key_alloc, _m_keys, _m_slots);
+    }
+    if (_m_values != nullptr) {
+        for (size_type _i = 0; _i < _m_count; ++_i) {
+            elt_alloc_traits::destroy(*this, _m_values + _i);
+        }
+        elt_alloc_traits::deallocate(*this, _m_values, _m_count);
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+auto frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>
+::_M_fill(std::size_t _i, unsigned _d, std::size_t* _pos) -> void {
+    const unsigned _below = _m_height - _d; // height of the subtree
+    // in-order rank of %_i in the complete tree
+    const std::size_t _r = ((_i - (std::size_t(1) << _d)) << _below) + (std::size_t(1) << (_below - 1)) - 1;
+    const std::size_t _j = _m_layout._M_index(_i, _d, _pos);
+    key_allocator_type _key_alloc(*this);
+    key_alloc_traits::construct(_key_alloc, _m_keys + _j, _S_key(_m_values[_r < _m_count ? _r : _m_count - 1]));
+    if (_d + 1 < _m_height) {
+        _M_fill(2 * _i, _d + 1, _pos);
+        _M_fill(2 * _i + 1, _d + 1, _pos);
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+template <bool _Upper> auto frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>
+::_M_rank(const key_type& _k) const -> size_type {
+    std::size_t _pos[64];
+    std::size_t _i = 1;
+    for (unsigned _d = 0; _d < _m_height; ++_d) {
+        _m_layout._M_prefetch(_m_keys, _i, _m_slots);
+        const key_type& _y = _m_keys[_m_layout._M_index(_i, _d, _pos)];
+        _i = 2 * _i + (_Upper ? !_m_key_compare(_k, _y) : _m_key_compare(_y, _k));
+    }
+    const std::size_t _r = _i - (std::size_t(1) << _m_height);
+    return _r < _m_count ? _r : _m_count;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+auto frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>
+::_M_swap(self& _f) -> void {
+    std::swap(_m_values, _f._m_values);
+    std::swap(_m_count, _f._m_count);
+    std::swap(_m_keys, _f._m_keys);
+    std::swap(_m_slots, _f._m_slots);
+    std::swap(_m_height, _f._m_height);
+    std::swap(_m_layout, _f._m_layout);
+    std::swap(_m_key_compare, _f._m_key_compare);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+auto frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>
+::find(const key_type& _k) const -> const_iterator {
+    const size_type _r = _M_rank<false>(_k);
+    return (_r == _m_count || _m_key_compare(_k, _S_key(_m_values[_r]))) ? cend() : const_iterator(_m_values + _r);
+};
+
+/**
+ * @returns 0 : normal ;
+ *   1 : error in order (or duplicated keys in unique container) ;
+ *   2 : error in the search tree .
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Layout>
+auto frozen_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Layout>::check() const -> int {
+    for (size_type _i = 1; _i < _m_count; ++_i) {
+        const key_type _x = _S_key(_m_values[_i - 1]), _y = _S_key(_m_values[_i]);
+        if (_m_key_compare(_y, _x) || (_UniqueKey && !_m_key_compare(_x, _y))) {
+            return 1;
+        }
+    }
+    for (size_type _i = 0; _i < _m_count; ++_i) {
+        const key_type _k = _S_key(_m_values[_i]);
+        const size_type _r = _M_rank<false>(_k);
+        if (_r > _i || _m_key_compare(_S_key(_m_values[_r]), _k) ||
+         (_r > 0 && !_m_key_compare(_S_key(_m_values[_r - 1]), _k))) {
+            return 2;
+        }
+    }
+    return 0;
+};
+
+
+/// output implement
+template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A, typename _L>
+std::ostream& operator<<(std::ostream& os, const frozen_tree<_K, _V, _EK, _UK, _C, _A, _L>& _f) {
+    os << '[';
+    for (auto p = _f.cbegin(); p != _f.cend();) {
+        os << p;
+        if (++p != _f.cend()) {
+            os << ", ";
+        }
+    }
+    os << ']';
+    return os;
+};
+template <typename _T> std::ostream& operator<<(std::ostream& os, const frozen_tree_const_iterator<_T>& _r) {
+    if (_r)
+        os << obj_string::_M_obj_2_string(*_r);
+    else
+        os << "null";
+    return os;
+};
+
+};
+
+#endif // _ASP_FROZEN_TREE_HPP_
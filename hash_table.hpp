@@ -372,6 +372,13 @@ protected:
     virtual void _M_start_rehash(size_type _next_bkt);
     virtual void _M_finish_rehash();
     virtual task_status _M_step_rehash(size_type _step = 1);
+    /**
+     * @brief called after the bucket %_i is emptied by an erasure, %_next is the node after the erased ones.
+     * @details the bucket in process of rehash is always the first one not moved yet,
+     *   if it's emptied, the rehash continues with the one starting at %_next.
+     *   otherwise %_M_step_rehash() would take the empty bucket as the end, and lose the rest.
+     * */
+    void _M_bucket_emptied(const bucket_index& _i, const node_type* const _next);
     /**
      * @brief execute a rehash if necessary.
      * @details function would invalidate iterator, bucket_indx.
@@ -813,6 +820,7 @@ hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::_M_eras
         if (_M_end_of_bucket(_hint)) {
         // if (_M_end_of_bucket(_hint, _i)) {
             this->_M_bucket_ref(_i) = nullptr;
+            this->_M_bucket_emptied(_i, _n->_next);
         }
         else {
             _hint = _n->_next;
@@ -853,6 +861,7 @@ hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::_M_eras
             }
             else {
                 this->_M_bucket_ref(_i) = nullptr;
+                this->_M_bucket_emptied(_i, _p);
             }
         }
         return _cnt;
@@ -869,7 +878,7 @@ template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typ
 hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::_M_update(const value_type& _v, asp::true_type)
 -> iterator {
     _M_erase(_extract_key(_v), asp::true_type());
-    return this->_M_insert(_v, asp::true_type());
+    return this->_M_insert(_v, asp::true_type()).first;
 };
 
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
@@ -932,7 +941,9 @@ hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::clear()
         this->_M_deallocate_node(_s);
     }
     memset(_buckets, 0, _bucket_count * sizeof(bucket_type));
-    memset(_rehash_buckets, 0, _rehash_bucket_count * sizeof(bucket_type));
+    if (_rehash_buckets != nullptr) {
+        memset(_rehash_buckets, 0, _rehash_bucket_count * sizeof(bucket_type));
+    }
 
     this->_M_init_mark();
     this->_element_count = 0;
@@ -1130,6 +1141,13 @@ hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::_M_step
     return task_status::__NORMAL__;
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::_M_bucket_emptied(const bucket_index& _i, const node_type* const _next)
+-> void {
+    if (!this->_M_in_rehash() || _i != _rehash_policy._cur_process) { return; }
+    if (_next == nullptr || _next == _M_end()) { return; }
+    _rehash_policy._cur_process = _M_find_head_node(this->_extract_key(_next->val()), _next);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
 hash_table<_Key, _Value, _ExtKey, _UniqueKey, _ExtValue, _Hash, _Alloc>::_M_rehash_if_required()
 -> void {
     if (!this->_M_in_rehash()) {    
@@ -0,0 +1,83 @@
+#ifndef _ASP_INTERVAL_MAP_HPP_
+#define _ASP_INTERVAL_MAP_HPP_
+
+#include <functional>
+
+#include "basic_param.hpp"
+#include "interval_tree.hpp"
+
+namespace asp {
+
+/**
+ * @brief map from half-open intervals [lo, hi) to %_Tp, with overlap queries
+ * @tparam _Compare comparator of %_Bound
+*/
+template <typename _Bound, typename _Tp,
+ typename _Compare = std::less<_Bound>,
+ typename _Alloc = std::allocator<std::pair<const std::pair<_Bound, _Bound>, _Tp>>
+> class interval_map;
+
+template <typename _Bound, typename _Tp, typename _Compare, typename _Alloc>
+class interval_map {
+    typedef interval_map<_Bound, _Tp, _Compare, _Alloc> self;
+    typedef interval_tree<_Bound, std::pair<const std::pair<_Bound, _Bound>, _Tp>, _select_0x, true, _Compare, _Alloc> map_it;
+    map_it _r;
+public:
+    typedef typename map_it::key_type key_type;
+    typedef typename map_it::bound_type bound_type;
+    typedef typename map_it::value_type value_type;
+    typedef typename map_it::mapped_type mapped_type;
+    typedef typename map_it::key_compare key_compare;
+    typedef typename map_it::iterator iterator;
+    typedef typename map_it::const_iterator const_iterator;
+    typedef typename map_it::ireturn_type ireturn_type;
+    typedef typename map_it::insert_status insert_status;
+    typedef typename map_it::ext_iterator ext_iterator;
+    typedef typename map_it::ext_key ext_key;
+    typedef typename map_it::ext_value ext_value;
+
+/// (de)constructor
+    interval_map() = default;
+    interval_map(const self& _x) : _r(_x._r) {}
+    virtual ~interval_map() = default;
+
+/// implement
+    size_type size() const { return _r.size(); }
+    bool empty() const { return _r.empty(); }
+    iterator begin() { return _r.begin(); }
+    iterator end() { return _r.end(); }
+    const_iterator cbegin() const { return _r.cbegin(); }
+    const_iterator cend() const { return _r.cend(); }
+    ireturn_type insert(const value_type& _v) { return _r.insert(_v); }
+    ireturn_type set(const key_type& _k, const mapped_type& _m) { return _r.insert(value_type(_k, _m)); }
+    ireturn_type set(const bound_type& _lo, const bound_type& _hi, const mapped_type& _m) { return _r.insert(value_type(key_type(_lo, _hi), _m)); }
+    size_type erase(const key_type& _k) { return _r.erase(_k); }
+    size_type count(const key_type& _k) const { return _r.count(_k); }
+    void clear() { _r.clear(); }
+    iterator find(const key_type& _k) { return _r.find(_k); }
+    const_iterator find(const key_type& _k) const { return _r.find(_k); }
+    // intervals overlapping [%_lo, %_hi), in order
+    std::vector<const_iterator> overlapping(const bound_type& _lo, const bound_type& _hi) const { return _r.overlapping(_lo, _hi); }
+    template <typename _Func> size_type overlapping(const bound_type& _lo, const bound_type& _hi, _Func&& _f) const { return _r.overlapping(_lo, _hi, std::forward<_Func>(_f)); }
+    // intervals containing %_p, in order
+    std::vector<const_iterator> stab(const bound_type& _p) const { return _r.stab(_p); }
+    template <typename _Func> size_type stab(const bound_type& _p, _Func&& _f) const { return _r.stab(_p, std::forward<_Func>(_f)); }
+#ifdef _CONTAINER_CHECK_
+    int check() const { return _r.check(); }
+#endif // _CONTAINER_CHECK_
+
+/// output
+    template <typename _B, typename _T, typename _C, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const interval_map<_B, _T, _C, _A>& _im);
+};
+
+template <typename _Bound, typename _Tp, typename _Comp, typename _Alloc> auto
+operator<<(std::ostream& os, const interval_map<_Bound, _Tp, _Comp, _Alloc>& _im)
+-> std::ostream& {
+    os << _im._r;
+    return os;
+};
+
+};
+
+#endif // _ASP_INTERVAL_MAP_HPP_
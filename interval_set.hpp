@@ -0,0 +1,82 @@
+#ifndef _ASP_INTERVAL_SET_HPP_
+#define _ASP_INTERVAL_SET_HPP_
+
+#include <functional>
+
+#include "basic_param.hpp"
+#include "interval_tree.hpp"
+
+namespace asp {
+
+/**
+ * @brief set of half-open intervals [lo, hi), with overlap queries
+ * @tparam _Compare comparator of %_Bound
+*/
+template <typename _Bound,
+ typename _Compare = std::less<_Bound>,
+ typename _Alloc = std::allocator<std::pair<_Bound, _Bound>>
+> class interval_set;
+
+template <typename _Bound, typename _Compare, typename _Alloc>
+class interval_set {
+    typedef interval_set<_Bound, _Compare, _Alloc> self;
+    typedef interval_tree<_Bound, std::pair<_Bound, _Bound>, _select_self, true, _Compare, _Alloc> set_it;
+    set_it _r;
+public:
+    typedef typename set_it::key_type key_type;
+    typedef typename set_it::bound_type bound_type;
+    typedef typename set_it::value_type value_type;
+    typedef typename set_it::mapped_type mapped_type;
+    typedef typename set_it::key_compare key_compare;
+    typedef typename set_it::iterator iterator;
+    typedef typename set_it::const_iterator const_iterator;
+    typedef typename set_it::ireturn_type ireturn_type;
+    typedef typename set_it::insert_status insert_status;
+    typedef typename set_it::ext_iterator ext_iterator;
+    typedef typename set_it::ext_key ext_key;
+    typedef typename set_it::ext_value ext_value;
+
+/// (de)constructor
+    interval_set() = default;
+    interval_set(const self& _x) : _r(_x._r) {}
+    virtual ~interval_set() = default;
+
+/// implement
+    size_type size() const { return _r.size(); }
+    bool empty() const { return _r.empty(); }
+    iterator begin() { return _r.begin(); }
+    iterator end() { return _r.end(); }
+    const_iterator cbegin() const { return _r.cbegin(); }
+    const_iterator cend() const { return _r.cend(); }
+    ireturn_type insert(const value_type& _v) { return _r.insert(_v); }
+    ireturn_type insert(const bound_type& _lo, const bound_type& _hi) { return _r.insert(value_type(_lo, _hi)); }
+    size_type erase(const key_type& _k) { return _r.erase(_k); }
+    size_type count(const key_type& _k) const { return _r.count(_k); }
+    void clear() { _r.clear(); }
+    iterator find(const key_type& _k) { return _r.find(_k); }
+    const_iterator find(const key_type& _k) const { return _r.find(_k); }
+    // intervals overlapping [%_lo, %_hi), in order
+    std::vector<const_iterator> overlapping(const bound_type& _lo, const bound_type& _hi) const { return _r.overlapping(_lo, _hi); }
+    template <typename _Func> size_type overlapping(const bound_type& _lo, const bound_type& _hi, _Func&& _f) const { return _r.overlapping(_lo, _hi, std::forward<_Func>(_f)); }
+    // intervals containing %_p, in order
+    std::vector<const_iterator> stab(const bound_type& _p) const { return _r.stab(_p); }
+    template <typename _Func> size_type stab(const bound_type& _p, _Func&& _f) const { return _r.stab(_p, std::forward<_Func>(_f)); }
+#ifdef _CONTAINER_CHECK_
+    int check() const { return _r.check(); }
+#endif // _CONTAINER_CHECK_
+
+/// output
+    template <typename _B, typename _C, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const interval_set<_B, _C, _A>& _is);
+};
+
+template <typename _Bound, typename _Comp, typename _Alloc> auto
+operator<<(std::ostream& os, const interval_set<_Bound, _Comp, _Alloc>& _is)
+-> std::ostream& {
+    os << _is._r;
+    return os;
+};
+
+};
+
+#endif // _ASP_INTERVAL_SET_HPP_
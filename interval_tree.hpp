@@ -0,0 +1,198 @@
+#ifndef _ASP_INTERVAL_TREE_HPP_
+#define _ASP_INTERVAL_TREE_HPP_
+
+#include "rb_tree.hpp"
+
+#include <vector>
+
+namespace asp {
+
+template <typename _Tp, typename _Bound, typename _ExtKey, typename _Comp> struct interval_tree_node;
+template <typename _Bound, typename _Comp> struct interval_compare;
+
+/**
+ * @brief interval tree, @rb_tree augmented with max endpoint
+ * @details
+ *   key of each element is a half-open interval [lo, hi) (as std::pair<_Bound, _Bound>),
+ *   elements are ordered by (lo, hi), and each node keeps the max %hi in its subtree (%_max),
+ *   which is maintained through rotations by @bitree_augment.
+ *   two intervals [a, b) and [c, d) overlap iff (a < d && c < b).
+ *   a subtree can be skipped if its %_max <= lo of the query,
+ *   and the right subtree of a node can be skipped if the node starts at or after hi of the query.
+ * @tparam _Comp comparator of %_Bound
+*/
+template <typename _Bound, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> class interval_tree;
+
+template <typename _Bound, typename _Comp> struct interval_compare {
+    typedef std::pair<_Bound, _Bound> interval_type;
+    _Comp _m_comp;
+    bool operator()(const interval_type& _x, const interval_type& _y) const {
+        if (_m_comp(_x.first, _y.first)) { return true; }
+        if (_m_comp(_y.first, _x.first)) { return false; }
+        return _m_comp(_x.second, _y.second);
+    }
+};
+
+/**
+ * @brief node of @interval_tree
+ * @details same layout as @rb_tree_compact_node, plus %_max (max hi in subtree).
+*/
+template <typename _Tp, typename _Bound, typename _ExtKey, typename _Comp> struct interval_tree_node {
+    typedef interval_tree_node<_Tp, _Bound, _ExtKey, _Comp> self;
+    using value_type = _Tp;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+    interval_tree_node() = default;
+    interval_tree_node(const self& _s)
+     : _parent_color(_s._parent_color), _left(_s._left), _right(_s._right), _max(_s._max), _v(_s._v) {}
+    interval_tree_node(const value_type& _x) : _max(_S_high(_x)), _v(_x) {}
+    template <typename... _Args> interval_tree_node(_Args&&... _args)
+     : _v(std::forward<_Args>(_args)...) { _max = _S_high(_v); }
+
+    std::uintptr_t _parent_color = 0;
+    self* _left = nullptr;
+    self* _right = nullptr;
+    _Bound _max = _Bound(); // max hi in subtree
+
+    value_type& val() { return _v; }
+    const value_type& val() const { return _v; }
+    value_type* valptr() { return &_v; }
+    const value_type* valptr() const { return &_v; }
+
+    self* _M_parent() const { return reinterpret_cast<self*>(_parent_color & ~_S_color_mask); }
+    void _M_set_parent(self* _p) {
+        _parent_color = reinterpret_cast<std::uintptr_t>(_p) | (_parent_color & _S_color_mask);
+    }
+    _Rb_tree_color _M_color() const { return static_cast<_Rb_tree_color>(_parent_color & _S_color_mask); }
+    void _M_set_color(_Rb_tree_color _c) {
+        _parent_color = (_parent_color & ~_S_color_mask) | static_cast<std::uintptr_t>(_c);
+    }
+
+    static _Bound _S_low(const value_type& _x) { return std::get<0>(_ExtKey()(_x)); }
+    static _Bound _S_high(const value_type& _x) { return std::get<1>(_ExtKey()(_x)); }
+    // recompute %_max from %_v and children
+    void _M_update() {
+        _max = _S_high(_v);
+        if (_left != nullptr && _Comp()(_max, _left->_max)) { _max = _left->_max; }
+        if (_right != nullptr && _Comp()(_max, _right->_max)) { _max = _right->_max; }
+    }
+
+private:
+    static constexpr std::uintptr_t _S_color_mask = 1;
+    value_type _v;
+};
+
+template <typename _Tp, typename _Bound, typename _ExtKey, typename _Comp>
+struct bitree_augment<interval_tree_node<_Tp, _Bound, _ExtKey, _Comp>> {
+    static constexpr bool value = true;
+    static void _S_update(interval_tree_node<_Tp, _Bound, _ExtKey, _Comp>* _x) { _x->_M_update(); }
+};
+
+template <typename _Bound, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Bound>, typename _Alloc = std::allocator<_Value>>
+class interval_tree : public rb_tree<std::pair<_Bound, _Bound>, _Value, _ExtKey, _UniqueKey,
+ interval_compare<_Bound, _Comp>, _Alloc, interval_tree_node<_Value, _Bound, _ExtKey, _Comp>> {
+public:
+    typedef interval_tree<_Bound, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc> self;
+    typedef rb_tree<std::pair<_Bound, _Bound>, _Value, _ExtKey, _UniqueKey,
+     interval_compare<_Bound, _Comp>, _Alloc, interval_tree_node<_Value, _Bound, _ExtKey, _Comp>> base;
+    typedef _Bound bound_type;
+    typedef typename base::key_type interval_type;
+    typedef typename base::node_type node_type;
+    typedef typename base::const_node_type const_node_type;
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+
+public:
+    interval_tree() = default;
+    interval_tree(const self& _it) : base(_it) {}
+    virtual ~interval_tree() = default;
+
+    /**
+     * @brief visit elements overlapping [%_lo, %_hi) in order.
+     * @details O(min(n, (k+1)*log(n))) for %k results, O(log(n) + k) when the intervals don't nest deeply.
+     * @param _f callable with const_iterator
+     * @returns the number of elements visited
+    */
+    template <typename _Func> size_type overlapping(const bound_type& _lo, const bound_type& _hi, _Func&& _f) const {
+        return _M_search(this->_M_begin(), _lo, _hi, false, _f);
+    }
+    std::vector<const_iterator> overlapping(const bound_type& _lo, const bound_type& _hi) const {
+        std::vector<const_iterator> _ret;
+        overlapping(_lo, _hi, [&_ret](const_iterator _i) { _ret.push_back(_i); });
+        return _ret;
+    }
+    /**
+     * @brief visit elements containing %_p (lo <= %_p < hi) in order.
+     * @param _f callable with const_iterator
+     * @returns the number of elements visited
+    */
+    template <typename _Func> size_type stab(const bound_type& _p, _Func&& _f) const {
+        return _M_search(this->_M_begin(), _p, _p, true, _f);
+    }
+    std::vector<const_iterator> stab(const bound_type& _p) const {
+        std::vector<const_iterator> _ret;
+        stab(_p, [&_ret](const_iterator _i) { _ret.push_back(_i); });
+        return _ret;
+    }
+
+    // used for test
+    int check() const;
+
+protected:
+    /**
+     * @brief visit elements [lo, hi) in subtree %_x, which satisfy lo < %_hi (or lo <= %_hi if %_closed) and %_lo < hi.
+    */
+    template <typename _Func> size_type _M_search(const_node_type* _x, const bound_type& _lo, const bound_type& _hi, bool _closed, _Func& _f) const;
+    // @returns false if %_max of any node in subtree %_x is wrong
+    bool _M_check_max(const_node_type* _x) const;
+};
+
+template <typename _Bound, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+template <typename _Func> auto interval_tree<_Bound, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_search(const_node_type* _x, const bound_type& _lo, const bound_type& _hi, bool _closed, _Func& _f) const -> size_type {
+    const _Comp _comp;
+    size_type _n = 0;
+    // the in-order traversal of the left subtree is before %_x, recursion on the left keeps the order
+    while (_x != nullptr && _comp(_lo, _x->_max)) {
+        _n += _M_search(_x->_left, _lo, _hi, _closed, _f);
+        const bound_type _l = node_type::_S_low(_x->val());
+        if (_closed ? _comp(_hi, _l) : !_comp(_l, _hi)) {
+            break; // %_x and its right subtree start after the query
+        }
+        if (_comp(_lo, node_type::_S_high(_x->val()))) {
+            _f(const_iterator(_x));
+            ++_n;
+        }
+        _x = _x->_right;
+    }
+    return _n;
+};
+
+template <typename _Bound, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto interval_tree<_Bound, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_check_max(const_node_type* _x) const -> bool {
+    if (_x == nullptr) { return true; }
+    node_type _y(_x->val());
+    _y._left = _x->_left;
+    _y._right = _x->_right;
+    _y._M_update();
+    const _Comp _comp;
+    if (_comp(_y._max, _x->_max) || _comp(_x->_max, _y._max)) { return false; }
+    return _M_check_max(_x->_left) && _M_check_max(_x->_right);
+};
+
+/**
+ * @returns @rb_tree::check() if the red black tree is broken ;
+ *   4 : error in max endpoint .
+*/
+template <typename _Bound, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto interval_tree<_Bound, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> int {
+    const int _r = base::check();
+    if (_r != 0) { return _r; }
+    return _M_check_max(this->_M_begin()) ? 0 : 4;
+};
+
+};
+
+#endif // _ASP_INTERVAL_TREE_HPP_
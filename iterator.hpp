@@ -25,6 +25,7 @@ template <typename _Tp, typename _Pointer = _Tp*, typename _Reference = _Tp&> st
     base_iterator(const self& _s) : _ptr(_s._ptr) {}
     self& operator=(const self& _s) {
         this->_ptr = _s._ptr;
+        return *this;
     }
 
     reference operator*() {
@@ -79,6 +80,7 @@ struct normal_iterator : public base_iterator <_Tp> {
     normal_iterator(const self& rhs): base(rhs._ptr) {}
     self& operator=(const self& rhs) {
         _ptr = rhs._ptr;
+        return *this;
     }
     // @iterator to @const_iterator conversion
     template <typename _Iter> normal_iterator(const normal_iterator<_Iter>& _i)
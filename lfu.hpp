@@ -7,17 +7,19 @@ namespace asp {
 
 template <typename _Key, typename _Tp,
  typename _Hash = std::hash<_Key>,
- typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>
+ typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>,
+ typename _Weigher = _unit_weigher
 > class lfu_map;
 template <typename _Tp,
  typename _Hash = std::hash<_Tp>,
- typename _Alloc = std::allocator<_Tp>
+ typename _Alloc = std::allocator<_Tp>,
+ typename _Weigher = _unit_weigher
 > class lfu_set;
 
-template <typename _Key, typename _Tp, typename _Hash, typename _Alloc>
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, typename _Weigher>
 class lfu_map {
-    typedef lfu_map<_Key, _Tp, _Hash, _Alloc> self;
-    typedef lfu_table<_Key, std::pair<const _Key, _Tp>, _select_0x, _select_1x, _Hash, _Alloc> lfu_t;
+    typedef lfu_map<_Key, _Tp, _Hash, _Alloc, _Weigher> self;
+    typedef lfu_table<_Key, std::pair<const _Key, _Tp>, _select_0x, _select_1x, _Hash, _Alloc, _Weigher> lfu_t;
     typedef typename lfu_t::key_type key_type;
     typedef typename lfu_t::value_type value_type;
     typedef typename lfu_t::mapped_type mapped_type;
@@ -29,7 +31,7 @@ class lfu_map {
 
 public:
 /// (de)constructor
-    lfu_map(size_type _capacity) : _l(_capacity) {}
+    lfu_map(size_type _capacity, size_type _age_factor = lfu_t::_S_default_age_factor) : _l(_capacity, _age_factor) {}
     lfu_map(const self& _rhs) : _l(_rhs._l) {}
     self& operator=(const self& _rhs) {
         if (&_rhs == this) return *this;
@@ -40,16 +42,19 @@ public:
 
     size_type size() const { return _l.size(); }
     size_type capacity() const { return _l.capacity(); }
+    size_type weight() const { return _l.weight(); }
     bool empty() const { return _l.empty(); }
     void clear() { _l.clear(); }
     void resize(size_type _new_capacity) { _l.resize(_new_capacity); }
     const_iterator get(const key_type& _k) { return _l.get(_k); }
     void put(const value_type& _v) { _l.put(_v); }
+    void put(const value_type& _v, tick_type _ttl) { _l.put(_v, _ttl); }
+    size_type tick(tick_type _now) { return _l.tick(_now); }
 
     const_iterator cbegin() const { return _l.cbegin(); }
     const_iterator cend() const { return _l.cend(); }
 
-    template <typename _K, typename _T, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const lfu_map<_K, _T, _H, _A>& _x);
+    template <typename _K, typename _T, typename _H, typename _A, typename _W> friend std::ostream& operator<<(std::ostream& _os, const lfu_map<_K, _T, _H, _A, _W>& _x);
 
     int check() const;
     void demo(std::istream& _is = std::cin, std::ostream& _os = std::cout);
@@ -72,10 +77,10 @@ private:
     }
 };
 
-template <typename _Tp, typename _Hash, typename _Alloc>
+template <typename _Tp, typename _Hash, typename _Alloc, typename _Weigher>
 class lfu_set {
-    typedef lfu_set<_Tp, _Hash, _Alloc> self;
-    typedef lfu_table<_Tp, _Tp, _select_self, _select_self, _Hash, _Alloc> lfu_t;
+    typedef lfu_set<_Tp, _Hash, _Alloc, _Weigher> self;
+    typedef lfu_table<_Tp, _Tp, _select_self, _select_self, _Hash, _Alloc, _Weigher> lfu_t;
     typedef typename lfu_t::key_type key_type;
     typedef typename lfu_t::value_type value_type;
     typedef typename lfu_t::mapped_type mapped_type;
@@ -86,7 +91,7 @@ class lfu_set {
     lfu_t _l;
 public:
 /// (de)constructor
-    lfu_set(size_type _capacity) : _l(_capacity) {}
+    lfu_set(size_type _capacity, size_type _age_factor = lfu_t::_S_default_age_factor) : _l(_capacity, _age_factor) {}
     lfu_set(const self& _rhs) : _l(_rhs._l) {}
     self& operator=(const self& _rhs) {
         if (&_rhs == this) return *this;
@@ -97,16 +102,19 @@ public:
 
     size_type size() const { return _l.size(); }
     size_type capacity() const { return _l.capacity(); }
+    size_type weight() const { return _l.weight(); }
     bool empty() const { return _l.empty(); }
     void clear() { _l.clear(); }
     void resize(size_type _new_capacity) { _l.resize(_new_capacity); }
     const_iterator get(const key_type& _k) { return _l.get(_k); }
     void put(const value_type& _v) { _l.put(_v); }
+    void put(const value_type& _v, tick_type _ttl) { _l.put(_v, _ttl); }
+    size_type tick(tick_type _now) { return _l.tick(_now); }
 
     const_iterator cbegin() const { return _l.cbegin(); }
     const_iterator cend() const { return _l.cend(); }
 
-    template <typename _T, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const lfu_set<_T, _H, _A>& _x);
+    template <typename _T, typename _H, typename _A, typename _W> friend std::ostream& operator<<(std::ostream& _os, const lfu_set<_T, _H, _A, _W>& _x);
 
     int check() const;
     void demo(std::istream& _is = std::cin, std::ostream& _os = std::cout);
@@ -131,18 +139,18 @@ private:
 
 
 
-template <typename _K, typename _T, typename _H, typename _A> auto
-operator<<(std::ostream& _os, const lfu_map<_K, _T, _H, _A>& _x)-> std::ostream& {
+template <typename _K, typename _T, typename _H, typename _A, typename _W> auto
+operator<<(std::ostream& _os, const lfu_map<_K, _T, _H, _A, _W>& _x)-> std::ostream& {
     return _os << _x._l;
 };
 
-template <typename _Key, typename _Tp, typename _Hash, typename _Alloc> auto
-lfu_map<_Key, _Tp, _Hash, _Alloc>::check() const -> int {
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_map<_Key, _Tp, _Hash, _Alloc, _Weigher>::check() const -> int {
     return 0;
 };
 
-template <typename _Key, typename _Tp, typename _Hash, typename _Alloc> auto
-lfu_map<_Key, _Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void {
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_map<_Key, _Tp, _Hash, _Alloc, _Weigher>::demo(std::istream& _is, std::ostream& _os) -> void {
     _os << '[' << typeid(asp::decay_t<self>).name() << ']' << std::endl;
     _is.sync_with_stdio(false);
     std::string _op;
@@ -201,16 +209,16 @@ lfu_map<_Key, _Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) ->
 };
 
 
-template <typename _T, typename _H, typename _A> auto
-operator<<(std::ostream& _os, const lfu_set<_T, _H, _A>& _x)-> std::ostream& {
+template <typename _T, typename _H, typename _A, typename _W> auto
+operator<<(std::ostream& _os, const lfu_set<_T, _H, _A, _W>& _x)-> std::ostream& {
     return _os << _x._l;
 };
-template <typename _Tp, typename _Hash, typename _Alloc> auto
-lfu_set<_Tp, _Hash, _Alloc>::check() const -> int {
+template <typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_set<_Tp, _Hash, _Alloc, _Weigher>::check() const -> int {
     return 0;
 };
-template <typename _Tp, typename _Hash, typename _Alloc> auto
-lfu_set<_Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void {
+template <typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_set<_Tp, _Hash, _Alloc, _Weigher>::demo(std::istream& _is, std::ostream& _os) -> void {
     _os << '[' << typeid(asp::decay_t<self>).name() << ']' << std::endl;
     _is.sync_with_stdio(false);
     std::string _op;
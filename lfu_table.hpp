@@ -3,95 +3,131 @@
 
 #include "hash_table.hpp"
 #include "list.hpp"
+#include "timing_wheel.hpp"
 #include <unordered_map>
 
 namespace asp {
 
 /**
- * @brief least frequently used structure
+ * @brief least frequently used structure, O(1) for each operation
  * @details
- *    key(freq) in list, assume that key == value, structure like below:
+ *    elements(freq) in list, grouped in the runs of the buckets, assume that key == value, structure like below:
  *    --------------------------------------------------
- *       _kt   4     5     8     2     6     1     9
- *     _list [ 4(4), 5(4), 8(2), 2(2), 6(2), 1(1), 9(1) ] end
- *       _ft   4           2                 1
+ *    _list [ 4(4), 5(4), 8(2), 2(2), 6(2), 1(1), 9(1) ] end
+ *     _bl    4           2                 1
  *    --------------------------------------------------
- *    noticed that, if we need to insert {k, f}, f = 1 or _ft[f-1] existed.
- *    former one means putting a k-v, latter one means getting a k, and increase frequence of k.
- * 
- *    list node structure: [key, val, freq]
- *      for %_kt            key  (  val  )
- *      for %_ft            (  val  )  key
+ *    a bucket holds a frequency and the head of its run, the buckets are linked from the highest frequency to the lowest,
+ *    in a run the most recently used is ahead, so the last element is the victim.
+ *    an access moves the element to the head of the bucket before (created if its frequency isn't the next one),
+ *    %_kt maps the key to the element and its bucket, no more hashing is needed.
+ *
+ *    the frequencies are halved once every %_age_factor * %size() accesses, the buckets falling on the same one are merged,
+ *    so the keys hot long ago leave at last. the aging is O(n), amortized O(1) for each access.
 */
 template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
  typename _Hash = std::hash<_Key>,
- typename _Alloc = std::allocator<std::pair<_Value, size_type>>
+ typename _Alloc = std::allocator<std::pair<_Value, size_type>>,
+ typename _Weigher = _unit_weigher
 > struct lfu_table;
 
 namespace {
 template <typename _ExtOp> struct _select_lfu_iter_action {
-    template <typename _Iter> auto operator()(_Iter _x) const {
-        return _ExtOp()(_x->first);
-    }
-};
-struct _select_freq_lfu_iter {
-    template <typename _Iter> auto operator()(_Iter _x) const {
-        return _x->second;
+    // _Tp == std::pair<list_t::iterator, bucket_list_t::iterator>
+    template <typename _Tp> auto operator()(const _Tp& _x) const {
+        return _ExtOp()(_x.first->first);
     }
 };
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher>
 struct lfu_table {
-    typedef lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc> self;
+    typedef lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher> self;
     typedef _Key key_type;
     typedef _Value value_type;
     typedef list<std::pair<_Value, size_type>, _Alloc> list_t;
     typedef typename list_t::node_type node_type;
     typedef typename list_t::iterator iterator;
     typedef typename list_t::const_iterator const_iterator;
-    typedef hash_table<_Key, iterator, _select_lfu_iter_action<_ExtKey>, true, _select_self, _Hash, _Alloc> key_table_t;
-    typedef hash_table<_Key, iterator, _select_freq_lfu_iter, true, _select_self, _Hash, _Alloc> freq_table_t;
+    struct freq_bucket {
+        size_type freq;
+        iterator head;
+    };
+    typedef list<freq_bucket, typename std::allocator_traits<_Alloc>::template rebind_alloc<freq_bucket>> bucket_list_t;
+    typedef typename bucket_list_t::iterator bucket_iterator;
+    typedef std::pair<iterator, bucket_iterator> entry_type;
+    typedef hash_table<_Key, entry_type, _select_lfu_iter_action<_ExtKey>, true, _select_lfu_iter_action<_ExtValue>, _Hash, _Alloc> key_table_t;
     typedef asso_container::type_traits<_Value, true> _ContainerTypeTraits;
     typedef typename _ContainerTypeTraits::mapped_type mapped_type;
 
+    static constexpr const size_type _S_default_age_factor = 10;
+
     list_t _l;
+    bucket_list_t _bl;  // buckets, from the highest frequency to the lowest
     key_table_t _kt;  // key table
-    freq_table_t _ft;  // frequence table
+    // the total weight allowed, %_Weigher gives the weight of an element
     size_type _capacity;
-    _select_lfu_iter_action<_ExtKey> _select_key;
-    // _ExtKey _select_key;
-    _select_freq_lfu_iter _select_freq;
+    size_type _weight;
+    // 0 : never age
+    size_type _age_factor;
+    size_type _accesses;  // since the last aging
+    // deadlines of the elements put with a ttl
+    timing_wheel<_Key, _Hash, _Alloc> _w;
 
 public:
 /// (de)constructor
-    lfu_table(size_type _capacity) : _capacity(_capacity) {}
-    lfu_table(const self& _rhs) : _l(_rhs._l), _kt(_rhs._kt), _ft(_rhs._ft), _capacity(_rhs._capacity) {}
+    lfu_table(size_type _capacity, size_type _age_factor = _S_default_age_factor)
+     : _capacity(_capacity), _weight(0), _age_factor(_age_factor), _accesses(0) {}
+    lfu_table(const self& _rhs) { _M_assign(_rhs); }
     self& operator=(const self& _rhs);
     virtual ~lfu_table() = default;
 
     size_type size() const { return _l.size(); }
     size_type capacity() const { return _capacity; }
+    // the total weight of the elements, no more than %capacity()
+    size_type weight() const { return _weight; }
     bool empty() const { return _l.empty(); }
-    void clear() { _ft.clear(); _kt.clear(); _l.clear(); }
+    void clear() { _kt.clear(); _bl.clear(); _l.clear(); _w.clear(); _weight = 0; _accesses = 0; }
     void resize(size_type _new_capacity);
+    // an expired element is erased and missed, even if %tick() hasn't reaped it yet
     const_iterator get(const key_type& _k);
+    /**
+     * @brief the element never expires (its former ttl is cancelled)
+     * @details the least frequently used are evicted until the weight fits in the capacity,
+     *   an element heavier than the capacity isn't cached, and the former one of its key is erased.
+    */
     void put(const value_type& _v);
+    // the element expires %_ttl after %now()
+    void put(const value_type& _v, tick_type _ttl);
+    /**
+     * @brief move the time to %_now, the elements expired are erased
+     * @return the number of elements erased
+     * @details no thread does it, the caller ticks at the precision it needs, amortized O(1) per element
+    */
+    size_type tick(tick_type _now);
+    tick_type now() const { return _w.now(); }
 
     const_iterator cbegin() const { return _l.cbegin(); }
     const_iterator cend() const { return _l.cend(); }
 
-    template <typename _K, typename _T, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const lfu_table<_K, _T, _H, _A>& _x);
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, typename _W> friend std::ostream& operator<<(std::ostream& _os, const lfu_table<_K, _T, _Ek, _Ev, _H, _A, _W>& _x);
 
     int check() const;
     void demo(std::istream& _is = std::cin, std::ostream& _os = std::cout);
 
 private:
-    iterator increase_freq(const key_type& _k);
-    void eliminate(size_type _step = 0);
+    void _M_assign(const self& _rhs);
+    void increase_freq(entry_type& _e);
+    // count an access, and age if it's time to
+    void _M_access();
+    void _M_age();
+    // evict until %_reserve more weight fits in the capacity
+    void eliminate(size_type _reserve = 0);
     void eliminate_last();
+    // unlink %_i from the run of %_b, %_b is erased if it gets empty
+    void _M_unlink(iterator _i, bucket_iterator _b);
+    void _M_erase(const key_type& _k);
     inline bool existed(const key_type& _k) const { return _kt.count(_k) != 0; }
-    inline size_type frequence(const key_type& _k) const { return existed(_k) ? _select_freq(*(_kt.find(_k))) : 0; }
+    inline size_type frequence(const key_type& _k) const { return existed(_k) ? (*(_kt.find(_k))).first->second : 0; }
 
     enum operator_id {
         __GET__, __PUT__,
@@ -110,102 +146,214 @@ private:
     }
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::operator=(const self& _rhs) -> self& {
-    if (&_rhs == this) return *this;
-    _l.operator=(_rhs._l);
-    _kt.operator=(_rhs._kt);
-    _ft.operator=(_rhs._ft);
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_assign(const self& _rhs) -> void {
+    _kt.clear(); _bl.clear(); _l.clear();
     _capacity = _rhs._capacity;
+    _weight = _rhs._weight;
+    _age_factor = _rhs._age_factor;
+    _accesses = _rhs._accesses;
+    _w.operator=(_rhs._w);
+    // the runs have distinct frequencies, a new one begins where the frequency changes
+    for (auto _i = _rhs._l.cbegin(); _i != _rhs._l.cend(); ++_i) {
+        _l.push_back(*_i);
+        iterator _n = _l.end(); --_n;
+        if (_bl.empty() || _bl.back().freq != _n->second) {
+            _bl.push_back({_n->second, _n});
+        }
+        bucket_iterator _bi = _bl.end(); --_bi;
+        _kt.insert({_n, _bi});
+    }
 };
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::resize(size_type _new_capacity) -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::operator=(const self& _rhs) -> self& {
+    if (&_rhs == this) return *this;
+    _M_assign(_rhs);
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::resize(size_type _new_capacity) -> void {
     _capacity = _new_capacity;
     eliminate();
 };
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::get(const key_type& _k) -> const_iterator {
-    if (!existed(_k)) return _l.cend();
-    increase_freq(_k);
-    const_iterator _i(*(_kt.find(_k)));
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::get(const key_type& _k) -> const_iterator {
+    auto _e = _kt.find(_k);
+    if (_e == _kt.end()) return _l.cend();
+    if (!_w.empty() && _w.expired(_k)) {
+        _M_erase(_k);
+        return _l.cend();
+    }
+    increase_freq(*_e);
+    const_iterator _i((*_e).first);
+    _M_access();
     return _i;
 };
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::put(const value_type& _v) -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::put(const value_type& _v) -> void {
     const key_type& _k = _ExtKey()(_v);
-    if (!existed(_k)) {
-        if (size() == _capacity) eliminate(1);
-        if (_ft.count(1) == 0) { // node whose freq = 1, not existed
-            iterator _inserted_i = _l.insert(_l.end(), {_v, 1});
-            _kt.update(_inserted_i);
-            _ft.update(_inserted_i);
+    if (!_w.empty()) {
+        _w.cancel(_k);
+    }
+    const size_type _n = _Weigher()(_v);
+    if (_n > _capacity) {
+        if (existed(_k)) _M_erase(_k);
+        return;
+    }
+    auto _e = _kt.find(_k);
+    if (_e == _kt.end()) {
+        eliminate(_n);
+        _weight += _n;
+        // the lowest bucket is at the back
+        if (_bl.empty() || _bl.back().freq != 1) {
+            _l.push_back({_v, 1});
+            iterator _i = _l.end(); --_i;
+            _bl.push_back({1, _i});
         }
         else {
-            iterator _ii = *(_ft.find(1));
-            iterator _inserted_i = _l.insert(_ii, {_v, 1});
-            _kt.update(_inserted_i);
-            _ft.update(_inserted_i);
+            _bl.back().head = _l.insert(_bl.back().head, {_v, 1});
         }
+        bucket_iterator _bi = _bl.end(); --_bi;
+        _kt.insert({_bi->head, _bi});
     }
     else {
-        iterator _i = increase_freq(_k);
-        size_type _f = _select_freq(_i);
-        _i = _l.insert(_l.erase(_i), {_v, _f});
-        _kt.update(_i);
-        _ft.update(_i);
+        entry_type& _x = *_e;
+        iterator _i = _x.first;
+        // the table reads the key through the node, so the old one is erased after it's relinked
+        iterator _ni = _l.insert(_i, {_v, _i->second});
+        if (_x.second->head == _i) _x.second->head = _ni;
+        _x.first = _ni;
+        _weight = _weight - _Weigher()(_i->first) + _n;
+        _l.erase(_i);
+        increase_freq(_x);
+        eliminate();
+    }
+    _M_access();
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::put(const value_type& _v, tick_type _ttl) -> void {
+    put(_v);
+    const key_type& _k = _ExtKey()(_v);
+    if (existed(_k)) {
+        _w.schedule(_k, _w.now() + _ttl);
     }
 };
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::tick(tick_type _now) -> size_type {
+    return _w.advance(_now, [this](const key_type& _k) { _M_erase(_k); });
+};
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::increase_freq(const key_type& _k) -> iterator {
-    if (!existed(_k)) return _l.end();
-    const size_type _freq = frequence(_k);
-    iterator _i = *(_kt.find(_k));
-    iterator _insert_i = *(_ft.count(_freq + 1) == 0 ? _ft.find(_freq) : _ft.find(_freq + 1));
-    if (*(_ft.find(_freq)) == _i) {
-        ++_i;
-        if (_i != _l.end() && _select_freq(_i) == _freq) {
-            *(_ft.find(_freq)) = _i;
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::increase_freq(entry_type& _e) -> void {
+    iterator _i = _e.first;
+    bucket_iterator _b = _e.second;
+    const size_type _freq = _i->second + 1;
+    bucket_iterator _p = _b;
+    if (_b != _bl.begin()) --_p;
+    if (_p != _b && _p->freq == _freq) {
+        _M_unlink(_i, _b);
+        _l.splice(_p->head, _l, _i);
+        _p->head = _i;
+    }
+    else {
+        // a new bucket between %_p and %_b, whose run is right before the one of %_b
+        if (_b->head == _i) {
+            iterator _n = _i; ++_n;
+            if (_n != _l.end() && _n->second == _b->freq) {
+                _b->head = _n;
+            }
+            else {
+                _b->freq = _freq;
+                _i->second = _freq;
+                return;
+            }
         }
         else {
-            _ft.erase(_freq);
+            _l.splice(_b->head, _l, _i);
         }
+        _p = _bl.insert(_b, {_freq, _i});
     }
-    iterator _inserted_i = _l.insert(_insert_i, *(*_kt.find(_k)));
-    (_inserted_i._const_cast())->second = _freq + 1;
-    _l.erase(*(_kt.find(_k)));
-    _kt.update(_inserted_i);
-    _ft.update(_inserted_i);
-    return _inserted_i;
+    _i->second = _freq;
+    _e.second = _p;
 };
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::eliminate(size_type _step) -> void {
-    if (_step == 0) {
-        while (_l.size() > _capacity) {
-            eliminate_last();
-        }
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_access() -> void {
+    if (_age_factor != 0 && ++_accesses >= _age_factor * size()) {
+        _M_age();
+        _accesses = 0;
     }
-    else {
-        while (_step > 0 && !_l.empty()) {
-            eliminate_last();
-            if (_step > 0) --_step;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_age() -> void {
+    // %_b : the next bucket to halve, %_t : the bucket of the current run after halving
+    bucket_iterator _b = _bl.begin();
+    bucket_iterator _t = _bl.end();
+    bool _merged = false;
+    for (iterator _i = _l.begin(); _i != _l.end(); ++_i) {
+        if (_b != _bl.end() && _b->head == _i) {
+            const size_type _freq = _b->freq > 1 ? _b->freq / 2 : 1;
+            _merged = _t != _bl.end() && _t->freq == _freq;
+            if (_merged) {
+                _b = _bl.erase(_b);
+            }
+            else {
+                _b->freq = _freq;
+                _t = _b++;
+            }
         }
+        _i->second = _t->freq;
+        if (_merged) {
+            (*(_kt.find(_ExtKey()(_i->first)))).second = _t;
+        }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::eliminate(size_type _reserve) -> void {
+    while (!_l.empty() && _weight + _reserve > _capacity) {
+        eliminate_last();
     }
 };
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::eliminate_last() -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::eliminate_last() -> void {
     if (!_l.empty()) {
         auto _back_i = _l.end(); --_back_i;
-        if (*(_ft.find(_select_freq(_back_i))) == _back_i) {
-            _ft.erase(_select_freq(_back_i));
+        // the last element is in the run of the lowest bucket
+        bucket_iterator _bi = _bl.end(); --_bi;
+        _M_unlink(_back_i, _bi);
+        const key_type& _k = _ExtKey()(_back_i->first);
+        if (!_w.empty()) {
+            _w.cancel(_k);
         }
-        _kt.erase(_select_key(_back_i));
+        _weight -= _Weigher()(_back_i->first);
+        _kt.erase(_k);
         _l.pop_back();
     }
 };
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_unlink(iterator _i, bucket_iterator _b) -> void {
+    if (_b->head == _i) {
+        iterator _n = _i; ++_n;
+        if (_n != _l.end() && _n->second == _i->second) {
+            _b->head = _n;
+        }
+        else {
+            _bl.erase(_b);
+        }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_erase(const key_type& _k) -> void {
+    _w.cancel(_k);
+    const entry_type _e = *(_kt.find(_k));
+    _M_unlink(_e.first, _e.second);
+    _weight -= _Weigher()(_e.first->first);
+    _kt.erase(_k);
+    _l.erase(_e.first);
+};
 
-template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A> auto
-operator<<(std::ostream& _os, const lfu_table<_K, _T, _Ek, _Ev, _H, _A>& _x)-> std::ostream& {
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, typename _W> auto
+operator<<(std::ostream& _os, const lfu_table<_K, _T, _Ek, _Ev, _H, _A, _W>& _x)-> std::ostream& {
     _os << '[';
     for (auto _i = _x._l.cbegin(); _i != _x._l.cend(); ++_i) {
         // _os << '{' << _i->first << '}';
@@ -218,13 +366,34 @@ operator<<(std::ostream& _os, const lfu_table<_K, _T, _Ek, _Ev, _H, _A>& _x)-> s
     return _os << ']';
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::check() const -> int {
-    return 0;
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::check() const -> int {
+    if (_w.size() > _l.size()) return 1;
+    const int _r = _w.check();
+    if (_r != 0) return _r;
+    size_type _sum = 0;
+    for (auto _i = _l.cbegin(); _i != _l.cend(); ++_i) {
+        _sum += _Weigher()(_i->first);
+    }
+    if (_sum != _weight || _weight > _capacity) return 4;
+    // the runs from the highest frequency to the lowest, each element indexed with its bucket
+    if (_kt.size() != _l.size()) return 5;
+    auto _b = _bl.cbegin();
+    auto _t = _bl.cend();
+    for (auto _i = _l.cbegin(); _i != _l.cend(); ++_i) {
+        if (_b != _bl.cend() && const_iterator(_b->head) == _i) {
+            if (_t != _bl.cend() && _t->freq <= _b->freq) return 5;
+            _t = _b++;
+        }
+        if (_t == _bl.cend() || _i->second != _t->freq) return 5;
+        const auto _e = _kt.find(_ExtKey()(_i->first));
+        if (_e == _kt.cend() || const_iterator((*_e).first) != _i || &*((*_e).second) != &*_t) return 5;
+    }
+    return _b == _bl.cend() ? 0 : 5;
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lfu_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::demo(std::istream& _is, std::ostream& _os) -> void {
     _os << '[' << typeid(asp::decay_t<self>).name() << ']' << std::endl;
     _is.sync_with_stdio(false);
     std::string _op;
@@ -177,9 +177,18 @@ public:
         _p->unhook();
         _p->hook(&mark);
     }
+    // move %_pos of %_x before %_before, the node is relinked rather than copied, so iterators stay valid
+    void splice(const_iterator _before, self& _x, const_iterator _pos) {
+        node_type* _p = _pos._const_cast()._ptr;
+        if (_p == &_x.mark || _p == _before._const_cast()._ptr) return;
+        _p->unhook();
+        _p->hook(_before._const_cast()._ptr);
+        --_x.m_element_count;
+        ++m_element_count;
+    }
 
     /// ostream
-    template <typename _R> friend std::ostream& operator<<(std::ostream& os, const list<_R>& l) {
+    friend std::ostream& operator<<(std::ostream& os, const self& l) {
         os << '[';
         for (auto p = l.cbegin(); p != l.cend(); ++p) {
             os << p;
@@ -7,17 +7,19 @@ namespace asp {
 
 template <typename _Key, typename _Tp,
  typename _Hash = std::hash<_Key>,
- typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>
+ typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>,
+ typename _Weigher = _unit_weigher
 > class lru_map;
 template <typename _Tp,
  typename _Hash = std::hash<_Tp>,
- typename _Alloc = std::allocator<_Tp>
+ typename _Alloc = std::allocator<_Tp>,
+ typename _Weigher = _unit_weigher
 > class lru_set;
 
-template <typename _Key, typename _Tp, typename _Hash, typename _Alloc>
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, typename _Weigher>
 class lru_map {
-    typedef lru_map<_Key, _Tp, _Hash, _Alloc> self;
-    typedef lru_table<_Key, std::pair<const _Key, _Tp>, _select_0x, _select_1x, _Hash, _Alloc> lru_t;
+    typedef lru_map<_Key, _Tp, _Hash, _Alloc, _Weigher> self;
+    typedef lru_table<_Key, std::pair<const _Key, _Tp>, _select_0x, _select_1x, _Hash, _Alloc, _Weigher> lru_t;
     typedef typename lru_t::key_type key_type;
     typedef typename lru_t::value_type value_type;
     typedef typename lru_t::mapped_type mapped_type;
@@ -41,16 +43,19 @@ public:
 
     size_type size() const { return _l.size(); }
     size_type capacity() const { return _l.capacity(); }
+    size_type weight() const { return _l.weight(); }
     bool empty() const { return _l.empty(); }
     void clear() { _l.clear(); }
     void resize(size_type _new_capacity) { _l.resize(_new_capacity); }
     const_iterator get(const key_type& _k) { return _l.get(_k); }
     void put(const value_type& _v) { _l.put(_v); }
+    void put(const value_type& _v, tick_type _ttl) { _l.put(_v, _ttl); }
+    size_type tick(tick_type _now) { return _l.tick(_now); }
 
     const_iterator cbegin() const { return _l.cbegin(); }
     const_iterator cend() const { return _l.cend(); }
 
-    template <typename _K, typename _T, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const lru_map<_K, _T, _H, _A>& _x);
+    template <typename _K, typename _T, typename _H, typename _A, typename _W> friend std::ostream& operator<<(std::ostream& _os, const lru_map<_K, _T, _H, _A, _W>& _x);
 
     int check() const;
     void demo(std::istream& _is = std::cin, std::ostream& _os = std::cout);
@@ -73,10 +78,10 @@ private:
     }
 };
 
-template <typename _Tp, typename _Hash, typename _Alloc>
+template <typename _Tp, typename _Hash, typename _Alloc, typename _Weigher>
 class lru_set {
-    typedef lru_set<_Tp, _Hash, _Alloc> self;
-    typedef lru_table<_Tp, _Tp, _select_self, _select_self, _Hash, _Alloc> lru_t;
+    typedef lru_set<_Tp, _Hash, _Alloc, _Weigher> self;
+    typedef lru_table<_Tp, _Tp, _select_self, _select_self, _Hash, _Alloc, _Weigher> lru_t;
     typedef typename lru_t::key_type key_type;
     typedef typename lru_t::value_type value_type;
     typedef typename lru_t::mapped_type mapped_type;
@@ -98,16 +103,19 @@ public:
 
     size_type size() const { return _l.size(); }
     size_type capacity() const { return _l.capacity(); }
+    size_type weight() const { return _l.weight(); }
     bool empty() const { return _l.empty(); }
     void clear() { _l.clear(); }
     void resize(size_type _new_capacity) { _l.resize(_new_capacity); }
     const_iterator get(const key_type& _k) { return _l.get(_k); }
     void put(const value_type& _v) { _l.put(_v); }
+    void put(const value_type& _v, tick_type _ttl) { _l.put(_v, _ttl); }
+    size_type tick(tick_type _now) { return _l.tick(_now); }
 
     const_iterator cbegin() const { return _l.cbegin(); }
     const_iterator cend() const { return _l.cend(); }
 
-    template <typename _T, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const lru_set<_T, _H, _A>& _x);
+    template <typename _T, typename _H, typename _A, typename _W> friend std::ostream& operator<<(std::ostream& _os, const lru_set<_T, _H, _A, _W>& _x);
 
     int check() const;
     void demo(std::istream& _is = std::cin, std::ostream& _os = std::cout);
@@ -131,12 +139,12 @@ private:
 };
 
 
-template <typename _Key, typename _Tp, typename _Hash, typename _Alloc> auto
-lru_map<_Key, _Tp, _Hash, _Alloc>::check() const -> int {
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_map<_Key, _Tp, _Hash, _Alloc, _Weigher>::check() const -> int {
     return 0;
 };
-template <typename _Key, typename _Tp, typename _Hash, typename _Alloc> auto
-lru_map<_Key, _Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void {
+template <typename _Key, typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_map<_Key, _Tp, _Hash, _Alloc, _Weigher>::demo(std::istream& _is, std::ostream& _os) -> void {
     _os << '[' << typeid(asp::decay_t<self>).name() << ']' << std::endl;
     _is.sync_with_stdio(false);
     std::string _op;
@@ -193,20 +201,20 @@ lru_map<_Key, _Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) ->
     }
     __details__::_M_reset_cin(_is);
 };
-template <typename _K, typename _T, typename _H, typename _A> auto
-operator<<(std::ostream& _os, const lru_map<_K, _T, _H, _A>& _x)
+template <typename _K, typename _T, typename _H, typename _A, typename _W> auto
+operator<<(std::ostream& _os, const lru_map<_K, _T, _H, _A, _W>& _x)
 -> std::ostream& {
     _os << _x._l;
     return _os;
 };
 
 
-template <typename _Tp, typename _Hash, typename _Alloc> auto
-lru_set<_Tp, _Hash, _Alloc>::check() const -> int {
+template <typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_set<_Tp, _Hash, _Alloc, _Weigher>::check() const -> int {
     return 0;
 };
-template <typename _Tp, typename _Hash, typename _Alloc> auto
-lru_set<_Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void {
+template <typename _Tp, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_set<_Tp, _Hash, _Alloc, _Weigher>::demo(std::istream& _is, std::ostream& _os) -> void {
     _os << '[' << typeid(asp::decay_t<self>).name() << ']' << std::endl;
     _is.sync_with_stdio(false);
     std::string _op;
@@ -259,8 +267,8 @@ lru_set<_Tp, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void
     }
     __details__::_M_reset_cin(_is);
 };
-template <typename _T, typename _H, typename _A> auto
-operator<<(std::ostream& _os, const lru_set<_T, _H, _A>& _x)
+template <typename _T, typename _H, typename _A, typename _W> auto
+operator<<(std::ostream& _os, const lru_set<_T, _H, _A, _W>& _x)
 -> std::ostream& {
     _os << _x._l;
     return _os;
@@ -4,6 +4,7 @@
 #include "associative_container_aux.hpp"
 #include "hash_table.hpp"
 #include "list.hpp"
+#include "timing_wheel.hpp"
 #include <unordered_map>
 
 #include "basic_io.hpp"
@@ -12,7 +13,8 @@ namespace asp {
 
 template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
  typename _Hash = std::hash<_Key>,
- typename _Alloc = std::allocator<_Value>
+ typename _Alloc = std::allocator<_Value>,
+ typename _Weigher = _unit_weigher
 > struct lru_table;
 
 namespace {
@@ -24,9 +26,9 @@ template <typename _ExtOp> struct _select_lru_iter_action {
 };
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher>
 struct lru_table {
-    typedef lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc> self;
+    typedef lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher> self;
     typedef _Key key_type;
     typedef _Value value_type;
     typedef list<_Value, _Alloc> list_t;
@@ -38,35 +40,63 @@ struct lru_table {
 
     list_t _l;
     hash_table_t _h;
+    // the total weight allowed, %_Weigher gives the weight of an element
     size_type _capacity;
+    size_type _weight;
+    // deadlines of the elements put with a ttl
+    timing_wheel<_Key, _Hash, _Alloc> _w;
 
 public:
     typedef typename list_t::const_iterator const_iterator;
 
 /// (de)constructor
-    lru_table(size_type _capacity) : _capacity(_capacity) {}
-    lru_table(const self& _rhs) : _l(_rhs._l), _h(_rhs._h), _capacity(_rhs._capacity) {}
+    lru_table(size_type _capacity) : _capacity(_capacity), _weight(0) {}
+    lru_table(const self& _rhs) { _M_assign(_rhs); }
     self& operator=(const self& _rhs);
     virtual ~lru_table() = default;
 
     size_type size() const { return _l.size(); }
     size_type capacity() const { return _capacity; }
+    // the total weight of the elements, no more than %capacity()
+    size_type weight() const { return _weight; }
     bool empty() const { return _l.empty(); }
-    void clear() { _h.clear(); _l.clear(); }
+    void clear() { _h.clear(); _l.clear(); _w.clear(); _weight = 0; }
     void resize(size_type _new_capacity);
+    // an expired element is erased and missed, even if %tick() hasn't reaped it yet
     const_iterator get(const key_type& _k);
+    /**
+     * @brief the element never expires (its former ttl is cancelled)
+     * @details the least recently used are evicted until the weight fits in the capacity,
+     *   an element heavier than the capacity isn't cached, and the former one of its key is erased.
+    */
     void put(const value_type& _v);
+    // the element expires %_ttl after %now()
+    void put(const value_type& _v, tick_type _ttl);
+    // the element of %_k without updating the recency (read only), cend() if none or expired
+    const_iterator peek(const key_type& _k) const;
+    /**
+     * @brief move the time to %_now, the elements expired are erased
+     * @return the number of elements erased
+     * @details no thread does it, the caller ticks at the precision it needs, amortized O(1) per element
+    */
+    size_type tick(tick_type _now);
+    tick_type now() const { return _w.now(); }
+    // make %_i the most recently used
+    void touch(const_iterator _i) { _l.move_2_front(_i); }
 
     const_iterator cbegin() const { return _l.cbegin(); }
     const_iterator cend() const { return _l.cend(); }
 
-    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const lru_table<_K, _T, _Ek, _Ev, _H, _A>& _x);
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, typename _W> friend std::ostream& operator<<(std::ostream& _os, const lru_table<_K, _T, _Ek, _Ev, _H, _A, _W>& _x);
 
     int check() const;
     void demo(std::istream& _is = std::cin, std::ostream& _os = std::cout);
 
 private:
+    // the table is rebuilt, since the iterators of %_rhs._h point into %_rhs._l
+    void _M_assign(const self& _rhs);
     void eliminate();
+    void _M_erase(const key_type& _k);
 
     enum operator_id {
         __GET__, __PUT__,
@@ -85,65 +115,130 @@ private:
     }
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::operator=(const self& _rhs) -> self& {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::operator=(const self& _rhs) -> self& {
     if (&_rhs == this) return *this;
-    _l.operator=(_rhs._l);
-    _h.operator=(_rhs._h);
-    _capacity = _rhs._capacity;
+    _M_assign(_rhs);
+    return *this;
 }
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::resize(size_type _new_capacity) -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_assign(const self& _rhs) -> void {
+    _h.clear(); _l.clear();
+    _capacity = _rhs._capacity;
+    _weight = _rhs._weight;
+    _w.operator=(_rhs._w);
+    for (auto _i = _rhs._l.cbegin(); _i != _rhs._l.cend(); ++_i) {
+        _l.push_back(*_i);
+        iterator _n = _l.end(); --_n;
+        _h.insert(_n);
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::resize(size_type _new_capacity) -> void {
     _capacity = _new_capacity;
     eliminate();
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::get(const key_type& _k) -> const_iterator {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::get(const key_type& _k) -> const_iterator {
     if (_h.count(_k) == 0) return _l.cend();
+    if (!_w.empty() && _w.expired(_k)) {
+        _M_erase(_k);
+        return _l.cend();
+    }
     const_iterator _i = *(_h.find(_k));
     _l.move_2_front(_i);
     return _i;
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::put(const value_type& _v) -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::peek(const key_type& _k) const -> const_iterator {
+    const auto _i = _h.find(_k);
+    if (_i == _h.cend() || (!_w.empty() && _w.expired(_k))) return _l.cend();
+    return const_iterator(*_i);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::put(const value_type& _v) -> void {
     const key_type& _k = _ExtKey()(_v);
-    if (_h.count(_k) == 0) {
-        _l.push_front(_v);
-        _h.insert(_l.begin());
-        eliminate();
+    if (!_w.empty()) {
+        _w.cancel(_k);
     }
-    else {
+    const size_type _n = _Weigher()(_v);
+    if (_n > _capacity) {
+        if (_h.count(_k) != 0) _M_erase(_k);
+        return;
+    }
+    if (_h.count(_k) != 0) {
         iterator _i = *(_h.find(_k));
         // (*_i).second = _ExtValue()(_v);
+        // the table holds the iterator of the old node
+        _weight -= _Weigher()(*_i);
+        _h.erase(_k);
         _l.erase(_i);
-        _l.push_front(_v);
-        // _l.move_2_front(_i);
     }
+    _l.push_front(_v);
+    _h.insert(_l.begin());
+    _weight += _n;
+    eliminate();
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::put(const value_type& _v, tick_type _ttl) -> void {
+    put(_v);
+    const key_type& _k = _ExtKey()(_v);
+    if (_h.count(_k) != 0) {
+        _w.schedule(_k, _w.now() + _ttl);
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::tick(tick_type _now) -> size_type {
+    return _w.advance(_now, [this](const key_type& _k) { _M_erase(_k); });
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::eliminate() -> void {
-    while (_l.size() > _capacity) {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::eliminate() -> void {
+    while (_weight > _capacity) {
+        if (!_w.empty()) {
+            _w.cancel(_ExtKey()(_l.back()));
+        }
+        _weight -= _Weigher()(_l.back());
         _h.erase(_ExtKey()(_l.back()));
         _l.pop_back();
     }
 };
 
-template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A> auto
-operator<<(std::ostream& _os, const lru_table<_K, _T, _Ek, _Ev, _H, _A>& _x)-> std::ostream& {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::_M_erase(const key_type& _k) -> void {
+    _w.cancel(_k);
+    iterator _i = *(_h.find(_k));
+    _weight -= _Weigher()(*_i);
+    _h.erase(_k);
+    _l.erase(_i);
+};
+
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, typename _W> auto
+operator<<(std::ostream& _os, const lru_table<_K, _T, _Ek, _Ev, _H, _A, _W>& _x)-> std::ostream& {
     return _os << _x._l;
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::check() const -> int {
-    return 0;
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::check() const -> int {
+    if (_w.size() > _l.size()) return 1;
+    const int _r = _w.check();
+    if (_r != 0) return _r;
+    size_type _sum = 0;
+    for (auto _i = _l.cbegin(); _i != _l.cend(); ++_i) {
+        _sum += _Weigher()(*_i);
+    }
+    return _sum == _weight && _weight <= _capacity ? 0 : 4;
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
-lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::demo(std::istream& _is, std::ostream& _os) -> void {
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, typename _Weigher> auto
+lru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _Weigher>::demo(std::istream& _is, std::ostream& _os) -> void {
     _os << '[' << typeid(asp::decay_t<self>).name() << ']' << std::endl;
     _is.sync_with_stdio(false);
     std::string _op;
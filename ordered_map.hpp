@@ -5,18 +5,26 @@
 
 #include "basic_param.hpp"
 #include "rb_tree.hpp"
+#include "bplus_tree.hpp"
+#include "persistent_rb_tree.hpp"
+#include "splay_tree.hpp"
+#include "frozen_tree.hpp"
 
 namespace asp {
 
+/**
+ * @tparam _Tree the backend ordered tree, which exposes the same interface as @rb_tree (e.g. @bplus_tree)
+*/
 template <typename _Key, typename _Tp,
  typename _Compare = std::less<_Key>,
- typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>
+ typename _Alloc = std::allocator<std::pair<const _Key, _Tp>>,
+ template <typename, typename, typename, bool, typename, typename, typename...> class _Tree = rb_tree
 > class ordered_map;
 
-template <typename _Key, typename _Tp, typename _Compare, typename _Alloc>
+template <typename _Key, typename _Tp, typename _Compare, typename _Alloc, template <typename, typename, typename, bool, typename, typename, typename...> class _Tree>
 class ordered_map {
-    typedef ordered_map<_Key, _Tp, _Compare, _Alloc> self;
-    typedef rb_tree<_Key, std::pair<const _Key, _Tp>, _select_0x, true, _Compare, _Alloc> map_rbt;
+    typedef ordered_map<_Key, _Tp, _Compare, _Alloc, _Tree> self;
+    typedef _Tree<_Key, std::pair<const _Key, _Tp>, _select_0x, true, _Compare, _Alloc> map_rbt;
     map_rbt _r;
 public:
     typedef typename map_rbt::key_type key_type;
@@ -30,6 +38,8 @@ public:
     typedef typename map_rbt::ext_iterator ext_iterator;
     typedef typename map_rbt::ext_key ext_key;
     typedef typename map_rbt::ext_value ext_value;
+    // the backend may store another value_type than %_Alloc (e.g. @flat_tree), so rebind to its own
+    typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<value_type> frozen_allocator_type;
 
 /// (de)constructor
     ordered_map() = default;
@@ -48,20 +58,32 @@ public:
     size_type erase(const key_type& _k) { return _r.erase(_k); }
     size_type count(const key_type& _k) const { return _r.count(_k); }
     void clear() { _r.clear(); }
+    // a point-in-time copy, O(1) with @persistent_rb_tree backend
+    self snapshot() const { return self(*this); }
+    // an immutable sorted copy for read-only lookups, see @frozen_tree
+    template <typename _Layout = eytzinger_layout> frozen_tree<key_type, value_type, ext_key, true, key_compare, frozen_allocator_type, _Layout> freeze() const {
+        return frozen_tree<key_type, value_type, ext_key, true, key_compare, frozen_allocator_type, _Layout>(cbegin(), cend(), size());
+    }
     iterator find(const key_type& _k) { return _r.find(_k); }
     const_iterator find(const key_type& _k) const { return _r.find(_k); }
+    iterator lower_bound(const key_type& _k) { return _r.lower_bound(_k); }
+    const_iterator lower_bound(const key_type& _k) const { return _r.lower_bound(_k); }
+    iterator upper_bound(const key_type& _k) { return _r.upper_bound(_k); }
+    const_iterator upper_bound(const key_type& _k) const { return _r.upper_bound(_k); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k) { return _r.equal_range(_k); }
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const { return _r.equal_range(_k); }
 #ifdef _CONTAINER_CHECK_
     int check() const { return _r.check(); }
 #endif // _CONTAINER_CHECK_
 
 /// output
-    template <typename _K, typename _T, typename _C, typename _A>
-     friend std::ostream& operator<<(std::ostream& os, const ordered_map<_K, _T, _C, _A>& _um);
+    template <typename _K, typename _T, typename _C, typename _A, template <typename, typename, typename, bool, typename, typename, typename...> class _Tr>
+     friend std::ostream& operator<<(std::ostream& os, const ordered_map<_K, _T, _C, _A, _Tr>& _um);
     // friend std::ostream& operator<<(std::ostream& os, const const_iterator& _i);
 };
 
-template <typename _Key, typename _Tp, typename _Comp, typename _Alloc> auto
-operator<<(std::ostream& os, const ordered_map<_Key, _Tp, _Comp, _Alloc>& _um)
+template <typename _Key, typename _Tp, typename _Comp, typename _Alloc, template <typename, typename, typename, bool, typename, typename, typename...> class _Tree> auto
+operator<<(std::ostream& os, const ordered_map<_Key, _Tp, _Comp, _Alloc, _Tree>& _um)
 -> std::ostream& {
     os << _um._r;
     return os;
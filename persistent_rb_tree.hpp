@@ -0,0 +1,671 @@
+#ifndef _ASP_PERSISTENT_RB_TREE_HPP_
+#define _ASP_PERSISTENT_RB_TREE_HPP_
+
+#include "rb_tree.hpp"
+
+#include <atomic>
+
+namespace asp {
+
+struct persistent_rb_tree_node_base;
+template <typename _Tp> struct persistent_rb_tree_node;
+template <typename _Value, typename _Alloc> struct persistent_rb_tree_alloc;
+template <typename _Tp> struct persistent_rb_tree_const_iterator;
+
+/**
+ * @brief persistent (path-copying) red black tree
+ * @details
+ *   nodes are reference counted and structurally shared between trees,
+ *   so that copying a tree (e.g. %snapshot()) costs O(1).
+ *   a node is never modified once it's shared (%_ref > 1) :
+ *     every write descends from the root top-down, and copies each shared node on its way
+ *     (copy-on-write, see %_M_unshare), so only O(log n) nodes are copied per write,
+ *     and the nodes that belong to this tree only are modified in place.
+ *   snapshots can be searched and iterated on any thread without locks,
+ *   while one writer keeps mutating the tree it was taken from.
+ *   the tree itself isn't thread-safe, as other containers.
+ * @note
+ *   there is no parent link (a shared node may have many parents),
+ *   so insertion and erasion are the top-down variants (single pass, no stack),
+ *   and iterators keep the path from root.
+ *   all iterators are constant, because the values may be shared.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> class persistent_rb_tree;
+
+namespace __persistent_rb_tree__ {
+typedef persistent_rb_tree_node_base _Base;
+bool _S_is_red(const _Base* _x);
+/**
+ * @brief rotate %_x towards %_dir (0 : left, 1 : right), red %_x and black the new subtree root.
+ * @return the new subtree root
+*/
+_Base* _S_single_rotate(_Base* _x, int _dir);
+_Base* _S_double_rotate(_Base* _x, int _dir);
+};
+
+struct persistent_rb_tree_node_base {
+    typedef persistent_rb_tree_node_base self;
+    std::atomic<size_type> _ref;
+    _Rb_tree_color _color = _S_red;
+    self* _link[2] = {nullptr, nullptr}; // 0 : left child, 1 : right child
+
+    persistent_rb_tree_node_base() : _ref(1) {}
+};
+
+template <typename _Tp> struct persistent_rb_tree_node : public persistent_rb_tree_node_base {
+    typedef persistent_rb_tree_node_base base;
+    typedef persistent_rb_tree_node<_Tp> self;
+    using value_type = _Tp;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+    persistent_rb_tree_node(const value_type& _x) : base(), _v(_x) {}
+    template <typename... _Args> persistent_rb_tree_node(_Args&&... _args) : base(), _v(std::forward<_Args>(_args)...) {}
+
+    value_type& val() { return _v; }
+    const value_type& val() const { return _v; }
+    value_type* valptr() { return &_v; }
+    const value_type* valptr() const { return &_v; }
+
+private:
+    value_type _v;
+};
+
+template <typename _Value, typename _Alloc> struct persistent_rb_tree_alloc
+: public _Alloc {
+    typedef persistent_rb_tree_node<_Value> node_type;
+    typedef typename node_type::base node_base;
+
+    typedef _Alloc elt_allocator_type;
+    typedef std::allocator_traits<elt_allocator_type> elt_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<node_type> node_allocator_type;
+    typedef std::allocator_traits<node_allocator_type> node_alloc_traits;
+
+    elt_allocator_type& _M_get_elt_allocator() { return *static_cast<elt_allocator_type*>(this); }
+    const elt_allocator_type& _M_get_elt_allocator() const { return *static_cast<const elt_allocator_type*>(this); }
+    node_allocator_type _M_get_node_allocator() const { return node_allocator_type(_M_get_elt_allocator()); }
+
+    template <typename... _Args> node_type* _M_allocate_node(_Args&&... _args) {
+        node_allocator_type _node_alloc = _M_get_node_allocator();
+        auto _ptr = node_alloc_traits::allocate(_node_alloc, 1);
+        node_type* _p = std::addressof(*_ptr);
+        node_alloc_traits::construct(_node_alloc, _p, std::forward<_Args>(_args)...);
+        return _p;
+    }
+    void _M_deallocate_node(node_type* _p) {
+        node_allocator_type _node_alloc = _M_get_node_allocator();
+        node_alloc_traits::destroy(_node_alloc, _p);
+        node_alloc_traits::deallocate(_node_alloc, _p, 1);
+    }
+
+    static node_base* _S_share(node_base* _x) {
+        if (_x != nullptr) {
+            _x->_ref.fetch_add(1, std::memory_order_relaxed);
+        }
+        return _x;
+    }
+    /**
+     * @brief drop a reference of %_x, and deallocate the nodes which are no longer referenced.
+    */
+    void _M_release(node_base* _x) {
+        while (_x != nullptr && _x->_ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _M_release(_x->_link[0]);
+            node_base* _r = _x->_link[1];
+            _M_deallocate_node(static_cast<node_type*>(_x));
+            _x = _r;
+        }
+    }
+    /**
+     * @brief make the node in %_slot owned by %_slot only (copy it if it's shared).
+     * @details the owner of %_slot must have been unshared, so that %_ref counts the parents correctly.
+     * @return the node in %_slot after unsharing
+    */
+    node_base* _M_unshare(node_base*& _slot) {
+        node_base* const _x = _slot;
+        if (_x == nullptr || _x->_ref.load(std::memory_order_acquire) == 1) {
+            return _x;
+        }
+        node_type* _y = _M_allocate_node(static_cast<node_type*>(_x)->val());
+        _y->_color = _x->_color;
+        _y->_link[0] = _S_share(_x->_link[0]);
+        _y->_link[1] = _S_share(_x->_link[1]);
+        _slot = _y;
+        _M_release(_x);
+        return _y;
+    }
+};
+
+/**
+ * @brief constant iterator of @persistent_rb_tree
+ * @details it keeps the path from root to the current node, %_depth == 0 for end().
+*/
+template <typename _Tp> struct persistent_rb_tree_const_iterator {
+    typedef asp::bidirectional_iterator_tag iterator_category;
+    typedef persistent_rb_tree_node<_Tp> node_type;
+    typedef persistent_rb_tree_node_base node_base;
+    typedef typename node_type::value_type value_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+    typedef asp::difference_type difference_type;
+    typedef persistent_rb_tree_const_iterator<_Tp> self;
+
+    // the height of red black tree is less than 2*log(n+1), enough for 2^47 elements
+    static constexpr int _S_max_depth = 96;
+
+    const node_base* _root = nullptr;
+    const node_base* _path[_S_max_depth];
+    int _depth = 0;
+
+    persistent_rb_tree_const_iterator() = default;
+    persistent_rb_tree_const_iterator(const node_base* _r) : _root(_r) {}
+
+    const value_type& operator*() const { return _M_node()->val(); }
+    const value_type* operator->() const { return _M_node()->valptr(); }
+    self& operator++() { _M_inc(); return *this; }
+    self operator++(int) { self _ret = *this; _M_inc(); return _ret; }
+    self& operator--() { _M_dec(); return *this; }
+    self operator--(int) { self _ret = *this; _M_dec(); return _ret; }
+    operator bool() const { return _depth != 0; }
+    friend bool operator==(const self& _x, const self& _y) { return _x._M_current() == _y._M_current(); }
+    friend bool operator!=(const self& _x, const self& _y) { return _x._M_current() != _y._M_current(); }
+    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const persistent_rb_tree_const_iterator<_T>& _r);
+
+    const node_base* _M_current() const { return _depth == 0 ? nullptr : _path[_depth - 1]; }
+    const node_type* _M_node() const { return static_cast<const node_type*>(_path[_depth - 1]); }
+    // push %_x and its descendants along %_dir
+    void _M_descend(const node_base* _x, int _dir) {
+        for (; _x != nullptr; _x = _x->_link[_dir]) {
+            _path[_depth++] = _x;
+        }
+    }
+    void _M_inc() {
+        const node_base* _x = _path[_depth - 1];
+        if (_x->_link[1] != nullptr) {
+            _M_descend(_x->_link[1], 0);
+            return;
+        }
+        do { // climb until %_x is a left child
+            _x = _path[--_depth];
+        } while (_depth > 0 && _path[_depth - 1]->_link[1] == _x);
+    }
+    void _M_dec() {
+        if (_depth == 0) { // end()
+            _M_descend(_root, 1);
+            return;
+        }
+        const node_base* _x = _path[_depth - 1];
+        if (_x->_link[0] != nullptr) {
+            _M_descend(_x->_link[0], 1);
+            return;
+        }
+        do { // climb until %_x is a right child
+            _x = _path[--_depth];
+        } while (_depth > 0 && _path[_depth - 1]->_link[0] == _x);
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>>
+class persistent_rb_tree : public persistent_rb_tree_alloc<_Value, _Alloc> {
+public:
+    typedef persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc> self;
+    typedef persistent_rb_tree_alloc<_Value, _Alloc> base;
+    typedef typename base::elt_allocator_type elt_allocator_type;
+    typedef typename base::elt_alloc_traits elt_alloc_traits;
+    typedef typename base::node_allocator_type node_allocator_type;
+    typedef typename base::node_alloc_traits node_alloc_traits;
+
+    typedef _Key key_type;
+    typedef _Comp key_compare;
+    typedef typename base::node_type node_type;
+    typedef typename base::node_base node_base;
+    typedef node_base* base_ptr;
+    typedef const node_base* const_base_ptr;
+
+    typedef typename node_type::value_type value_type;
+
+    typedef persistent_rb_tree_const_iterator<value_type> iterator;
+    typedef persistent_rb_tree_const_iterator<value_type> const_iterator;
+
+    typedef asp::conditional_t<_UniqueKey, std::pair<iterator, bool>, iterator> ireturn_type;
+
+    typedef asso_container::type_traits<value_type, _UniqueKey> _ContainerTypeTraits;
+
+    typedef typename _ContainerTypeTraits::insert_status insert_status;
+    typedef typename _ContainerTypeTraits::ext_iterator ext_iterator;
+    typedef typename _ContainerTypeTraits::ext_value ext_value;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+    typedef _ExtKey ext_key;
+
+    base_ptr _m_root = nullptr;
+    size_type _m_node_count = 0;
+    _ExtKey _m_extract_key;
+    _Comp _m_key_compare;
+
+    static const value_type& _S_value(const_base_ptr _x) { return static_cast<const node_type*>(_x)->val(); }
+    static key_type _S_key(const_base_ptr _x) { return _ExtKey()(_S_value(_x)); }
+    static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
+
+    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
+     friend std::ostream& operator<<(std::ostream& os, const persistent_rb_tree<_K, _V, _EK, _UK, _C, _A>& _h);
+
+public:
+    persistent_rb_tree() = default;
+    // share all nodes with %_rbt, O(1)
+    persistent_rb_tree(const self& _rbt);
+    self& operator=(const self& _rbt);
+    virtual ~persistent_rb_tree();
+    /**
+     * @brief take a point-in-time view of the tree in O(1).
+     * @details the snapshot shares nodes with this tree, and is unaffected by later writes.
+    */
+    self snapshot() const { return self(*this); }
+
+    iterator begin() { return cbegin(); }
+    const_iterator cbegin() const;
+    iterator end() { return cend(); }
+    const_iterator cend() const { return const_iterator(_m_root); }
+    size_type size() const { return _m_node_count; }
+    bool empty() const { return _m_node_count == 0; }
+
+    const_iterator find(const key_type& _k) const;
+    size_type count(const key_type& _k) const;
+    void clear();
+    ireturn_type insert(const value_type& _v);
+    size_type erase(const key_type& _k);
+
+    const_iterator lower_bound(const key_type& _k) const;
+    const_iterator upper_bound(const key_type& _k) const;
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const;
+
+    // used for test
+    int check() const;
+
+protected:
+    // return _x < _y;
+    bool _M_key_compare(const key_type& _x, const key_type& _y) const { return _m_key_compare(_x, _y); }
+
+    // @brief unique_insert
+    std::pair<iterator, bool> _M_insert(const value_type& _v, asp::true_type);
+    // @brief multi_insert
+    iterator _M_insert(const value_type& _v, asp::false_type);
+
+private:
+    /**
+     * @brief top-down insertion, equal keys are inserted at the right side.
+    */
+    void _M_insert_aux(const value_type& _v);
+    /**
+     * @brief top-down erasion of one node equal to %_k (must exist).
+    */
+    void _M_erase_aux(const key_type& _k);
+    /**
+     * @brief check subtree %_x
+     * @returns black height, or -(error code) of %check()
+    */
+    int _M_check_subtree(const_base_ptr _x, size_type& _n) const;
+};
+
+/// persistent_rb_tree private implement
+/**
+ * @details
+ *   descend from root, and keep %_q's parent %_p and grandparent %_g.
+ *   case 1: %_q has two red children, flip the colors.
+ *   case 2: %_q and %_p are both red (after insertion or case 1), rotate %_g
+ *     (single rotation if %_q and %_p lean the same direction, or double rotation).
+ *   the nodes on the path, and the children of %_q in case 1, are unshared before modified.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert_aux(const value_type& _v) -> void {
+    using namespace __persistent_rb_tree__;
+    base_ptr _n = this->_M_allocate_node(_v);
+    ++_m_node_count;
+    if (_m_root == nullptr) {
+        _m_root = _n;
+        _m_root->_color = _S_black;
+        return;
+    }
+    const key_type _k = _S_key(_n);
+    node_base _head; // fake root
+    _head._link[1] = this->_M_unshare(_m_root);
+    base_ptr _t = &_head; // great-grandparent
+    base_ptr _g = nullptr;
+    base_ptr _p = nullptr;
+    base_ptr _q = _head._link[1];
+    int _dir = 0;
+    int _last = 0;
+    for (;;) {
+        if (_q == nullptr) {
+            _p->_link[_dir] = _q = _n;
+        }
+        else if (_S_is_red(_q->_link[0]) && _S_is_red(_q->_link[1])) { // case 1
+            this->_M_unshare(_q->_link[0])->_color = _S_black;
+            this->_M_unshare(_q->_link[1])->_color = _S_black;
+            _q->_color = _S_red;
+        }
+        if (_S_is_red(_q) && _S_is_red(_p)) { // case 2
+            const int _dir2 = (_t->_link[1] == _g);
+            if (_q == _p->_link[_last]) {
+                _t->_link[_dir2] = _S_single_rotate(_g, !_last);
+            }
+            else {
+                _t->_link[_dir2] = _S_double_rotate(_g, !_last);
+            }
+        }
+        if (_q == _n) {
+            break;
+        }
+        _last = _dir;
+        _dir = !_M_key_compare(_k, _S_key(_q));
+        if (_g != nullptr) {
+            _t = _g;
+        }
+        _g = _p, _p = _q;
+        _q = this->_M_unshare(_q->_link[_dir]);
+    }
+    _m_root = _head._link[1];
+    _m_root->_color = _S_black;
+};
+
+/**
+ * @details
+ *   descend from root and push a red node down, so that the node to remove is red.
+ *   %_f is the node equal to %_k, and %_q stops at its in-order predecessor (or %_f itself).
+ *   case 1: %_q's child on the other side is red, rotate %_q.
+ *   case 2: %_q's sibling %_s has two black children, flip the colors.
+ *   case 3: %_s has a red child, rotate %_p (single or double) and fix the colors.
+ *   at last, the value of %_q is moved to %_f, and %_q is replaced with its only child.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_erase_aux(const key_type& _k) -> void {
+    using namespace __persistent_rb_tree__;
+    node_base _head; // fake root
+    _head._link[1] = this->_M_unshare(_m_root);
+    base_ptr _q = &_head;
+    base_ptr _p = nullptr;
+    base_ptr _g = nullptr;
+    base_ptr _f = nullptr;
+    int _dir = 1;
+    while (_q->_link[_dir] != nullptr) {
+        const int _last = _dir;
+        _g = _p, _p = _q;
+        _q = this->_M_unshare(_q->_link[_dir]);
+        _dir = _M_key_compare(_S_key(_q), _k);
+        if (!_dir && !_M_key_compare(_k, _S_key(_q))) {
+            _f = _q;
+        }
+        if (_S_is_red(_q) || _S_is_red(_q->_link[_dir])) {
+            continue;
+        }
+        if (_S_is_red(_q->_link[!_dir])) { // case 1
+            this->_M_unshare(_q->_link[!_dir]);
+            _p = _p->_link[_last] = _S_single_rotate(_q, _dir);
+            continue;
+        }
+        base_ptr _s = this->_M_unshare(_p->_link[!_last]);
+        if (_s == nullptr) {
+            continue;
+        }
+        if (!_S_is_red(_s->_link[!_last]) && !_S_is_red(_s->_link[_last])) { // case 2
+            _p->_color = _S_black;
+            _s->_color = _S_red;
+            _q->_color = _S_red;
+        }
+        else { // case 3
+            this->_M_unshare(_s->_link[0]);
+            this->_M_unshare(_s->_link[1]);
+            const int _dir2 = (_g->_link[1] == _p);
+            if (_S_is_red(_s->_link[_last])) {
+                _g->_link[_dir2] = _S_double_rotate(_p, _last);
+            }
+            else {
+                _g->_link[_dir2] = _S_single_rotate(_p, _last);
+            }
+            base_ptr _r = _g->_link[_dir2];
+            _q->_color = _r->_color = _S_red;
+            _r->_link[0]->_color = _S_black;
+            _r->_link[1]->_color = _S_black;
+        }
+    }
+    if (_f != nullptr) {
+        if (_f != _q) {
+            elt_allocator_type& _a = this->_M_get_elt_allocator();
+            value_type* _fv = static_cast<node_type*>(_f)->valptr();
+            elt_alloc_traits::destroy(_a, _fv);
+            elt_alloc_traits::construct(_a, _fv, _S_value(_q));
+        }
+        _p->_link[_p->_link[1] == _q] = _q->_link[_q->_link[0] == nullptr];
+        _q->_link[0] = _q->_link[1] = nullptr;
+        this->_M_release(_q);
+        --_m_node_count;
+    }
+    _m_root = _head._link[1];
+    if (_m_root != nullptr) {
+        _m_root->_color = _S_black;
+    }
+};
+
+/**
+ * @returns black height ;
+ *   -1 : error in black height ;
+ *   -2 : red node has red child ;
+ *   -3 : error in order ;
+ *   -4 : node without reference .
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_check_subtree(const_base_ptr _x, size_type& _n) const -> int {
+    using namespace __persistent_rb_tree__;
+    if (_x == nullptr) { return 0; }
+    ++_n;
+    if (_x->_ref.load(std::memory_order_relaxed) == 0) { return -4; }
+    if (_S_is_red(_x) && (_S_is_red(_x->_link[0]) || _S_is_red(_x->_link[1]))) { return -2; }
+    if (_x->_link[0] != nullptr && _M_key_compare(_S_key(_x), _S_key(_x->_link[0]))) { return -3; }
+    if (_x->_link[1] != nullptr && _M_key_compare(_S_key(_x->_link[1]), _S_key(_x))) { return -3; }
+    const int _l = _M_check_subtree(_x->_link[0], _n);
+    if (_l < 0) { return _l; }
+    const int _r = _M_check_subtree(_x->_link[1], _n);
+    if (_r < 0) { return _r; }
+    if (_l != _r) { return -1; }
+    return _l + (_x->_color == _S_black ? 1 : 0);
+};
+
+
+/// persistent_rb_tree protected implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert(const value_type& _v, asp::true_type) -> std::pair<iterator, bool> {
+    const key_type _k = _S_key(_v);
+    const_iterator _j = find(_k);
+    if (_j != cend()) {
+        return std::make_pair(_j, false);
+    }
+    _M_insert_aux(_v);
+    return std::make_pair(lower_bound(_k), true);
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+::_M_insert(const value_type& _v, asp::false_type) -> iterator {
+    _M_insert_aux(_v);
+    // equal keys are inserted at the right side, so the new node is the last one of them
+    return --upper_bound(_S_key(_v));
+};
+
+
+/// persistent_rb_tree public implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::persistent_rb_tree(const self& _rbt)
+: base(_rbt), _m_root(base::_S_share(_rbt._m_root)), _m_node_count(_rbt._m_node_count) {
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::operator=(const self& _rbt)
+-> self& {
+    if (this == &_rbt) { return *this; }
+    base_ptr _r = base::_S_share(_rbt._m_root);
+    this->_M_release(_m_root);
+    _m_root = _r;
+    _m_node_count = _rbt._m_node_count;
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::~persistent_rb_tree() {
+    clear();
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::cbegin() const
+-> const_iterator {
+    const_iterator _j(_m_root);
+    _j._M_descend(_m_root, 0);
+    return _j;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find(const key_type& _k) const
+-> const_iterator {
+    const_iterator _j = lower_bound(_k);
+    return (_j == cend() || _M_key_compare(_k, _S_key(_j._M_current()))) ? cend() : _j;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::count(const key_type& _k) const
+-> size_type {
+    std::pair<const_iterator, const_iterator> _res = equal_range(_k);
+    const size_type _n = asp::distance(_res.first, _res.second);
+    return _n;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::clear()
+-> void {
+    this->_M_release(_m_root);
+    _m_root = nullptr;
+    _m_node_count = 0;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::insert(const value_type& _v)
+-> ireturn_type {
+    return this->_M_insert(_v, asp::bool_t<_UniqueKey>());
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::erase(const key_type& _k)
+-> size_type {
+    const size_type _n = count(_k);
+    for (size_type _i = 0; _i < _n; ++_i) {
+        _M_erase_aux(_k);
+    }
+    return _n;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::lower_bound(const key_type& _k) const
+-> const_iterator {
+    const_iterator _j(_m_root);
+    int _y = 0; // depth of the candidate, 0 for end()
+    for (const_base_ptr _x = _m_root; _x != nullptr;) {
+        _j._path[_j._depth++] = _x;
+        if (_M_key_compare(_S_key(_x), _k)) {
+            _x = _x->_link[1];
+        }
+        else {
+            _y = _j._depth;
+            _x = _x->_link[0];
+        }
+    }
+    _j._depth = _y;
+    return _j;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::upper_bound(const key_type& _k) const
+-> const_iterator {
+    const_iterator _j(_m_root);
+    int _y = 0; // depth of the candidate, 0 for end()
+    for (const_base_ptr _x = _m_root; _x != nullptr;) {
+        _j._path[_j._depth++] = _x;
+        if (_M_key_compare(_k, _S_key(_x))) {
+            _y = _j._depth;
+            _x = _x->_link[0];
+        }
+        else {
+            _x = _x->_link[1];
+        }
+    }
+    _j._depth = _y;
+    return _j;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key_type& _k) const
+-> std::pair<const_iterator, const_iterator> {
+    return std::make_pair(lower_bound(_k), upper_bound(_k));
+};
+
+/**
+ * @brief check the red black tree
+ * @returns 0 : normal ;
+ *   1 : root node isn't black ;
+ *   2 : error in black height ;
+ *   3 : red node has red child ;
+ *   4 : error in order ;
+ *   5 : node without reference ;
+ *   6 : error in %_m_node_count .
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+persistent_rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> int {
+    if (_m_root == nullptr) { return _m_node_count == 0 ? 0 : 6; }
+    if (_m_root->_color != _S_black) { return 1; }
+    size_type _n = 0;
+    const int _bh = _M_check_subtree(_m_root, _n);
+    if (_bh < 0) { return 1 - _bh; }
+    // local order has been checked, and here's the global order
+    const_iterator _i = cbegin();
+    for (const_iterator _j = _i; _j != cend(); _i = _j) {
+        if (++_j != cend() && _M_key_compare(_S_key(_j._M_current()), _S_key(_i._M_current()))) {
+            return 4;
+        }
+    }
+    if (_n != _m_node_count) { return 6; }
+    return 0;
+};
+
+
+/// output implement
+template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
+std::ostream& operator<<(std::ostream& os, const persistent_rb_tree<_K, _V, _EK, _UK, _C, _A>& _r) {
+    os << '[';
+    for (auto p = _r.cbegin(); p != _r.cend();) {
+        os << p;
+        if (++p != _r.cend()) {
+            os << ", ";
+        }
+    }
+    os << ']';
+    return os;
+};
+template <typename _T> std::ostream& operator<<(std::ostream& os, const persistent_rb_tree_const_iterator<_T>& _r) {
+    if (_r)
+        os << obj_string::_M_obj_2_string(*_r);
+    else
+        os << "null";
+    return os;
+};
+
+
+/// __persistent_rb_tree__ implement
+namespace __persistent_rb_tree__ {
+inline bool _S_is_red(const _Base* _x) {
+    return _x != nullptr && _x->_color == _S_red;
+};
+inline _Base* _S_single_rotate(_Base* _x, int _dir) {
+    _Base* _y = _x->_link[!_dir];
+    _x->_link[!_dir] = _y->_link[_dir];
+    _y->_link[_dir] = _x;
+    _x->_color = _S_red;
+    _y->_color = _S_black;
+    return _y;
+};
+inline _Base* _S_double_rotate(_Base* _x, int _dir) {
+    _x->_link[!_dir] = _S_single_rotate(_x->_link[!_dir], !_dir);
+    return _S_single_rotate(_x, _dir);
+};
+};
+
+};
+
+#endif // _ASP_PERSISTENT_RB_TREE_HPP_
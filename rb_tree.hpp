@@ -2,6 +2,7 @@
 #define _RB_TREE_HPP_
 
 #include "tree_node.hpp"
+#include "rb_tree_policy.hpp"
 
 #include "iterator.hpp"
 #include "type_traits.hpp"
@@ -9,16 +10,17 @@
 
 #include "memory.hpp"
 // #include <memory>
+#include <cstdint>
 
 namespace asp {
 
-enum _Rb_tree_color { _S_red = false, _S_black = true };
 template <typename _Tp> struct rb_tree_node;
-template <typename _Tp> struct rb_tree_header;
-template <typename _Value, typename _Alloc> struct rb_tree_alloc;
+template <typename _Tp> struct rb_tree_compact_node;
+template <typename _Tp, typename _Node = rb_tree_node<_Tp>> struct rb_tree_header;
+template <typename _Value, typename _Alloc, typename _Node = rb_tree_node<_Value>> struct rb_tree_alloc;
 
-template <typename _Tp> struct rb_tree_iterator;
-template <typename _Tp> struct rb_tree_const_iterator;
+template <typename _Tp, typename _Node = rb_tree_node<_Tp>> struct rb_tree_iterator;
+template <typename _Tp, typename _Node = rb_tree_node<_Tp>> struct rb_tree_const_iterator;
 
 /**
  * @brief red black tree
@@ -33,21 +35,7 @@ template <typename _Tp> struct rb_tree_const_iterator;
  *   black height: the number of black nodes in the path from the given node to its descendants (until nullptr)
  *   relationship: indicates whether the child node is left or right child of its parent.
 */
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> class rb_tree;
-
-namespace __rb_tree__ {
-template <typename _Tp> bool _S_as_black_node(const rb_tree_node<_Tp>* _x);
-
-/**
- * @brief check the rb_tree's 5 rules
-*/
-template <typename _Tp> int _S_check(const rb_tree_node<_Tp>* _header);
-/**
- * @brief black height of subtree(_s)
- * @return -1 : error in black height, -2 : broken 4th rule
- * */
-template <typename _Tp> int _S_black_height(const rb_tree_node<_Tp>* _s, int _bh = 0);
-};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> class rb_tree;
 
 template <typename _Tp> struct rb_tree_node : public bitree_node<_Tp> {
     typedef bitree_node<_Tp> base;
@@ -94,6 +82,63 @@ template <typename _Tp> struct rb_tree_node : public bitree_node<_Tp> {
         return _color;
     }
 
+    self* _M_parent() const { return _parent; }
+    void _M_set_parent(self* _p) { _parent = _p; }
+    _Rb_tree_color _M_color() const { return _color; }
+    void _M_set_color(_Rb_tree_color _c) { _color = _c; }
+};
+
+/**
+ * @brief compact node of @rb_tree
+ * @details
+ *   @rb_tree_node inherits a vtable from @node and shadows the links of @bitree_node,
+ *   which costs 72 bytes for an %int on LP64 targets.
+ *   this node holds nothing but the three links and the value (32 bytes for an %int) :
+ *     the color is packed into the lowest bit of the parent link,
+ *     which is always zero because the node is (at least) pointer-aligned.
+ *   it's non-polymorphic, so %value_type is destroyed directly by the allocator.
+ *   select it through the %_Node parameter of @rb_tree, or @compact_rb_tree for ordered_* wrappers.
+*/
+template <typename _Tp> struct rb_tree_compact_node {
+    typedef rb_tree_compact_node<_Tp> self;
+    using value_type = _Tp;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+    rb_tree_compact_node() = default;
+    rb_tree_compact_node(const self& _s)
+     : _parent_color(_s._parent_color), _left(_s._left), _right(_s._right), _v(_s._v) {}
+    rb_tree_compact_node(self&& _s)
+     : _parent_color(_s._parent_color), _left(_s._left), _right(_s._right), _v(std::move(_s._v)) {}
+    rb_tree_compact_node(const value_type& _x) : _v(_x) {}
+    template <typename... _Args> rb_tree_compact_node(_Args&&... _args) : _v(std::forward<_Args>(_args)...) {}
+
+    std::uintptr_t _parent_color = 0;
+    self* _left = nullptr;
+    self* _right = nullptr;
+
+    value_type& val() { return _v; }
+    const value_type& val() const { return _v; }
+    value_type* valptr() { return &_v; }
+    const value_type* valptr() const { return &_v; }
+
+    self* _M_parent() const { return reinterpret_cast<self*>(_parent_color & ~_S_color_mask); }
+    void _M_set_parent(self* _p) {
+        _parent_color = reinterpret_cast<std::uintptr_t>(_p) | (_parent_color & _S_color_mask);
+    }
+    _Rb_tree_color _M_color() const { return static_cast<_Rb_tree_color>(_parent_color & _S_color_mask); }
+    void _M_set_color(_Rb_tree_color _c) {
+        _parent_color = (_parent_color & ~_S_color_mask) | static_cast<std::uintptr_t>(_c);
+    }
+    _Rb_tree_color _M_reverse_color() {
+        _parent_color ^= _S_color_mask;
+        return _M_color();
+    }
+
+private:
+    static constexpr std::uintptr_t _S_color_mask = 1;
+    static_assert(alignof(self*) > _S_color_mask, "the lowest bit of node address must be free");
+    value_type _v;
 };
 
 /**
@@ -104,52 +149,47 @@ template <typename _Tp> struct rb_tree_node : public bitree_node<_Tp> {
  *   %_header._left = minium node (the leftmost node in tree)
  *   %_header._right = maxium node (the rightmost node in tree)
 */
-template <typename _Tp> struct rb_tree_header : public bitree_header<_Tp> {
-    typedef bitree_header<_Tp> base;
-    typedef rb_tree_header<_Tp> self;
-    typedef rb_tree_node<_Tp> _Node;
+template <typename _Tp, typename _Node> struct rb_tree_header {
+    typedef rb_tree_header<_Tp, _Node> self;
     typedef typename _Node::value_type value_type;
-    rb_tree_node<_Tp> _header;  // bitree_header::_header override
-    using base::_node_count;
+    _Node _header;
+    size_type _node_count;
 
-    rb_tree_header() : base() {
-        _header._color = _S_red;
+    rb_tree_header() {
         reset();
     }
     rb_tree_header(rb_tree_header&& _x) {
-        if (_x._header._parent != nullptr) {
+        if (_x._header._M_parent() != nullptr) {
             move_data(_x);
         }
         else {
-            _header._color = _S_red;
             reset();
         }
     }
 
     void move_data(rb_tree_header& _from) {
-        _header._color = _from._header._color;
-        _header._parent = _from._header._parent;
+        _header._M_set_color(_from._header._M_color());
+        _header._M_set_parent(_from._header._M_parent());
         _header._left = _from._header._left;
         _header._right = _from._header._right;
-        // _header._parent->
+        _header._M_parent()->_M_set_parent(&_header);
         this->_node_count = _from._node_count;
         _from.reset();
     }
 
     void reset() {
-        _header._parent = nullptr;
+        _header._M_set_parent(nullptr);
         _header._left = &_header;
         _header._right = &_header;
-        _header._color = _S_red;
+        _header._M_set_color(_S_red);
         _node_count = 0;
     }
 };
 
 
-template <typename _Value, typename _Alloc> struct rb_tree_alloc
+template <typename _Value, typename _Alloc, typename _Node> struct rb_tree_alloc
 : public _Alloc {
-    typedef rb_tree_node<_Value> node_type;
-    typedef typename node_type::base node_type_base;
+    typedef _Node node_type;
 
     typedef _Alloc elt_allocator_type;
     typedef std::allocator_traits<elt_allocator_type> elt_alloc_traits;
@@ -181,14 +221,14 @@ template <typename _Value, typename _Alloc> struct rb_tree_alloc
     }
 };
 
-template <typename _Tp> struct rb_tree_iterator {
+template <typename _Tp, typename _Node> struct rb_tree_iterator {
     typedef asp::bidirectional_iterator_tag iterator_category;
-    typedef rb_tree_node<_Tp> node_type;
+    typedef _Node node_type;
     typedef typename node_type::value_type value_type;
     typedef value_type* pointer;
     typedef value_type& reference;
     typedef asp::difference_type difference_type;
-    typedef rb_tree_iterator<_Tp> self;
+    typedef rb_tree_iterator<_Tp, _Node> self;
 
     node_type* _ptr = nullptr;
 
@@ -203,17 +243,17 @@ template <typename _Tp> struct rb_tree_iterator {
     operator bool() const { return _ptr != nullptr; }
     friend bool operator==(const self& _x, const self& _y) { return _x._ptr == _y._ptr; }
     friend bool operator!=(const self& _x, const self& _y) { return _x._ptr != _y._ptr; }
-    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const rb_tree_iterator<_T>& _r);
+    template <typename _T, typename _N> friend std::ostream& operator<<(std::ostream& os, const rb_tree_iterator<_T, _N>& _r);
 };
-template <typename _Tp> struct rb_tree_const_iterator {
+template <typename _Tp, typename _Node> struct rb_tree_const_iterator {
     typedef asp::bidirectional_iterator_tag iterator_category;
-    typedef rb_tree_node<_Tp> node_type;
+    typedef _Node node_type;
     typedef typename node_type::value_type value_type;
     typedef value_type* pointer;
     typedef value_type& reference;
     typedef asp::difference_type difference_type;
-    typedef rb_tree_const_iterator<_Tp> self;
-    typedef rb_tree_iterator<_Tp> iterator;
+    typedef rb_tree_const_iterator<_Tp, _Node> self;
+    typedef rb_tree_iterator<_Tp, _Node> iterator;
 
     const node_type* _ptr = nullptr;
 
@@ -231,15 +271,19 @@ template <typename _Tp> struct rb_tree_const_iterator {
     operator bool() const { return _ptr != nullptr; }
     friend bool operator==(const self& _x, const self& _y) { return _x._ptr == _y._ptr; }
     friend bool operator!=(const self& _x, const self& _y) { return _x._ptr != _y._ptr; }
-    template <typename _T> friend std::ostream& operator<<(std::ostream& os, const rb_tree_const_iterator<_T>& _r);
+    template <typename _T, typename _N> friend std::ostream& operator<<(std::ostream& os, const rb_tree_const_iterator<_T, _N>& _r);
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>>
-class rb_tree : public rb_tree_alloc<_Value, _Alloc> {
+/**
+ * @tparam _Node node type, @rb_tree_node (default) or @rb_tree_compact_node
+ * @tparam _Balance balancing policy, @rb_balance_policy (default), @avl_balance_policy or @wavl_balance_policy
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>, typename _Node = rb_tree_node<_Value>, typename _Balance = rb_balance_policy>
+class rb_tree : public rb_tree_alloc<_Value, _Alloc, _Node> {
 public:
-    typedef rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc> self;
-    typedef rb_tree_alloc<_Value, _Alloc> base;
-    typedef rb_tree_alloc<_Value, _Alloc> rbt_alloc;
+    typedef rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance> self;
+    typedef rb_tree_alloc<_Value, _Alloc, _Node> base;
+    typedef rb_tree_alloc<_Value, _Alloc, _Node> rbt_alloc;
     typedef typename rbt_alloc::elt_allocator_type elt_allocator_type;
     typedef typename rbt_alloc::elt_alloc_traits elt_alloc_traits;
     typedef typename rbt_alloc::node_allocator_type node_allocator_type;
@@ -249,13 +293,11 @@ public:
     typedef _Comp key_compare;
     typedef typename base::node_type node_type;
     typedef const node_type const_node_type;
-    typedef typename base::node_type_base node_type_base;
-    typedef const node_type_base const_node_type_base;
     
     typedef typename node_type::value_type value_type;
 
-    typedef rb_tree_iterator<value_type> iterator;
-    typedef rb_tree_const_iterator<value_type> const_iterator;
+    typedef rb_tree_iterator<value_type, node_type> iterator;
+    typedef rb_tree_const_iterator<value_type, node_type> const_iterator;
 
     typedef asp::conditional_t<_UniqueKey, std::pair<iterator, bool>, iterator> ireturn_type;
 
@@ -267,7 +309,7 @@ public:
     typedef typename _ContainerTypeTraits::mapped_type mapped_type;
     typedef _ExtKey ext_key;
 
-    rb_tree_header<_Value> _m_impl;
+    rb_tree_header<_Value, _Node> _m_impl;
     _ExtKey _m_extract_key;
     _Comp _m_key_compare;
 
@@ -276,8 +318,8 @@ public:
     static key_type _S_key(const_node_type* _x) { return _ExtKey()(_x->val()); }
     static key_type _S_key(const value_type& _v) { return _ExtKey()(_v); }
 
-    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
-     friend std::ostream& operator<<(std::ostream& os, const rb_tree<_K, _V, _EK, _UK, _C, _A>& _h);
+    template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A, typename _N, typename _B>
+     friend std::ostream& operator<<(std::ostream& os, const rb_tree<_K, _V, _EK, _UK, _C, _A, _N, _B>& _h);
 
 public:
     rb_tree() = default;
@@ -306,19 +348,31 @@ public:
     const_iterator upper_bound(const key_type& _k) const { return _M_upper_bound(_M_begin(), _M_end(), _k); }
     std::pair<iterator, iterator> equal_range(const key_type& _k);
     std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const;
+    /**
+     * @brief batched lookups, %_out[_i] = lower_bound(_keys[_i]) (find(_keys[_i])) for %_i in [0, _n).
+     * @details %_Group lookups descend the tree interleaved, see @asso_container::interleave,
+     *   which pays off when the tree is much larger than the cache. the tree isn't restructured.
+    */
+    template <size_type _Group = 8> void lower_bound_batch(const key_type* _keys, size_type _n, const_iterator* _out) const;
+    template <size_type _Group = 8> void find_batch(const key_type* _keys, size_type _n, const_iterator* _out) const;
+    /**
+     * @brief finger for lookups with nearby keys, see @rb_tree::cursor.
+    */
+    class cursor;
+    cursor make_cursor() const { return cursor(*this); }
 
     // used for test
     int check() const;
 
 protected:
-    node_type* _M_root() { return _m_impl._header._parent; }
-    const_node_type* _M_root() const { return _m_impl._header._parent; }
+    node_type* _M_root() { return _m_impl._header._M_parent(); }
+    const_node_type* _M_root() const { return _m_impl._header._M_parent(); }
     node_type* _M_leftmost() { return _m_impl._header._left; }
     const_node_type* _M_leftmost() const { return _m_impl._header._left; }
     node_type* _M_rightmost() { return _m_impl._header._right; }
     const_node_type* _M_rightmost() const { return _m_impl._header._right; }
-    node_type* _M_begin() { return _m_impl._header._parent; }
-    const_node_type* _M_begin() const { return _m_impl._header._parent; }
+    node_type* _M_begin() { return _m_impl._header._M_parent(); }
+    const_node_type* _M_begin() const { return _m_impl._header._M_parent(); }
     node_type* _M_end() { return &_m_impl._header; }
     const_node_type* _M_end() const { return &_m_impl._header; }
 
@@ -366,49 +420,62 @@ private:
      * @return the node should be deallocated.
     */
     node_type* _M_erase_rebalance(node_type* const _s);
+    /**
+     * @brief update the augmented data from %_x up to root, see @bitree_augment
+    */
+    void _M_augment_path(node_type* _x);
 };
 
-/// rb_tree private implement
 /**
- * @details
- * - insertion
- *   %_x->_color = _S_red, and insert.
- * - rebalance
- *   %_x->_color == _S_red
- *   == %_x is the current node, of which color is always red. (no matter in insertion or iteration) ==
- *   case 1: %_x == %_root, just black it.
- *   case 2: %_x->_parent->_color == _S_black, just done.
- *   case 3: (%_x->_parent->_color == _S_red), divided into 2 cases: (by uncle node's color)
- *     (infer that _xpp->_color == _S_black)
- *     name uncle node as (_y), grandparent node as (_xpp)
- *     case 3.1: _y->_color == _S_red
- *       black _x->_parent and _y, red _xpp. and continue to iterate with _xpp as _x
- *     case 3.2: _y->_color == _S_black (only appear during iteration)
- *       case 3.2.1: relationship between (_x, _x->_parent) and (_x->_parent, _xpp) is different.
- *         let _x point to its parent, and rotate _x, transform into the latter case (case 3.2.2).
- *       case 3.2.2: relationship between (_x, _x->_parent) and (_x->_parent, _xpp) is identical.
- *         reverse the color of _x->_parent and _xpp, and rotate _xpp.
- * 
- *   the details for case 3.1:
- *     the color of _x and _x->_parent are all red, which breaks the 4th rule.
- *     thus, we black _x->_parent and _y, red _xpp, in order to keep the black height in subtree (_xpp as root).
- *     due to _xpp->_color is red, we may break the 4th rule (_xpp->_parent->_color may be red, too), so continue to iteration.
- *   the details for case 3.2:
- *     the current node's color is always red! the purpose of adjustment is to maintain the 4th rule.
+ * @brief @rb_tree built on @rb_tree_compact_node, with the template signature of @rb_tree,
+ *   so that it can be passed as the backend of ordered_* containers.
+ * @details the trailing pack of their %_Tree parameter matches zero parameters, so the aliases need none.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>>
+using compact_rb_tree = rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, rb_tree_compact_node<_Value>>;
+/**
+ * @brief @rb_tree balanced by @avl_balance_policy / @wavl_balance_policy, with the template signature of @rb_tree.
+ * @details the rank parity takes the color bit, so they use @rb_tree_compact_node as well.
 */
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>>
+using avl_tree = rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, rb_tree_compact_node<_Value>, avl_balance_policy>;
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>>
+using wavl_tree = rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, rb_tree_compact_node<_Value>, wavl_balance_policy>;
+
+/**
+ * @brief finger search on @rb_tree, for lookups with nearby (e.g. ascending) keys.
+ * @details it remembers the last result %_m_pos, whose ancestors are reached by the parent links.
+ *   %seek(_k) climbs from %_m_pos to the lowest ancestor whose subtree is bounded by %_k on both sides,
+ *   and descends from there, in O(log(d)) for a distance %d between the results.
+ *   so merging a sorted sequence of %m keys into the tree costs O(m * log(n / m)) instead of O(m * log(n)).
+ *   invalidated by insertion and erasure of the tree.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+class rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::cursor {
+public:
+    explicit cursor(const self& _t) : _m_tree(&_t), _m_pos(_t._M_leftmost()) {}
+
+    // lower_bound(_k)
+    const_iterator seek(const key_type& _k);
+    const_iterator position() const { return const_iterator(_m_pos); }
+    void reset() { _m_pos = _m_tree->_M_leftmost(); }
+
+private:
+    const self* _m_tree;
+    const node_type* _m_pos;
+};
+
+/// rb_tree private implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_insert_rebalance(node_type* _p, node_type* _x) -> void {
-    // node_type& _header = _m_impl._header;
-    // node_type*& _root = _header._parent;
     node_type& _header = _m_impl._header;
-    node_type*& _root = _header._parent;
 
     // initialization
-    _x->_parent = _p;
+    _x->_M_set_parent(_p);
     _x->_left = nullptr;
     _x->_right = nullptr;
-    _x->_color = _S_red;
+    _x->_M_set_color(_S_red);
 
     // insert
     bool _insert_left = (
@@ -418,7 +485,7 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     if (_insert_left) {
         _p->_left = _x;
         if (_p == &_header) {
-            _header._parent = _x;
+            _header._M_set_parent(_x);
             _header._right = _x;
         }
         else if (_p == _header._left) {
@@ -431,86 +498,14 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
             _header._right = _x;
         }
     }
-
-    // rebalance
-    while (_x != _root && _x->_parent->_color == _S_red) { // break in case 1 & 2
-        node_type* const _xpp = _x->_parent->_parent;
-        if (_x->_parent == _xpp->_left) {
-            node_type* const _y = _xpp->_right; // uncle node
-            if (_y != nullptr && _y->_color == _S_red) { // case 3.1
-                _x->_parent->_color = _S_black;
-                _y->_color = _S_black;
-                _xpp->_color = _S_red;
-                _x = _xpp;
-            }
-            else { // case 3.2
-                if (_x == _x->_parent->_right) { // case 3.2.1
-                    _x = _x->_parent;
-                    __bitree__::_S_left_rotate(_x, &_m_impl._header);
-                }
-                // case 3.2.2
-                _x->_parent->_color = _S_black;
-                _xpp->_color = _S_red;
-                __bitree__::_S_right_rotate(_xpp, &_m_impl._header);
-            }
-        }
-        else {
-            node_type* const _y = _xpp->_left; // uncle node
-            if (_y != nullptr && _y->_color == _S_red) { // case 3.1
-                _x->_parent->_color = _S_black;
-                _y->_color = _S_black;
-                _xpp->_color = _S_red;
-                _x = _xpp;
-            }
-            else { // case 3.2
-                if (_x == _x->_parent->_left) { // case 3.2.1
-                    _x = _x->_parent;
-                    __bitree__::_S_right_rotate(_x, &_m_impl._header);
-                }
-                // case 3.2.2
-                _x->_parent->_color = _S_black;
-                _xpp->_color = _S_red;
-                __bitree__::_S_left_rotate(_xpp, &_m_impl._header);
-            }
-        }
-    }
-    _root->_color = _S_black;
+    _M_augment_path(_x);
+    _Balance::_S_insert_rebalance(_x, &_header);
 };
 
-/**
- * @details
- * - deletion:
- *   delete node as a normal binary tree.
- *   to leaf node, delete directly.
- *   to node with single child, delete and let its child take its place.
- *   to node with two child, swap it and its successor node (with less than one child), and delete.
- * - rebalance:
- *   case 1: %_y->_color == _S_red, done.
- *   // iteration cases
- *   case 2: %_x->_color == _S_red, black it and done.
- *   case 3: %_x == _root, done.
- *   case 4: (%_x != _root, %_x->_color != _S_red), divided into 4 cases:
- *     // black height of _x subtree is less than its sibling node.
- *     // suppose that %_x == _x_parent->_left, vice versa
- *     // name %_x 's sibling node as %_w
- *     case 4.1: %_w->_color == _S_red.
- *       reverse the color of %_w & %_x_parent, and left rotate the %_x_parent.
- *       (transform into case 4.2, 4.3, 4.4)
- *     case 4.2: %_w->_left->_color == _S_black, %_w->_right->_color == _S_black.
- *       red %_w, and iterate with _x_parent as _x
- *     case 4.3: %_w->_left->_color == _S_red, %_w->_right->_color == _S_black.
- *       red %_w, black %_w->_left, and right rotate %_w
- *       (transform into case 4.4)
- *     case 4.4: %_w->_left->_color == _S_black, %_w->_right->_color == _S_red.
- *       %_w->_color = _x_parent->_color, red %_w->_right, black %_x_parent
- *       and left rotate %_x_parent.
- *       notice that, the black height of _x_parent subtree hasn't changed, so break directly.
-*/
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_erase_rebalance(node_type* const _s) -> node_type* {
     node_type& _header = _m_impl._header;
-    node_type*& _root = _header._parent;
     node_type*& _leftmost = _header._left;
     node_type*& _rightmost = _header._right;
     node_type* _y = _s; // node to delete
@@ -533,58 +528,60 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     // relink and separate out %_s
     if (_y != _s) { // swap _s and its successor node. replace _s with _y, and _y = _s
         // cope _s->_left. // _y must in the right subtree of _s, _y->_left == nullptr
-        _s->_left->_parent = _y;
+        _s->_left->_M_set_parent(_y);
         _y->_left = _s->_left;
 
         if (_y != _s->_right) { // cope _s->_right
-            _x_parent = _y->_parent;
-            if (_x != nullptr) _x->_parent = _y->_parent;
-            _y->_parent->_left = _x; // %_y must be a left child.
+            _x_parent = _y->_M_parent();
+            if (_x != nullptr) _x->_M_set_parent(_y->_M_parent());
+            _y->_M_parent()->_left = _x; // %_y must be a left child.
             _y->_right = _s->_right;
-            _s->_right->_parent = _y;
+            _s->_right->_M_set_parent(_y);
         }
         else {
             _x_parent = _y;
         }
 
         // cope _s->_parent
-        if (_s == _root) {
-            _root = _y;
+        if (_s == _header._M_parent()) {
+            _header._M_set_parent(_y);
         }
-        else if (_s->_parent->_left == _s) {
-            _s->_parent->_left = _y;
+        else if (_s->_M_parent()->_left == _s) {
+            _s->_M_parent()->_left = _y;
         }
         else {
-            _s->_parent->_right = _y;
+            _s->_M_parent()->_right = _y;
         }
-        _y->_parent = _s->_parent;
+        _y->_M_set_parent(_s->_M_parent());
 
-        std::swap(_y->_color, _s->_color);
+        const _Rb_tree_color _c = _y->_M_color();
+        _y->_M_set_color(_s->_M_color());
+        _s->_M_set_color(_c);
         _y = _s;
     }
     else { // _y == _s, _s owns less than one child.
-        _x_parent = _s->_parent;
+        _x_parent = _s->_M_parent();
         if (_x != nullptr) {
-            _x->_parent = _s->_parent;
+            _x->_M_set_parent(_s->_M_parent());
         }
 
         // cope %_s->_parent
-        if (_s == _root) {
-            _root = _x;
+        if (_s == _header._M_parent()) {
+            _header._M_set_parent(_x);
         }
         else {
-            if (_s->_parent->_left == _s) {
-                _s->_parent->_left = _x;
+            if (_s->_M_parent()->_left == _s) {
+                _s->_M_parent()->_left = _x;
             }
             else {
-                _s->_parent->_right = _x;
+                _s->_M_parent()->_right = _x;
             }
         }
 
         // update left/right most
         if (_leftmost == _s) {
             if (_s->_right == nullptr) {
-                _leftmost = _s->_parent;
+                _leftmost = _s->_M_parent();
             }
             else {
                 _leftmost = __bitree__::_S_minimum(_x);
@@ -592,7 +589,7 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
         }
         if (_rightmost == _s) {
             if (_s->_left == nullptr) {
-                _rightmost = _s->_parent;
+                _rightmost = _s->_M_parent();
             }
             else {
                 _rightmost = __bitree__::_S_maximum(_x);
@@ -600,6 +597,9 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
         }
     }
 
+    _M_augment_path(_x_parent);
+    _Balance::_S_erase_rebalance(_x, _x_parent, _y->_M_color(), &_header);
+
 /**
  * @details
  *   %_y now point to the node to delete, which has been separated out.
@@ -608,80 +608,80 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
  *   if (_x) _x->_parent == _x_parent;
 */
 
-    // rebalance
-    if (_y->_color != _S_red) {
-        // because %_y->_color == _S_black, so the sibling node of %_x can't be nullptr
-        while (_x != _root && __rb_tree__::_S_as_black_node(_x)) {
-            if (_x == _x_parent->_left) {
-                node_type* _w = _x_parent->_right; // the sibling node of _x
-                if (_w->_color == _S_red) { // case 4.1
-                    _w->_color = _S_black;
-                    _x_parent->_color = _S_red;
-                    __bitree__::_S_left_rotate(_x_parent, &_m_impl._header);
-                    _w = _x_parent->_right; // new sibling node of %_x
-                }
-                // %_w->_color == _S_black
-                if (__rb_tree__::_S_as_black_node(_w->_left) && __rb_tree__::_S_as_black_node(_w->_right)) { // case 4.2
-                    _w->_color = _S_red;
-                    _x = _x_parent;
-                    _x_parent = _x_parent->_parent;
-                }
-                else {
-                    if (__rb_tree__::_S_as_black_node(_w->_right)) {
-                        _w->_left->_color = _S_black;
-                        _w->_color = _S_red;
-                        __bitree__::_S_right_rotate(_w, &_m_impl._header);
-                        _w = _x_parent->_right;
-                    }
-                    _w->_color = _x_parent->_color;
-                    _x_parent->_color = _S_black;
-                    if (_w->_right != nullptr) {
-                        _w->_right->_color = _S_black;
-                    }
-                    __bitree__::_S_left_rotate(_x_parent, &_m_impl._header);
-                    break;
-                }
+
+    return _y;
+};
+
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
+::_M_augment_path(node_type* _x) -> void {
+    if (!bitree_augment<node_type>::value) { return; }
+    for (; _x != _M_end(); _x = _x->_M_parent()) {
+        bitree_augment<node_type>::_S_update(_x);
+    }
+};
+
+
+/// rb_tree::cursor implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::cursor
+::seek(const key_type& _k) -> const_iterator {
+    const self& _t = *_m_tree;
+    const node_type* _x = _m_pos;
+    const node_type* _y = _t._M_end();
+    if (_x == _t._M_end()) {
+        if (_t.empty() || _t._M_key_compare(_S_key(_t._M_rightmost()), _k)) {
+            return position();
+        }
+        _x = _t._M_root();
+    }
+    else if (_t._M_key_compare(_S_key(_x), _k)) { // forward
+        // every node before the subtree of %_x is less than %_k, find the upper bound
+        for (; _x != _t._M_root(); _x = _x->_M_parent()) {
+            const node_type* const _p = _x->_M_parent();
+            if (_x == _p->_left && !_t._M_key_compare(_S_key(_p), _k)) {
+                _y = _p;
+                break;
             }
-            else { // same as above
-                node_type* _w = _x_parent->_left;
-                if (_w->_color == _S_red) {
-                    _w->_color = _S_black;
-                    _x_parent->_color = _S_red;
-                    __bitree__::_S_right_rotate(_x_parent, &_m_impl._header);
-                    _w = _x_parent->_left;
-                }
-                if (__rb_tree__::_S_as_black_node(_w->_right) && __rb_tree__::_S_as_black_node(_w->_left)) {
-                    _w->_color = _S_red;
-                    _x = _x_parent;
-                    _x_parent = _x_parent->_parent;
-                }
-                else {
-                    if (__rb_tree__::_S_as_black_node(_w->_left)) {
-                        _w->_right->_color = _S_black;
-                        _w->_color = _S_red;
-                        __bitree__::_S_left_rotate(_w, &_m_impl._header);
-                        _w = _x_parent->_left;
-                    }
-                    _w->_color = _x_parent->_color;
-                    _x_parent->_color = _S_black;
-                    if (_w->_left != nullptr) {
-                        _w->_left->_color = _S_black;
-                    }
-                    __bitree__::_S_right_rotate(_x_parent, &_m_impl._header);
-                    break;
-                }
+        }
+    }
+    else { // backward
+        if (_x == _t._M_leftmost()) {
+            return position();
+        }
+        // the predecessor, not by the header-aware decrement, which takes the root for the header
+        const node_type* _pred = _x->_left;
+        if (_pred != nullptr) {
+            while (_pred->_right != nullptr) {
+                _pred = _pred->_right;
+            }
+        }
+        else {
+            const node_type* _c = _x;
+            for (_pred = _x->_M_parent(); _c == _pred->_left; _pred = _pred->_M_parent()) {
+                _c = _pred;
+            }
+        }
+        if (_t._M_key_compare(_S_key(_pred), _k)) {
+            return position();
+        }
+        // %_x is not less than %_k, find the lower bound
+        _y = _x;
+        for (; _x != _t._M_root(); _x = _x->_M_parent()) {
+            const node_type* const _p = _x->_M_parent();
+            if (_x == _p->_right && _t._M_key_compare(_S_key(_p), _k)) {
+                break;
             }
         }
-        if (_x != nullptr) _x->_color = _S_black;
     }
-
-    return _y;
+    _m_pos = _t._M_lower_bound(_x, _y, _k)._ptr;
+    return position();
 };
 
-
 /// rb_tree protected implement
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_lower_bound(node_type* _x, node_type* _y, const key_type& _k)
 -> iterator {
     while (_x != nullptr) {
@@ -695,8 +695,8 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     }
     return iterator(_y);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_lower_bound(const node_type* _x, const node_type* _y, const key_type& _k) const
 -> const_iterator {
     while (_x != nullptr) {
@@ -710,8 +710,8 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     }
     return const_iterator(_y);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_upper_bound(node_type* _x, node_type* _y, const key_type& _k)
 -> iterator {
     while (_x != nullptr) {
@@ -725,8 +725,8 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     }
     return iterator(_y);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_upper_bound(const node_type* _x, const node_type* _y, const key_type& _k) const
 -> const_iterator {
     while (_x != nullptr) {
@@ -741,13 +741,13 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     return const_iterator(_y);
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_insert_unique_position(const key_type& _k) -> std::pair<node_type*, node_type*> {
     typedef std::pair<node_type*, node_type*> _Res;
     node_type* _x = _M_begin();
     node_type* _y = _M_end();
-    bool _comp_res;
+    bool _comp_res = true; // an empty tree inserts at the header
     while (_x != nullptr) {
         _y = _x;
         _comp_res = _M_key_compare(_k, _S_key(_x));
@@ -770,12 +770,12 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     }
     return _Res(_j._ptr, nullptr);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_insert_multi_position(const key_type& _k) -> node_type* {
     node_type* _x = _M_begin();
     node_type* _y = _M_end();
-    bool _comp_res;
+    bool _comp_res = true;
     while (_x != nullptr) {
         _y = _x;
         _comp_res = _M_key_compare(_k, _S_key(_x));
@@ -784,8 +784,8 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     return _y;
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_insert(const value_type& _v, asp::true_type) -> std::pair<iterator, bool> {
     std::pair<node_type*, node_type*> _res = _M_insert_unique_position(_S_key(_v));
     if (_res.second != nullptr) {
@@ -796,8 +796,8 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     }
     return std::make_pair(iterator(_res.first), false);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_insert(const value_type& _v, asp::false_type) -> iterator {
     node_type* _res = _M_insert_multi_position(_S_key(_v));
     node_type* _x = this->_M_allocate_node(_v);
@@ -805,16 +805,16 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     ++_m_impl._node_count;
     return iterator(_x);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_erase(const_iterator _p) -> size_type {
     node_type* _s = _M_erase_rebalance(const_cast<node_type*>(_p._ptr));
     this->_M_deallocate_node(_s);
     --_m_impl._node_count;
     return 1;
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_erase(const_iterator _first, const_iterator _last) -> size_type {
     size_type _ret = 0;
     if (_first == cbegin() && _last == cend()) {
@@ -829,96 +829,161 @@ auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
     }
     return _ret;
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_erase_subtree(node_type* _s) -> void {
+    // no recursion, the tree may be deep (e.g. @splay_tree)
     while (_s != nullptr) {
-        _M_erase_subtree(_s->_right);
-        node_type* _p = _s->_left;
-        this->_M_deallocate_node(_s);
-        _s = _p;
+        if (_s->_left != nullptr) { // rotate the left child up, until %_s has no left child
+            node_type* _l = _s->_left;
+            _s->_left = _l->_right;
+            _l->_right = _s;
+            _s = _l;
+        }
+        else {
+            node_type* _r = _s->_right;
+            this->_M_deallocate_node(_s);
+            _s = _r;
+        }
     }
 };
 
 /// rb_tree public implement
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::rb_tree(const self& _rbt) {
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::rb_tree(const self& _rbt) {
     _M_assign(_rbt, [this](const node_type* _n) -> node_type* {
         node_type* _p = this->_M_allocate_node(*_n);
-        _p->_parent = nullptr; _p->_left = nullptr; _p->_right = nullptr;
-        _p->_color = _n->_color;
+        _p->_M_set_parent(nullptr); _p->_left = nullptr; _p->_right = nullptr;
+        _p->_M_set_color(_n->_M_color());
         return _p;
     });
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::~rb_tree() {
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::~rb_tree() {
 
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-template <typename _NodeGen> void rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+template <typename _NodeGen> void rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_assign(const self& _rbt, const _NodeGen& _gen) {
     _m_impl.reset();
     if (_rbt._M_begin() == nullptr) { return; }
     _m_impl._node_count = _rbt.size();
     node_type* _root = _M_clone_tree(_rbt._M_begin(), _M_end(), _gen);
-    _m_impl._header._parent = _root;
+    _m_impl._header._M_set_parent(_root);
     _m_impl._header._left = __bitree__::_S_minimum(_root);
     _m_impl._header._right = __bitree__::_S_maximum(_root);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
-template <typename _NodeGen> auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+template <typename _NodeGen> auto rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>
 ::_M_clone_tree(const node_type* _x, node_type* _p, const _NodeGen& _gen) -> node_type* {
     node_type* _top = _gen(_x);
-    _top->_parent = _p;
-
-    if (_x->_left != nullptr) {
-        _top->_left = _M_clone_tree(_x->_left, _top, _gen);
-    }
-    if (_x->_right != nullptr) {
-        _top->_right = _M_clone_tree(_x->_right, _top, _gen);
+    _top->_M_set_parent(_p);
+
+    // iterative preorder through parent links, %_y is the clone of %_x
+    node_type* _y = _top;
+    while (true) {
+        if (_x->_left != nullptr && _y->_left == nullptr) {
+            _y->_left = _gen(_x->_left);
+            _y->_left->_M_set_parent(_y);
+            _x = _x->_left;
+            _y = _y->_left;
+        }
+        else if (_x->_right != nullptr && _y->_right == nullptr) {
+            _y->_right = _gen(_x->_right);
+            _y->_right->_M_set_parent(_y);
+            _x = _x->_right;
+            _y = _y->_right;
+        }
+        else { // both subtrees are done
+            bitree_augment<node_type>::_S_update(_y);
+            if (_y == _top) { break; }
+            _x = _x->_M_parent();
+            _y = _y->_M_parent();
+        }
     }
 
     return _top;
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find(const key_type& _k)
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::find(const key_type& _k)
 -> iterator {
     iterator _j = _M_lower_bound(_M_begin(), _M_end(), _k);
     return (_j == end() || _M_key_compare(_k, _S_key(_j._ptr))) ? end() : _j;
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find(const key_type& _k) const
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::find(const key_type& _k) const
 -> const_iterator {
     const_iterator _j = _M_lower_bound(_M_begin(), _M_end(), _k);
     return (_j == cend() || _M_key_compare(_k, _S_key(_j._ptr))) ? cend() : _j;
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::count(const key_type& _k) const
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+template <size_type _Group> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::lower_bound_batch(const key_type* _keys, size_type _n, const_iterator* _out) const
+-> void {
+    struct _State { size_type _i; const node_type* _x; const node_type* _y; };
+    asso_container::interleave<_Group, _State>(_n,
+        [&](_State& _s, size_type _i) {
+            _s._i = _i;
+            _s._x = _M_begin();
+            _s._y = _M_end();
+        },
+        [&](_State& _s) {
+            if (_s._x == nullptr) {
+                _out[_s._i] = const_iterator(_s._y);
+                return false;
+            }
+            if (_M_key_compare(_S_key(_s._x), _keys[_s._i])) {
+                _s._x = _s._x->_right;
+            }
+            else {
+                _s._y = _s._x;
+                _s._x = _s._x->_left;
+            }
+            if (_s._x != nullptr) {
+                __builtin_prefetch(_s._x);
+                __builtin_prefetch(_s._x->valptr());
+            }
+            return true;
+        });
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance>
+template <size_type _Group> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::find_batch(const key_type* _keys, size_type _n, const_iterator* _out) const
+-> void {
+    lower_bound_batch<_Group>(_keys, _n, _out);
+    for (size_type _i = 0; _i < _n; ++_i) {
+        if (_out[_i] != cend() && _M_key_compare(_keys[_i], _S_key(_out[_i]._ptr))) {
+            _out[_i] = cend();
+        }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::count(const key_type& _k) const
 -> size_type {
     std::pair<const_iterator, const_iterator> _res = equal_range(_k);
     const size_type _n = asp::distance(_res.first, _res.second);
     return _n;
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::clear()
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::clear()
 -> void {
     _M_erase_subtree(_M_begin());
     _m_impl.reset();
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::insert(const value_type& _v)
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::insert(const value_type& _v)
 -> ireturn_type {
     return this->_M_insert(_v, asp::bool_t<_UniqueKey>());
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::erase(const key_type& _k)
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::erase(const key_type& _k)
 -> size_type {
     std::pair<const_iterator, const_iterator> _p = equal_range(_k);
     return this->_M_erase(_p.first, _p.second);
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key_type& _k)
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::equal_range(const key_type& _k)
 -> std::pair<iterator, iterator> {
     node_type* _x = _M_begin();
     node_type* _y = _M_end();
@@ -941,8 +1006,8 @@ rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key
     }
     return std::make_pair(iterator(_y), iterator(_y));
 };
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key_type& _k) const
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::equal_range(const key_type& _k) const
 -> std::pair<const_iterator, const_iterator> {
     const node_type* _x = _M_begin();
     const node_type* _y = _M_end();
@@ -966,18 +1031,18 @@ rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::equal_range(const key
     return std::make_pair(const_iterator(_y), const_iterator(_y));
 };
 
-template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
-rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> int {
-    typedef rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc> rb_tree_t;
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Node, typename _Balance> auto
+rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance>::check() const -> int {
+    typedef rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Node, _Balance> rb_tree_t;
     auto _bt_check = __bitree__::_S_check<_Comp, typename rb_tree_t::ext_key>(&_m_impl._header, _m_impl._node_count);
-    auto _rb_check = __rb_tree__::_S_check(&_m_impl._header);
+    auto _rb_check = _Balance::_S_check(&_m_impl._header);
     return _bt_check + (_rb_check>0 ? 100 : 0) + _rb_check;
 };
 
 
 /// output implement
-template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
-std::ostream& operator<<(std::ostream& os, const rb_tree<_K, _V, _EK, _UK, _C, _A>& _r) {
+template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A, typename _N, typename _B>
+std::ostream& operator<<(std::ostream& os, const rb_tree<_K, _V, _EK, _UK, _C, _A, _N, _B>& _r) {
     os << '[';
     for (auto p = _r.cbegin(); p != _r.cend();) {
         os << p;
@@ -988,14 +1053,14 @@ std::ostream& operator<<(std::ostream& os, const rb_tree<_K, _V, _EK, _UK, _C, _
     os << ']';
     return os;
 };
-template <typename _T> std::ostream& operator<<(std::ostream& os, const rb_tree_iterator<_T>& _r) {
+template <typename _T, typename _N> std::ostream& operator<<(std::ostream& os, const rb_tree_iterator<_T, _N>& _r) {
     if (_r)
         os << obj_string::_M_obj_2_string(*_r);
     else 
         os << "null";
     return os;
 };
-template <typename _T> std::ostream& operator<<(std::ostream& os, const rb_tree_const_iterator<_T>& _r) {
+template <typename _T, typename _N> std::ostream& operator<<(std::ostream& os, const rb_tree_const_iterator<_T, _N>& _r) {
     if (_r)
         os << obj_string::_M_obj_2_string(*_r);
     else
@@ -1004,50 +1069,6 @@ template <typename _T> std::ostream& operator<<(std::ostream& os, const rb_tree_
 };
 
 
-/// __rb_tree__ implement
-namespace __rb_tree__ {
-template <typename _Tp> bool _S_as_black_node(const rb_tree_node<_Tp>* _x) {
-    return _x == nullptr || _x->_color == _S_black;
-};
-
-/**
- * @brief check the rb_tree's 5 rules
- * @returns 0 : normal ;
- *   1 : root node isn't black ;
- *   2 : error in black height (break 5th rule) ;
- *   3 : red node has at least one red child (break 4th rule) .
-*/
-template <typename _Tp> int _S_check(const rb_tree_node<_Tp>* _header) {
-    typedef rb_tree_node<_Tp> node_type;
-    const node_type* _root = _header->_parent;
-    if (_root == nullptr) { return 0; }
-    if (_root->_color != _S_black) {
-        return 1;
-    }
-    int _bh = _S_black_height(_root);
-    if (_bh == -1) { return 2; }
-    else if (_bh == -2) { return 3; }
-    return 0;
-};
-
-template <typename _Tp> int _S_black_height(const rb_tree_node<_Tp>* _s, int _bh) {
-    if (_s == nullptr) { return _bh; }
-    if (_s->_color == _S_red) {
-        if (!_S_as_black_node(_s->_left) || !_S_as_black_node(_s->_right)) {
-            return -2;
-        }
-    }
-    else {
-        ++_bh;
-    }
-    int _l = _S_black_height(_s->_left, _bh);
-    if (_l < 0) { return _l; }
-    int _r = _S_black_height(_s->_right, _bh);
-    if (_r < 0) { return _r; }
-    if (_l != _r) { return -1; }
-    return _l;
-}
-};
 
 };
 
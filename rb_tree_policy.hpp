@@ -0,0 +1,504 @@
+#ifndef _ASP_RB_TREE_POLICY_HPP_
+#define _ASP_RB_TREE_POLICY_HPP_
+
+#include "tree_node.hpp"
+
+namespace asp {
+
+enum _Rb_tree_color { _S_red = false, _S_black = true };
+
+struct rb_balance_policy;
+struct avl_balance_policy;
+struct wavl_balance_policy;
+
+/**
+ * @brief balancing policies of @rb_tree
+ * @details
+ *   a policy is a set of static functions over the nodes of @rb_tree,
+ *   which only use the rotation helpers of @__bitree__ and the 1-bit color of nodes :
+ *   - _S_insert_rebalance(_x, _header) : %_x has been linked as a leaf (color %_S_red).
+ *   - _S_erase_rebalance(_x, _x_parent, _c, _header) : a node with color %_c has been unlinked,
+ *       and its only child %_x (nullable) took its place under %_x_parent.
+ *       if the unlinked node had two children, it's swapped (including color) with its successor first.
+ *   - _S_check(_header) : 0 if the balancing rules hold.
+ *
+ *   @avl_balance_policy and @wavl_balance_policy are rank-balanced trees,
+ *   in which the rank difference between a node and its child is always 1 or 2 (null node has rank -1),
+ *   so the parity of rank is enough to tell the difference, and it's stored in the color bit
+ *   (%_S_red : even, %_S_black : odd). no extra space is needed by any node type.
+ *     AVL : rank = height, every node is 1,1 or 1,2.
+ *     WAVL : every leaf is 1,1 (rank 0), 2,2 inner nodes are allowed.
+ *   both have the same insertion, WAVL does O(1) rotations in deletion, and has height <= 2*log(n),
+ *   and AVL (height <= 1.44*log(n)) is shallower than red black tree (height <= 2*log(n)) for lookups.
+*/
+struct rb_balance_policy {
+    template <typename _Node> static void _S_insert_rebalance(_Node* _x, _Node* _header);
+    template <typename _Node> static void _S_erase_rebalance(_Node* _x, _Node* _x_parent, _Rb_tree_color _c, _Node* _header);
+    template <typename _Node> static int _S_check(const _Node* _header);
+};
+struct avl_balance_policy {
+    template <typename _Node> static void _S_insert_rebalance(_Node* _x, _Node* _header);
+    template <typename _Node> static void _S_erase_rebalance(_Node* _x, _Node* _x_parent, _Rb_tree_color _c, _Node* _header);
+    template <typename _Node> static int _S_check(const _Node* _header);
+};
+struct wavl_balance_policy {
+    template <typename _Node> static void _S_insert_rebalance(_Node* _x, _Node* _header);
+    template <typename _Node> static void _S_erase_rebalance(_Node* _x, _Node* _x_parent, _Rb_tree_color _c, _Node* _header);
+    template <typename _Node> static int _S_check(const _Node* _header);
+};
+
+namespace __rb_tree__ {
+template <typename _Node> bool _S_as_black_node(const _Node* _x);
+
+/**
+ * @brief check the rb_tree's 5 rules
+*/
+template <typename _Node> int _S_check(const _Node* _header);
+/**
+ * @brief black height of subtree(_s)
+ * @return -1 : error in black height, -2 : broken 4th rule
+ * */
+template <typename _Node> int _S_black_height(const _Node* _s, int _bh = 0);
+};
+
+namespace __rank_balance__ {
+// the parity of rank, nullptr has rank -1
+template <typename _Node> bool _S_odd(const _Node* _x);
+// promote or demote %_x by one rank
+template <typename _Node> void _S_flip(_Node* _x);
+// rank difference between %_p and its child %_x (1 or 2)
+template <typename _Node> int _S_diff(const _Node* _x, const _Node* _p);
+template <typename _Node> void _S_insert_rebalance(_Node* _x, _Node* _header);
+/**
+ * @brief rank of subtree %_s, and check the rank rules
+ * @return -2 : 2,2 leaf ; -3 : 2,2 node (if %_avl) ; -4 : error in rank
+*/
+template <typename _Node> int _S_rank(const _Node* _s, bool _avl);
+template <typename _Node> int _S_check(const _Node* _header, bool _avl);
+};
+
+
+/// rb_balance_policy implement
+/**
+ * @details
+ * - rebalance (%_x has been linked as a red leaf)
+ *   %_x->_color == _S_red
+ *   == %_x is the current node, of which color is always red. (no matter in insertion or iteration) ==
+ *   case 1: %_x == %_root, just black it.
+ *   case 2: %_x->_parent->_color == _S_black, just done.
+ *   case 3: (%_x->_parent->_color == _S_red), divided into 2 cases: (by uncle node's color)
+ *     (infer that _xpp->_color == _S_black)
+ *     name uncle node as (_y), grandparent node as (_xpp)
+ *     case 3.1: _y->_color == _S_red
+ *       black _x->_parent and _y, red _xpp. and continue to iterate with _xpp as _x
+ *     case 3.2: _y->_color == _S_black (only appear during iteration)
+ *       case 3.2.1: relationship between (_x, _x->_parent) and (_x->_parent, _xpp) is different.
+ *         let _x point to its parent, and rotate _x, transform into the latter case (case 3.2.2).
+ *       case 3.2.2: relationship between (_x, _x->_parent) and (_x->_parent, _xpp) is identical.
+ *         reverse the color of _x->_parent and _xpp, and rotate _xpp.
+ * 
+ *   the details for case 3.1:
+ *     the color of _x and _x->_parent are all red, which breaks the 4th rule.
+ *     thus, we black _x->_parent and _y, red _xpp, in order to keep the black height in subtree (_xpp as root).
+ *     due to _xpp->_color is red, we may break the 4th rule (_xpp->_parent->_color may be red, too), so continue to iteration.
+ *   the details for case 3.2:
+ *     the current node's color is always red! the purpose of adjustment is to maintain the 4th rule.
+*/
+template <typename _Node> void rb_balance_policy::_S_insert_rebalance(_Node* _x, _Node* _header) {
+    while (_x != _header->_M_parent() && _x->_M_parent()->_M_color() == _S_red) { // break in case 1 & 2
+        _Node* const _xpp = _x->_M_parent()->_M_parent();
+        if (_x->_M_parent() == _xpp->_left) {
+            _Node* const _y = _xpp->_right; // uncle node
+            if (_y != nullptr && _y->_M_color() == _S_red) { // case 3.1
+                _x->_M_parent()->_M_set_color(_S_black);
+                _y->_M_set_color(_S_black);
+                _xpp->_M_set_color(_S_red);
+                _x = _xpp;
+            }
+            else { // case 3.2
+                if (_x == _x->_M_parent()->_right) { // case 3.2.1
+                    _x = _x->_M_parent();
+                    __bitree__::_S_left_rotate(_x, _header);
+                }
+                // case 3.2.2
+                _x->_M_parent()->_M_set_color(_S_black);
+                _xpp->_M_set_color(_S_red);
+                __bitree__::_S_right_rotate(_xpp, _header);
+            }
+        }
+        else {
+            _Node* const _y = _xpp->_left; // uncle node
+            if (_y != nullptr && _y->_M_color() == _S_red) { // case 3.1
+                _x->_M_parent()->_M_set_color(_S_black);
+                _y->_M_set_color(_S_black);
+                _xpp->_M_set_color(_S_red);
+                _x = _xpp;
+            }
+            else { // case 3.2
+                if (_x == _x->_M_parent()->_left) { // case 3.2.1
+                    _x = _x->_M_parent();
+                    __bitree__::_S_right_rotate(_x, _header);
+                }
+                // case 3.2.2
+                _x->_M_parent()->_M_set_color(_S_black);
+                _xpp->_M_set_color(_S_red);
+                __bitree__::_S_left_rotate(_xpp, _header);
+            }
+        }
+    }
+    _header->_M_parent()->_M_set_color(_S_black);
+};
+
+/**
+ * @details
+ * - rebalance: (the unlinked node %_y had color %_c, and %_x took its place)
+ *   case 1: %_c == _S_red, done.
+ *   // iteration cases
+ *   case 2: %_x->_color == _S_red, black it and done.
+ *   case 3: %_x == _root, done.
+ *   case 4: (%_x != _root, %_x->_color != _S_red), divided into 4 cases:
+ *     // black height of _x subtree is less than its sibling node.
+ *     // suppose that %_x == _x_parent->_left, vice versa
+ *     // name %_x 's sibling node as %_w
+ *     case 4.1: %_w->_color == _S_red.
+ *       reverse the color of %_w & %_x_parent, and left rotate the %_x_parent.
+ *       (transform into case 4.2, 4.3, 4.4)
+ *     case 4.2: %_w->_left->_color == _S_black, %_w->_right->_color == _S_black.
+ *       red %_w, and iterate with _x_parent as _x
+ *     case 4.3: %_w->_left->_color == _S_red, %_w->_right->_color == _S_black.
+ *       red %_w, black %_w->_left, and right rotate %_w
+ *       (transform into case 4.4)
+ *     case 4.4: %_w->_left->_color == _S_black, %_w->_right->_color == _S_red.
+ *       %_w->_color = _x_parent->_color, red %_w->_right, black %_x_parent
+ *       and left rotate %_x_parent.
+ *       notice that, the black height of _x_parent subtree hasn't changed, so break directly.
+*/
+template <typename _Node> void rb_balance_policy::_S_erase_rebalance(_Node* _x, _Node* _x_parent, _Rb_tree_color _c, _Node* _header) {
+    if (_c != _S_red) {
+        // because %_c == _S_black, so the sibling node of %_x can't be nullptr
+        while (_x != _header->_M_parent() && __rb_tree__::_S_as_black_node(_x)) {
+            if (_x == _x_parent->_left) {
+                _Node* _w = _x_parent->_right; // the sibling node of _x
+                if (_w->_M_color() == _S_red) { // case 4.1
+                    _w->_M_set_color(_S_black);
+                    _x_parent->_M_set_color(_S_red);
+                    __bitree__::_S_left_rotate(_x_parent, _header);
+                    _w = _x_parent->_right; // new sibling node of %_x
+                }
+                // %_w->_color == _S_black
+                if (__rb_tree__::_S_as_black_node(_w->_left) && __rb_tree__::_S_as_black_node(_w->_right)) { // case 4.2
+                    _w->_M_set_color(_S_red);
+                    _x = _x_parent;
+                    _x_parent = _x_parent->_M_parent();
+                }
+                else {
+                    if (__rb_tree__::_S_as_black_node(_w->_right)) {
+                        _w->_left->_M_set_color(_S_black);
+                        _w->_M_set_color(_S_red);
+                        __bitree__::_S_right_rotate(_w, _header);
+                        _w = _x_parent->_right;
+                    }
+                    _w->_M_set_color(_x_parent->_M_color());
+                    _x_parent->_M_set_color(_S_black);
+                    if (_w->_right != nullptr) {
+                        _w->_right->_M_set_color(_S_black);
+                    }
+                    __bitree__::_S_left_rotate(_x_parent, _header);
+                    break;
+                }
+            }
+            else { // same as above
+                _Node* _w = _x_parent->_left;
+                if (_w->_M_color() == _S_red) {
+                    _w->_M_set_color(_S_black);
+                    _x_parent->_M_set_color(_S_red);
+                    __bitree__::_S_right_rotate(_x_parent, _header);
+                    _w = _x_parent->_left;
+                }
+                if (__rb_tree__::_S_as_black_node(_w->_right) && __rb_tree__::_S_as_black_node(_w->_left)) {
+                    _w->_M_set_color(_S_red);
+                    _x = _x_parent;
+                    _x_parent = _x_parent->_M_parent();
+                }
+                else {
+                    if (__rb_tree__::_S_as_black_node(_w->_left)) {
+                        _w->_right->_M_set_color(_S_black);
+                        _w->_M_set_color(_S_red);
+                        __bitree__::_S_left_rotate(_w, _header);
+                        _w = _x_parent->_left;
+                    }
+                    _w->_M_set_color(_x_parent->_M_color());
+                    _x_parent->_M_set_color(_S_black);
+                    if (_w->_left != nullptr) {
+                        _w->_left->_M_set_color(_S_black);
+                    }
+                    __bitree__::_S_right_rotate(_x_parent, _header);
+                    break;
+                }
+            }
+        }
+        if (_x != nullptr) _x->_M_set_color(_S_black);
+    }
+};
+template <typename _Node> int rb_balance_policy::_S_check(const _Node* _header) {
+    return __rb_tree__::_S_check(_header);
+};
+
+
+/// avl_balance_policy implement
+template <typename _Node> void avl_balance_policy::_S_insert_rebalance(_Node* _x, _Node* _header) {
+    __rank_balance__::_S_insert_rebalance(_x, _header);
+};
+/**
+ * @details
+ *   %_x (rank decreased by one) is a %_d-child of %_p, %_s is its sibling.
+ *   case 1: %_d == 2, and %_s is a 1-child, done.
+ *   case 2: %_d == 2, and %_s is a 2-child (%_p is 2,2), demote %_p and iterate with %_p as %_x.
+ *   case 3: %_d == 3 (%_s must be a 1-child), name the outer child of %_s as %_t, the inner as %_u
+ *     case 3.1: %_s is 1,1, rotate %_s up, promote %_s and demote %_p, done.
+ *     case 3.2: %_t is a 1-child, %_u is a 2-child, rotate %_s up, demote %_p twice,
+ *       and iterate with %_s as %_x.
+ *     case 3.3: %_t is a 2-child, rotate %_u up twice, promote %_u, demote %_s, demote %_p twice,
+ *       and iterate with %_u as %_x.
+*/
+template <typename _Node> void avl_balance_policy::_S_erase_rebalance(_Node* _x, _Node* _p, _Rb_tree_color _c, _Node* _header) {
+    using namespace __rank_balance__;
+    if (_p == _header) { return; }
+    // the unlinked node had rank(%_x)+1
+    int _d = (_S_odd(_p) == (_c == _S_black) ? 2 : 1) + 1;
+    while (_p != _header) {
+        _Node* const _g = _p->_M_parent();
+        const int _dp = _S_diff(_p, _g);
+        _Node* const _s = (_x == _p->_left) ? _p->_right : _p->_left;
+        if (_d == 2) {
+            if (_S_diff(_s, _p) == 1) { // case 1
+                return;
+            }
+            _S_flip(_p); // case 2
+            _x = _p;
+        }
+        else {
+            const bool _s_right = (_s == _p->_right);
+            _Node* const _t = _s_right ? _s->_right : _s->_left;
+            _Node* const _u = _s_right ? _s->_left : _s->_right;
+            const int _dt = _S_diff(_t, _s);
+            const int _du = _S_diff(_u, _s);
+            if (_dt == 1 && _du == 1) { // case 3.1
+                __bitree__::_S_rotate_up(_s, _header);
+                _S_flip(_s);
+                _S_flip(_p);
+                return;
+            }
+            if (_dt == 1) { // case 3.2
+                __bitree__::_S_rotate_up(_s, _header);
+                _x = _s;
+            }
+            else { // case 3.3
+                __bitree__::_S_rotate_up(_u, _header);
+                __bitree__::_S_rotate_up(_u, _header);
+                _S_flip(_u);
+                _S_flip(_s);
+                _x = _u;
+            }
+        }
+        _p = _g;
+        _d = _dp + 1;
+    }
+};
+template <typename _Node> int avl_balance_policy::_S_check(const _Node* _header) {
+    return __rank_balance__::_S_check(_header, true);
+};
+
+
+/// wavl_balance_policy implement
+template <typename _Node> void wavl_balance_policy::_S_insert_rebalance(_Node* _x, _Node* _header) {
+    __rank_balance__::_S_insert_rebalance(_x, _header);
+};
+/**
+ * @details
+ *   %_x (rank decreased by one) is a %_d-child of %_p, %_s is its sibling.
+ *   if %_d == 2 and %_p becomes a 2,2 leaf, demote %_p, and continue with %_p as %_x.
+ *   while %_x is a 3-child :
+ *     case 1: %_s is a 2-child, demote %_p, and iterate with %_p as %_x.
+ *     case 2: %_s is a 2,2 node, demote %_p and %_s, and iterate with %_p as %_x.
+ *     case 3: the outer child of %_s is a 1-child, rotate %_s up, promote %_s, demote %_p
+ *       (twice if %_p becomes a leaf), done.
+ *     case 4: the outer child of %_s is a 2-child, so the inner child %_u is a 1-child,
+ *       rotate %_u up twice, promote %_u twice, demote %_s, demote %_p twice, done.
+*/
+template <typename _Node> void wavl_balance_policy::_S_erase_rebalance(_Node* _x, _Node* _p, _Rb_tree_color _c, _Node* _header) {
+    using namespace __rank_balance__;
+    if (_p == _header) { return; }
+    // the unlinked node had rank(%_x)+1
+    int _d = (_S_odd(_p) == (_c == _S_black) ? 2 : 1) + 1;
+    if (_d == 2 && _p->_left == nullptr && _p->_right == nullptr) {
+        _Node* const _g = _p->_M_parent();
+        _d = _S_diff(_p, _g) + 1;
+        _S_flip(_p);
+        _x = _p;
+        _p = _g;
+    }
+    while (_d == 3 && _p != _header) {
+        _Node* const _g = _p->_M_parent();
+        const int _dp = _S_diff(_p, _g);
+        _Node* const _s = (_x == _p->_left) ? _p->_right : _p->_left;
+        if (_S_diff(_s, _p) == 2) { // case 1
+            _S_flip(_p);
+        }
+        else {
+            const bool _s_right = (_s == _p->_right);
+            _Node* const _t = _s_right ? _s->_right : _s->_left;
+            _Node* const _u = _s_right ? _s->_left : _s->_right;
+            const int _dt = _S_diff(_t, _s);
+            if (_dt == 2 && _S_diff(_u, _s) == 2) { // case 2
+                _S_flip(_p);
+                _S_flip(_s);
+            }
+            else if (_dt == 1) { // case 3
+                __bitree__::_S_rotate_up(_s, _header);
+                _S_flip(_s);
+                if (_p->_left != nullptr || _p->_right != nullptr) {
+                    _S_flip(_p);
+                }
+                return;
+            }
+            else { // case 4
+                __bitree__::_S_rotate_up(_u, _header);
+                __bitree__::_S_rotate_up(_u, _header);
+                _S_flip(_s);
+                return;
+            }
+        }
+        _x = _p;
+        _p = _g;
+        _d = _dp + 1;
+    }
+};
+template <typename _Node> int wavl_balance_policy::_S_check(const _Node* _header) {
+    return __rank_balance__::_S_check(_header, false);
+};
+
+
+/// __rb_tree__ implement
+namespace __rb_tree__ {
+template <typename _Node> bool _S_as_black_node(const _Node* _x) {
+    return _x == nullptr || _x->_M_color() == _S_black;
+};
+
+/**
+ * @brief check the rb_tree's 5 rules
+ * @returns 0 : normal ;
+ *   1 : root node isn't black ;
+ *   2 : error in black height (break 5th rule) ;
+ *   3 : red node has at least one red child (break 4th rule) .
+*/
+template <typename _Node> int _S_check(const _Node* _header) {
+    typedef _Node node_type;
+    const node_type* _root = _header->_M_parent();
+    if (_root == nullptr) { return 0; }
+    if (_root->_M_color() != _S_black) {
+        return 1;
+    }
+    int _bh = _S_black_height(_root);
+    if (_bh == -1) { return 2; }
+    else if (_bh == -2) { return 3; }
+    return 0;
+};
+
+template <typename _Node> int _S_black_height(const _Node* _s, int _bh) {
+    if (_s == nullptr) { return _bh; }
+    if (_s->_M_color() == _S_red) {
+        if (!_S_as_black_node(_s->_left) || !_S_as_black_node(_s->_right)) {
+            return -2;
+        }
+    }
+    else {
+        ++_bh;
+    }
+    int _l = _S_black_height(_s->_left, _bh);
+    if (_l < 0) { return _l; }
+    int _r = _S_black_height(_s->_right, _bh);
+    if (_r < 0) { return _r; }
+    if (_l != _r) { return -1; }
+    return _l;
+}
+};
+
+
+/// __rank_balance__ implement
+namespace __rank_balance__ {
+template <typename _Node> bool _S_odd(const _Node* _x) {
+    return _x == nullptr || _x->_M_color() == _S_black;
+};
+template <typename _Node> void _S_flip(_Node* _x) {
+    _x->_M_set_color(_x->_M_color() == _S_black ? _S_red : _S_black);
+};
+template <typename _Node> int _S_diff(const _Node* _x, const _Node* _p) {
+    return _S_odd(_x) == _S_odd(_p) ? 2 : 1;
+};
+/**
+ * @details
+ *   %_x is a new leaf (rank 0), it's a 0-child of %_p if %_p was a leaf.
+ *   while %_x is a 0-child of %_p (same rank parity), name the sibling of %_x as %_s :
+ *     case 1: %_s is a 1-child, promote %_p, and iterate with %_p as %_x.
+ *     case 2: %_s is a 2-child, name the inner child of %_x as %_y
+ *       case 2.1: %_y is a 2-child (or nullptr), rotate %_x up, demote %_p, done.
+ *       case 2.2: %_y is a 1-child, rotate %_y up twice, promote %_y, demote %_x and %_p, done.
+ *   after a promotion, the rank difference of %_p is 0 or 1, so the parity tells 0-child correctly.
+*/
+template <typename _Node> void _S_insert_rebalance(_Node* _x, _Node* _header) {
+    _Node* _p = _x->_M_parent();
+    while (_p != _header && _S_odd(_x) == _S_odd(_p)) {
+        const bool _x_left = (_x == _p->_left);
+        _Node* const _s = _x_left ? _p->_right : _p->_left;
+        if (_S_diff(_s, _p) == 1) { // case 1
+            _S_flip(_p);
+            _x = _p;
+            _p = _p->_M_parent();
+            continue;
+        }
+        _Node* const _y = _x_left ? _x->_right : _x->_left;
+        if (_S_diff(_y, _x) == 2) { // case 2.1
+            __bitree__::_S_rotate_up(_x, _header);
+            _S_flip(_p);
+        }
+        else { // case 2.2
+            __bitree__::_S_rotate_up(_y, _header);
+            __bitree__::_S_rotate_up(_y, _header);
+            _S_flip(_y);
+            _S_flip(_x);
+            _S_flip(_p);
+        }
+        break;
+    }
+};
+template <typename _Node> int _S_rank(const _Node* _s, bool _avl) {
+    if (_s == nullptr) { return -1; }
+    const int _l = _S_rank(_s->_left, _avl);
+    if (_l < -1) { return _l; }
+    const int _r = _S_rank(_s->_right, _avl);
+    if (_r < -1) { return _r; }
+    const int _dl = _S_diff(_s->_left, _s);
+    const int _dr = _S_diff(_s->_right, _s);
+    if (_l + _dl != _r + _dr) { return -4; }
+    if (_dl == 2 && _dr == 2) {
+        if (_s->_left == nullptr && _s->_right == nullptr) { return -2; }
+        if (_avl) { return -3; }
+    }
+    return _l + _dl;
+};
+/**
+ * @returns 0 : normal ;
+ *   1 : 2,2 leaf ;
+ *   2 : 2,2 node in AVL ;
+ *   3 : error in rank .
+*/
+template <typename _Node> int _S_check(const _Node* _header, bool _avl) {
+    const int _rk = _S_rank(_header->_M_parent(), _avl);
+    return _rk >= -1 ? 0 : -1 - _rk;
+};
+};
+
+};
+
+#endif // _ASP_RB_TREE_POLICY_HPP_
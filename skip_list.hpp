@@ -6,8 +6,10 @@
 #include "associative_container_aux.hpp"
 #include "random.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <unordered_map>
+#include <vector>
 
 namespace asp {
 
@@ -15,6 +17,14 @@ template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey,
  typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>> class skip_list;
 template <typename _Value, typename _Alloc = std::allocator<_Value>> struct skip_list_alloc;
 
+/**
+ * @brief allocator of @skip_list
+ * @details
+ *   a node and its tower (the %_next pointers and their %_width) share one allocation : the tower follows the node,
+ *   so following a link costs one cache miss instead of two.
+ *   nodes are carved from slabs of their own height, and freed nodes are kept in a free list per height,
+ *   so there is no per-node allocation overhead, and the slabs are released with the allocator.
+*/
 template <typename _Value, typename _Alloc> struct skip_list_alloc : public _Alloc {
     typedef skip_list_node<_Value> node_type;
     typedef node_type* map_type;
@@ -24,32 +34,36 @@ template <typename _Value, typename _Alloc> struct skip_list_alloc : public _All
     typedef std::allocator_traits<node_allocator_type> node_alloc_traits;
     typedef typename elt_alloc_traits::template rebind_alloc<node_type*> map_allocator_type;
     typedef std::allocator_traits<map_allocator_type> map_alloc_traits;
+    typedef typename elt_alloc_traits::template rebind_alloc<size_type> width_allocator_type;
+    typedef std::allocator_traits<width_allocator_type> width_alloc_traits;
+
+    // heights of pooled towers are in [1, _S_pool_height]
+    static constexpr const size_type _S_pool_height = 64;
+
+    skip_list_alloc() = default;
+    skip_list_alloc(const skip_list_alloc&) = delete;
+    ~skip_list_alloc() { _M_release_pool(); }
 
     elt_allocator_type& _M_get_elt_allocator() { return *static_cast<elt_allocator_type*>(this); }
     const elt_allocator_type& _M_get_elt_allocator() const { return *static_cast<const elt_allocator_type*>(this); }
     node_allocator_type _M_get_node_allocator() const { return node_allocator_type(_M_get_elt_allocator()); }
     map_allocator_type _M_get_map_allocator() const { return map_allocator_type(_M_get_elt_allocator()); }
+    width_allocator_type _M_get_width_allocator() const { return width_allocator_type(_M_get_elt_allocator()); }
 
-    node_type* _M_allocate_node(const node_type& _x) {
+    template <typename... _Args> node_type* _M_allocate_node(size_type _height, _Args&&... _args) {
         node_allocator_type _node_alloc = _M_get_node_allocator();
-        auto _ptr = node_alloc_traits::allocate(_node_alloc, 1);
-        node_type* _p = std::addressof(*_ptr);
-        node_alloc_traits::construct(_node_alloc, _p, _x.val());
-        return _p;
-    }
-    template <typename... _Args> node_type* _M_allocate_node(_Args&&... _args) {
-        node_allocator_type _node_alloc = _M_get_node_allocator();
-        auto _ptr = node_alloc_traits::allocate(_node_alloc, 1);
-        node_type* _p = std::addressof(*_ptr);
+        node_type* _p = _M_pop(_height);
         node_alloc_traits::construct(_node_alloc, _p, std::forward<_Args>(_args)...);
+        _p->_next = _S_tower(_p);
+        _p->_width = reinterpret_cast<size_type*>(_p->_next + _height);
+        _p->_height = _height;
         return _p;
     }
     void _M_deallocate_node(node_type* _p) {
         node_allocator_type _node_alloc = _M_get_node_allocator();
-        if (_p->_next != nullptr)
-            _M_deallocate_map(_p->_next, _p->_height);
+        const size_type _height = _p->_height;
         node_alloc_traits::destroy(_node_alloc, _p);
-        node_alloc_traits::deallocate(_node_alloc, _p, 1);
+        _M_push(_p, _height);
     }
 
     map_type* _M_allocate_map(size_type _n) {
@@ -62,6 +76,75 @@ template <typename _Value, typename _Alloc> struct skip_list_alloc : public _All
         map_allocator_type _map_alloc = _M_get_map_allocator();
         map_alloc_traits::deallocate(_map_alloc, _p, _n);
     }
+    size_type* _M_allocate_width(size_type _n) {
+        width_allocator_type _width_alloc = _M_get_width_allocator();
+        size_type* _p = width_alloc_traits::allocate(_width_alloc, _n);
+        bzero(_p, sizeof(size_type) * _n);
+        return _p;
+    }
+    void _M_deallocate_width(size_type* _p, size_type _n) {
+        width_allocator_type _width_alloc = _M_get_width_allocator();
+        width_alloc_traits::deallocate(_width_alloc, _p, _n);
+    }
+
+private:
+    // the tower (%_h pointers then %_h widths) starts at %_S_tower_offset, a node of height %_h takes %_S_stride(_h) bytes
+    static constexpr const std::size_t _S_tower_offset = (sizeof(node_type) + alignof(map_type) - 1) / alignof(map_type) * alignof(map_type);
+    static constexpr std::size_t _S_stride(size_type _h) {
+        return (_S_tower_offset + _h * (sizeof(map_type) + sizeof(size_type)) + alignof(node_type) - 1) / alignof(node_type) * alignof(node_type);
+    }
+    static map_type* _S_tower(node_type* _p) {
+        return reinterpret_cast<map_type*>(reinterpret_cast<char*>(_p) + _S_tower_offset);
+    }
+    // a free node keeps the next free node of the same height in its tower
+    static node_type*& _S_free_next(node_type* _p) { return *_S_tower(_p); }
+
+    // the first slab of a height holds %_S_min_slab nodes, and it doubles until %_S_max_slab
+    static constexpr const size_type _S_min_slab = 4;
+    static constexpr const size_type _S_max_slab = 256;
+
+    struct _Slab {
+        node_type* _ptr;
+        std::size_t _units; // in sizeof(node_type)
+    };
+    node_type* _m_free[_S_pool_height] = {};
+    size_type _m_slab_nodes[_S_pool_height] = {};
+    std::vector<_Slab> _m_slabs;
+
+    node_type* _M_pop(size_type _height) {
+        node_type*& _free = _m_free[_height - 1];
+        if (_free == nullptr) {
+            _M_grow(_height);
+        }
+        node_type* _p = _free;
+        _free = _S_free_next(_p);
+        return _p;
+    }
+    void _M_push(node_type* _p, size_type _height) {
+        _S_free_next(_p) = _m_free[_height - 1];
+        _m_free[_height - 1] = _p;
+    }
+    // allocate a slab of nodes of %_height, and push them into the free list
+    void _M_grow(size_type _height) {
+        size_type& _n = _m_slab_nodes[_height - 1];
+        _n = _n == 0 ? _S_min_slab : std::min(_n * 2, _S_max_slab);
+        const std::size_t _stride = _S_stride(_height);
+        const std::size_t _units = (_n * _stride + sizeof(node_type) - 1) / sizeof(node_type);
+        node_allocator_type _node_alloc = _M_get_node_allocator();
+        node_type* const _slab = std::addressof(*node_alloc_traits::allocate(_node_alloc, _units));
+        _m_slabs.push_back(_Slab{_slab, _units});
+        char* const _base = reinterpret_cast<char*>(_slab);
+        for (size_type _i = _n; _i > 0; --_i) {
+            _M_push(reinterpret_cast<node_type*>(_base + (_i - 1) * _stride), _height);
+        }
+    }
+    void _M_release_pool() {
+        node_allocator_type _node_alloc = _M_get_node_allocator();
+        for (const _Slab& _s : _m_slabs) {
+            node_alloc_traits::deallocate(_node_alloc, _s._ptr, _s._units);
+        }
+        _m_slabs.clear();
+    }
 };
 
 /**
@@ -121,7 +204,11 @@ public:
     template <typename _K, typename _V, typename _EK, bool _UK, typename _C, typename _A>
      friend std::ostream& operator<<(std::ostream& os, const skip_list<_K, _V, _EK, _UK, _C, _A>& _sl);
 public:
-    skip_list() { _M_set_node_height(&_mark, _S_max_height); _M_init_mark(); }
+    /**
+     * @param _p the probability that a node reaches the next level, in (0, 1).
+     *   a smaller one (e.g. 1/4) takes less memory for the towers, with a little longer searches.
+    */
+    explicit skip_list(double _p = 0.5) : _m_height_prob(_p) { _M_set_node_height(&_mark, _S_max_height); _M_init_mark(); }
     virtual ~skip_list();
 
     iterator begin() { return iterator(_M_begin()); }
@@ -136,24 +223,65 @@ public:
     void clear();
     ireturn_type insert(const value_type& _v);
     size_type erase(const key_type& _k);
+    /**
+     * @brief replace the contents with [_first, _last), sorted by key, in O(n) without random heights.
+     * @details the %_i-th node (from 1) is %1 + j high, where %b^j is the largest power of %b = round(1 / p)
+     *   dividing %_i, so each level holds every %b-th node of the level below.
+     *   equal keys are kept once in unique containers.
+    */
+    template <typename _InputIt> void assign_sorted(_InputIt _first, _InputIt _last);
 
-    iterator lower_bound(const key_type& _k) { return _M_lower_bound(_M_begin(), _M_end(), _k); }
-    const_iterator lower_bound(const key_type& _k) const { return _M_lower_bound(_M_begin(), _M_end(), _k); }
-    iterator upper_bound(const key_type& _k) { return _M_upper_bound(_M_begin(), _M_end(), _k); }
-    const_iterator upper_bound(const key_type& _k) const { return _M_upper_bound(_M_begin(), _M_end(), _k); }
+    iterator lower_bound(const key_type& _k) { return _M_lower_bound(_M_end(), _M_end(), _k); }
+    const_iterator lower_bound(const key_type& _k) const { return _M_lower_bound(_M_end(), _M_end(), _k); }
+    iterator upper_bound(const key_type& _k) { return _M_upper_bound(_M_end(), _M_end(), _k); }
+    const_iterator upper_bound(const key_type& _k) const { return _M_upper_bound(_M_end(), _M_end(), _k); }
     // std::pair<iterator, iterator> equal_range(const key_type& _k);
     // std::pair<const_iterator, const_iterator> equal_range(const key_type& _k) const;
+    /**
+     * @brief batched lookups, %_out[_i] = lower_bound(_keys[_i]) (find(_keys[_i])) for %_i in [0, _n).
+     * @details %_Group lookups walk down the levels interleaved, see @asso_container::interleave.
+    */
+    template <size_type _Group = 8> void lower_bound_batch(const key_type* _keys, size_type _n, const_iterator* _out) const;
+    template <size_type _Group = 8> void find_batch(const key_type* _keys, size_type _n, const_iterator* _out) const;
+    /**
+     * @brief finger for lookups with ascending keys, see @skip_list::cursor.
+    */
+    class cursor;
+    cursor make_cursor() const { return cursor(*this); }
+
+    /**
+     * @brief positional access and rank queries in expected O(log(n)), by the span widths of links.
+    */
+    // the %_k-th (from 0) element, end() if %_k >= size()
+    iterator at(size_type _k) { return iterator(const_cast<node_type*>(_M_at(_k))); }
+    const_iterator at(size_type _k) const { return const_iterator(_M_at(_k)); }
+    // the number of elements less than %_k
+    size_type rank(const key_type& _k) const;
+    // erase the %_k-th (from 0) element, @returns 0 if %_k >= size()
+    size_type erase_at(size_type _k);
+    // the number of elements in [_lo, _hi)
+    size_type count_range(const key_type& _lo, const key_type& _hi) const {
+        return _M_key_compare(_lo, _hi) ? rank(_hi) - rank(_lo) : 0;
+    }
 
     //used for test
     int check() const;
 
 protected:
-    static constexpr const size_type _S_max_height = 8;
-    static constexpr const double _S_height_prob = 0.5;
+    // the height of %_mark, no node is higher
+    static constexpr const size_type _S_max_height = 32;
+
+    double _m_height_prob;
+    /**
+     * @brief the height of new nodes is limited by %_m_max_height, which grows as log_{1/p}(n) + 1,
+     *   so the upper levels don't saturate on large lists. it allows %_m_height_capacity = (1/p)^(h-1) elements.
+    */
+    size_type _m_max_height = 1;
+    double _m_height_capacity = 1;
 
     bool _log_height = true;
 
-    void _M_init_mark() { _mark._prev = &_mark; _mark._next[0] = &_mark; _mark._height = 1; }
+    void _M_init_mark() { _mark._prev = &_mark; _mark._next[0] = &_mark; _mark._width[0] = 1; _mark._height = 1; }
 
     node_type* _M_begin() { return _mark._next[0]; }
     const node_type* _M_begin() const { return _mark._next[0]; }
@@ -186,7 +314,13 @@ protected:
      *   └─┘   └─┘   └─┘   └─┘   └─┘   └─┘   └─┘   └─┘   └─┘
      *  _mark   1     3     5     5     7     8     9   _mark
     */
-    map_type* _M_dirty_list_prek(const key_type& _k);
+    map_type* _M_dirty_list_prek(const key_type& _k, size_type* _rank = nullptr);
+    /**
+     * @brief the predecessors of the %_pos-th node (from 1, %_mark is the 0th) on each level.
+    */
+    map_type* _M_dirty_list_at(size_type _pos);
+    // the %_k-th (from 0) node, %_mark if %_k >= size()
+    const node_type* _M_at(size_type _k) const;
 
     // @brief unique_insert
     std::pair<iterator, bool> _M_insert(const value_type& _v, asp::true_type);
@@ -195,49 +329,107 @@ protected:
     size_type _M_erase(const key_type& _k);
 
     size_type _M_current_height() const { return _mark._height; }
+    // raise %_m_max_height for %_n elements
+    void _M_reserve_height(size_type _n);
+    // (re)allocate the tower of %_mark, which is apart from the node pool
     void _M_set_node_height(node_type* const _x, size_type _ht);
 
 private:
-    void _M_insert_aux(map_type* _dirty_list, size_type _n, node_type* _x);
-    node_type* _M_erase_aux(map_type* _dirty_list, size_type _n, node_type* const _s);
+    /**
+     * @brief link %_x, whose height is set, after the nodes of %_dirty_list.
+     * @param _rank %_rank[_i] is the position of %_dirty_list[_i] (%_mark at 0)
+    */
+    void _M_insert_aux(map_type* _dirty_list, const size_type* _rank, size_type _n, node_type* _x);
+    /**
+     * @brief unlink the %_cnt nodes from %_dirty_list[0]->_next[0] to %_s.
+     * @return the first unlinked node, the unlinked nodes end with nullptr.
+    */
+    node_type* _M_erase_aux(map_type* _dirty_list, size_type _n, node_type* const _s, size_type _cnt);
     size_type _M_random_height() const;
 };
 
+/**
+ * @brief finger search on @skip_list, for lookups with ascending keys.
+ * @details it remembers the search path of the last key (the last node less than it on each level).
+ *   the levels whose successor is less than the next key %_k form a prefix,
+ *   %seek(_k) climbs them and walks down from the top one, in expected O(log(d)) for a distance %d between the results.
+ *   so merging a sorted sequence of %m keys into the list costs O(m * log(n / m)) instead of O(m * log(n)).
+ *   seeking a smaller key restarts from %_mark. invalidated by insertion and erasure of the list.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+class skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::cursor {
+public:
+    explicit cursor(const self& _l) : _m_list(&_l) { reset(); }
+
+    // lower_bound(_k)
+    const_iterator seek(const key_type& _k);
+    const_iterator position() const {
+        const node_type* _n = _m_path[0]->_M_next();
+        return _m_list->_M_valid_pointer(_n) ? const_iterator(_n) : _m_list->cend();
+    }
+    void reset() {
+        for (size_type _i = 0; _i < _S_max_height; ++_i) {
+            _m_path[_i] = &_m_list->_mark;
+        }
+    }
+
+private:
+    const self* _m_list;
+    const node_type* _m_path[_S_max_height];
+};
+
 /// skip_list private implement
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
-_M_insert_aux(map_type* _dirty_list, size_type _n, node_type* _x) -> void {
+_M_insert_aux(map_type* _dirty_list, const size_type* _rank, size_type _n, node_type* _x) -> void {
     node_type* const _s = _dirty_list[0];
-    size_type _r_level = _M_random_height();
-    // _x->_next = this->_M_allocate_map(_r_level);
+    const size_type _r_level = _x->_height;
+    const size_type _pos = _rank[0] + 1;
     if (node_type* _s_next = _s->_M_next()) {
         _s_next->_prev = _x;
     }
-    _M_set_node_height(_x, _r_level);
     for (int _i = 0; _i < std::min(_r_level, _n); ++_i) {
-        _x->_next[_i] = _dirty_list[_i]->_next[_i];
-        _dirty_list[_i]->_next[_i] = _x;
+        node_type* const _d = _dirty_list[_i];
+        _x->_next[_i] = _d->_next[_i];
+        _x->_width[_i] = _d->_width[_i] + 1 - (_pos - _rank[_i]);
+        _d->_next[_i] = _x;
+        _d->_width[_i] = _pos - _rank[_i];
+    }
+    for (size_type _i = _r_level; _i < _n; ++_i) {
+        ++_dirty_list[_i]->_width[_i];
     }
     _x->_prev = _s;
     if (_r_level > _n) {
         for (int _i = _n; _i < _r_level; ++_i) {
             _x->_next[_i] = _M_end();
+            _x->_width[_i] = _m_element_count + 2 - _pos;
             _mark._next[_i] = _x;
+            _mark._width[_i] = _pos;
         }
         _mark._height = _r_level;
     }
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
-_M_erase_aux(map_type* _dirty_list, size_type _n, node_type* const _s) -> node_type* {
+_M_erase_aux(map_type* _dirty_list, size_type _n, node_type* const _s, size_type _cnt) -> node_type* {
     node_type* const _p = _dirty_list[0];
     node_type* const _r = _dirty_list[0]->_M_next();
-    node_type* _rs = _s;
-    for (int _i = 0; _i < _n && _rs != _p; ++_i) {
-        while (_i >= _rs->_height) {
+    node_type* _rs = _s; // the last unlinked node on level %_i
+    for (size_type _i = 0; _i < _n; ++_i) {
+        node_type* const _d = _dirty_list[_i];
+        while (_rs != _p && _i >= _rs->_height) {
             _rs = _rs->_prev;
         }
-        _dirty_list[_i]->_next[_i] = _rs->_next[_i];
+        if (_rs == _p) { // no unlinked node on level %_i
+            _d->_width[_i] -= _cnt;
+            continue;
+        }
+        size_type _w = _d->_width[_i];
+        for (node_type* _y = _d->_next[_i]; _y != _rs; _y = _y->_next[_i]) {
+            _w += _y->_width[_i];
+        }
+        _d->_next[_i] = _rs->_next[_i];
+        _d->_width[_i] = _w + _rs->_width[_i] - _cnt;
     }
     while (_M_current_height() > 1 && !_M_valid_pointer(_mark._next[_M_current_height() - 1])) {
         --_mark._height;
@@ -251,12 +443,37 @@ template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typ
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
 _M_random_height() const -> size_type {
     size_type _height = 1;
-    while (asp::rand_float() < _S_height_prob && _height < _S_max_height) {
+    while (asp::rand_float() < _m_height_prob && _height < _m_max_height) {
         ++_height;
     }
     return _height;
 };
 
+/// skip_list::cursor implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::cursor
+::seek(const key_type& _k) -> const_iterator {
+    const self& _l = *_m_list;
+    if (_m_path[0] != &_l._mark && !_l._M_key_compare(_S_key(_m_path[0]), _k)) {
+        reset();
+    }
+    const size_type _h = _l._M_current_height();
+    size_type _top = 0;
+    while (_top < _h && _l._M_valid_pointer(_m_path[_top]->_M_next(_top))
+     && _l._M_key_compare(_S_key(_m_path[_top]->_M_next(_top)), _k)) {
+        ++_top;
+    }
+    // the walk on a level passes the path of the levels below
+    const node_type* _x = _top > 0 ? _m_path[_top - 1] : nullptr;
+    for (int _i = int(_top) - 1; _i >= 0; --_i) {
+        while (_l._M_valid_pointer(_x->_M_next(_i)) && _l._M_key_compare(_S_key(_x->_M_next(_i)), _k)) {
+            _x = _x->_M_next(_i);
+        }
+        _m_path[_i] = _x;
+    }
+    return position();
+};
+
 /// skip_list protected implement
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
@@ -271,12 +488,7 @@ _M_lower_bound(node_type* _x, node_type* _y, const key_type& _k) -> iterator {
         }
     }
     node_type* _n = _x->_M_next();
-    if (_M_valid_pointer(_n) && !_M_key_compare(_k, _S_key(_n))) {
-        return iterator(_n);
-    }
-    else {
-        return iterator(_y);
-    }
+    return _M_valid_pointer(_n) ? iterator(_n) : iterator(_y);
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
@@ -291,12 +503,7 @@ _M_lower_bound(const node_type* _x, const node_type* _y, const key_type& _k) con
         }
     }
     node_type* _n = _x->_M_next();
-    if (_M_valid_pointer(_n) && !_M_key_compare(_k, _S_key(_n))) {
-        return const_iterator(_n);
-    }
-    else {
-        return const_iterator(_y);
-    }
+    return _M_valid_pointer(_n) ? const_iterator(_n) : const_iterator(_y);
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
@@ -311,12 +518,7 @@ _M_upper_bound(node_type* _x, node_type* _y, const key_type& _k) -> iterator {
         }
     }
     node_type* _n = _x->_M_next();
-    if (_M_valid_pointer(_n) && !_M_key_compare(_k, _S_key(_n))) {
-        return iterator(_n);
-    }
-    else {
-        return iterator(_y);
-    }
+    return _M_valid_pointer(_n) ? iterator(_n) : iterator(_y);
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
@@ -331,19 +533,14 @@ _M_upper_bound(const node_type* _x, const node_type* _y, const key_type& _k) con
         }
     }
     node_type* _n = _x->_M_next();
-    if (_M_valid_pointer(_n) && !_M_key_compare(_k, _S_key(_n))) {
-        return const_iterator(_n);
-    }
-    else {
-        return const_iterator(_y);
-    }
+    return _M_valid_pointer(_n) ? const_iterator(_n) : const_iterator(_y);
 };
 
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
-_M_dirty_list_prek(const key_type& _k) -> map_type* {
+_M_dirty_list_prek(const key_type& _k, size_type* _rank) -> map_type* {
     map_type* _ret = this->_M_allocate_map(_M_current_height());
-    difference_type _cnt = 0;
+    size_type _pos = 0;
     node_type* _x = &_mark;
     for (int _i = _M_current_height() - 1; _i >= 0; --_i) {
         while (_M_valid_pointer(_x->_M_next(_i))) {
@@ -351,17 +548,53 @@ _M_dirty_list_prek(const key_type& _k) -> map_type* {
             if (!_M_key_compare(_S_key(_n), _k)) {
                 break;
             }
+            _pos += _x->_width[_i];
             _x = _n;
         }
         _ret[_i] = _x;
+        if (_rank != nullptr) {
+            _rank[_i] = _pos;
+        }
+    }
+    return _ret;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_dirty_list_at(size_type _pos) -> map_type* {
+    map_type* _ret = this->_M_allocate_map(_M_current_height());
+    size_type _r = 0;
+    node_type* _x = &_mark;
+    for (int _i = _M_current_height() - 1; _i >= 0; --_i) {
+        while (_M_valid_pointer(_x->_M_next(_i)) && _r + _x->_width[_i] < _pos) {
+            _r += _x->_width[_i];
+            _x = _x->_M_next(_i);
+        }
+        _ret[_i] = _x;
     }
     return _ret;
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_at(size_type _k) const -> const node_type* {
+    if (_k >= _m_element_count) {
+        return _M_end();
+    }
+    size_type _r = 0;
+    const node_type* _x = &_mark;
+    for (int _i = _M_current_height() - 1; _i >= 0; --_i) {
+        while (_M_valid_pointer(_x->_M_next(_i)) && _r + _x->_width[_i] <= _k + 1) {
+            _r += _x->_width[_i];
+            _x = _x->_M_next(_i);
+        }
+    }
+    return _x;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
 _M_insert(const value_type& _v, asp::true_type) -> std::pair<iterator, bool> {
     size_type _old_height = _M_current_height();
-    map_type* _res = this->_M_dirty_list_prek(_S_key(_v));
+    size_type* _rank = this->_M_allocate_width(_old_height);
+    map_type* _res = this->_M_dirty_list_prek(_S_key(_v), _rank);
 
     const node_type* _bottom_node = _res[0];
     if (_bottom_node != nullptr) {
@@ -369,26 +602,30 @@ _M_insert(const value_type& _v, asp::true_type) -> std::pair<iterator, bool> {
         if (_M_valid_pointer(_bottom_next)) {
             if (!_M_key_compare(_S_key(_v), _S_key(_bottom_next))) {
                 this->_M_deallocate_map(_res, _old_height);
+                this->_M_deallocate_width(_rank, _old_height);
                 return std::make_pair(iterator(_bottom_next), false);
             }
         }
     }
 
-    node_type* _x = this->_M_allocate_node(_v);
-    _M_insert_aux(_res, _old_height, _x);
+    node_type* _x = this->_M_allocate_node(_M_random_height(), _v);
+    _M_insert_aux(_res, _rank, _old_height, _x);
     ++_m_element_count;
     this->_M_deallocate_map(_res, _old_height);
+    this->_M_deallocate_width(_rank, _old_height);
     return std::make_pair(iterator(_x), true);
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
 _M_insert(const value_type& _v, asp::false_type) -> iterator {
     size_type _old_height = _M_current_height();
-    map_type* _res = this->_M_dirty_list_prek(_S_key(_v));
-    node_type* _x = this->_M_allocate_node(_v);
-    _M_insert_aux(_res, _old_height, _x);
+    size_type* _rank = this->_M_allocate_width(_old_height);
+    map_type* _res = this->_M_dirty_list_prek(_S_key(_v), _rank);
+    node_type* _x = this->_M_allocate_node(_M_random_height(), _v);
+    _M_insert_aux(_res, _rank, _old_height, _x);
     ++_m_element_count;
     this->_M_deallocate_map(_res, _old_height);
+    this->_M_deallocate_width(_rank, _old_height);
     return iterator(_x);
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
@@ -407,7 +644,7 @@ _M_erase(const key_type& _k) -> size_type {
         _s = _s->_M_next();
     }
     if (_cnt > 0) {
-        node_type* _p = _M_erase_aux(_res, _old_height, _s);
+        node_type* _p = _M_erase_aux(_res, _old_height, _s, _cnt);
         while (_p != nullptr) {
             node_type* _tmp = _p->_M_next();
             this->_M_deallocate_node(_p);
@@ -419,13 +656,23 @@ _M_erase(const key_type& _k) -> size_type {
     return _cnt;
 };
 
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
+_M_reserve_height(size_type _n) -> void {
+    while (_n > _m_height_capacity && _m_max_height < _S_max_height) {
+        ++_m_max_height;
+        _m_height_capacity /= _m_height_prob;
+    }
+};
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
 auto skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::
 _M_set_node_height(node_type* const _x, size_type _ht) -> void {
     if (_x->_next != nullptr) {
         this->_M_deallocate_map(_x->_next, _x->_height);
+        this->_M_deallocate_width(_x->_width, _x->_height);
     }
     _x->_next = this->_M_allocate_map(_ht);
+    _x->_width = this->_M_allocate_width(_ht);
     _x->_height = _ht;
 };
 
@@ -438,18 +685,87 @@ template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typ
 skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::~skip_list() {
     clear();
     this->_M_deallocate_map(_mark._next, _S_max_height);
+    this->_M_deallocate_width(_mark._width, _S_max_height);
 }
 
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
 skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find(const key_type& _k) const -> const_iterator {
-    const_iterator _j = _M_lower_bound(_M_begin(), _M_end(), _k);
+    const_iterator _j = _M_lower_bound(_M_end(), _M_end(), _k);
     return (_j == cend() || _M_key_compare(_k, _S_key(_j._ptr))) ? cend() : _j;
 };
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+template <size_type _Group> auto
+skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::lower_bound_batch(const key_type* _keys, size_type _n, const_iterator* _out) const
+-> void {
+    // %_x is the last node less than the key on %_level, %_y is its successor on %_level
+    struct _State { size_type _i; size_type _level; const node_type* _x; const node_type* _y; };
+    asso_container::interleave<_Group, _State>(_n,
+        [&](_State& _s, size_type _i) {
+            _s._i = _i;
+            _s._level = _M_current_height() - 1;
+            _s._x = &_mark;
+            _s._y = _mark._M_next(_s._level);
+        },
+        [&](_State& _s) {
+            if (_M_valid_pointer(_s._y) && _M_key_compare(_S_key(_s._y), _keys[_s._i])) {
+                _s._x = _s._y;
+            }
+            else if (_s._level == 0) {
+                _out[_s._i] = _M_valid_pointer(_s._y) ? const_iterator(_s._y) : cend();
+                return false;
+            }
+            else {
+                --_s._level;
+            }
+            _s._y = _s._x->_M_next(_s._level);
+            if (_M_valid_pointer(_s._y)) {
+                __builtin_prefetch(_s._y);
+                __builtin_prefetch(_s._y->_next);
+            }
+            return true;
+        });
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+template <size_type _Group> auto
+skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::find_batch(const key_type* _keys, size_type _n, const_iterator* _out) const
+-> void {
+    lower_bound_batch<_Group>(_keys, _n, _out);
+    for (size_type _i = 0; _i < _n; ++_i) {
+        if (_out[_i] != cend() && _M_key_compare(_keys[_i], _S_key(_out[_i]._ptr))) {
+            _out[_i] = cend();
+        }
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::rank(const key_type& _k) const -> size_type {
+    size_type _r = 0;
+    const node_type* _x = &_mark;
+    for (int _i = _M_current_height() - 1; _i >= 0; --_i) {
+        while (_M_valid_pointer(_x->_M_next(_i)) && _M_key_compare(_S_key(_x->_M_next(_i)), _k)) {
+            _r += _x->_width[_i];
+            _x = _x->_M_next(_i);
+        }
+    }
+    return _r;
+};
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
+skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::erase_at(size_type _k) -> size_type {
+    if (_k >= _m_element_count) {
+        return 0;
+    }
+    size_type _old_height = _M_current_height();
+    map_type* _res = this->_M_dirty_list_at(_k + 1);
+    node_type* _p = _M_erase_aux(_res, _old_height, _res[0]->_M_next(), 1);
+    this->_M_deallocate_node(_p);
+    --_m_element_count;
+    this->_M_deallocate_map(_res, _old_height);
+    return 1;
+};
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
 skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::count(const key_type& _k) const
 -> size_type {
-    const_iterator _first(_M_lower_bound(_M_begin(), _M_end(), _k));
-    const_iterator _last(_M_upper_bound(_M_begin(), _M_end(), _k));
+    const_iterator _first(_M_lower_bound(_M_end(), _M_end(), _k));
+    const_iterator _last(_M_upper_bound(_M_end(), _M_end(), _k));
     return asp::distance(_first, _last);
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
@@ -465,12 +781,57 @@ skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::clear()
     }
     _M_init_mark();
     _m_element_count = 0;
+    _m_max_height = 1;
+    _m_height_capacity = 1;
 };
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
 skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::insert(const value_type& _v)
 -> ireturn_type {
+    _M_reserve_height(_m_element_count + 1);
     return this->_M_insert(_v, asp::bool_t<_UniqueKey>());
 };
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc>
+template <typename _InputIt> auto
+skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::assign_sorted(_InputIt _first, _InputIt _last)
+-> void {
+    clear();
+    // the last node on each level and its position
+    node_type* _tail[_S_max_height];
+    size_type _tail_pos[_S_max_height];
+    for (size_type _i = 0; _i < _S_max_height; ++_i) {
+        _tail[_i] = &_mark;
+        _tail_pos[_i] = 0;
+    }
+    const size_type _base = std::max(size_type(2), size_type(1 / _m_height_prob + 0.5));
+    size_type _n = 0;
+    size_type _top = 1;
+    for (; _first != _last; ++_first) {
+        if (_UniqueKey && _n > 0 && !_M_key_compare(_S_key(_tail[0]), _S_key(*_first))) {
+            continue;
+        }
+        _M_reserve_height(++_n);
+        size_type _h = 1;
+        for (size_type _j = _n; _j % _base == 0 && _h < _m_max_height; _j /= _base) {
+            ++_h;
+        }
+        node_type* _x = this->_M_allocate_node(_h, *_first);
+        _x->_prev = _tail[0];
+        for (size_type _i = 0; _i < _h; ++_i) {
+            _tail[_i]->_next[_i] = _x;
+            _tail[_i]->_width[_i] = _n - _tail_pos[_i];
+            _tail[_i] = _x;
+            _tail_pos[_i] = _n;
+        }
+        _top = std::max(_top, _h);
+    }
+    for (size_type _i = 0; _i < _top; ++_i) {
+        _tail[_i]->_next[_i] = &_mark;
+        _tail[_i]->_width[_i] = _n + 1 - _tail_pos[_i];
+    }
+    _mark._prev = _tail[0];
+    _mark._height = _top;
+    _m_element_count = _n;
+};
 template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc> auto
 skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::erase(const key_type& _k)
 -> size_type {
@@ -485,7 +846,8 @@ skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> in
      * 2 = not in order (store in order could promise that the same value(s) are stored adjacent);
      * 3 = empty height list (%_mark._next[_i] point to %_mark);
      * 4 = the number of traversed nodes is not equal to %_element_count;
-     * 5 = node's height is less than current sublist.
+     * 5 = node's height is less than current sublist;
+     * 6 = a span width is not equal to the distance on the main list.
     */
     size_type _count = 0;
     std::unordered_set<key_type> _uset;
@@ -524,6 +886,23 @@ skip_list<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc>::check() const -> in
         }
         _uset.clear();
     }
+    std::unordered_map<const node_type*, size_type> _pos;
+    _count = 0;
+    for (const node_type* _p = _mark._next[0]; _M_valid_pointer(_p); _p = _p->_next[0]) {
+        _pos[_p] = ++_count;
+    }
+    for (size_type _i = 0; _i < _sl_height; ++_i) {
+        size_type _r = 0;
+        for (const node_type* _p = &_mark; ; _p = _p->_next[_i]) {
+            const node_type* _n = _p->_next[_i];
+            const size_type _nr = _M_valid_pointer(_n) ? _pos[_n] : _m_element_count + 1;
+            if (_p->_width[_i] != _nr - _r) {
+                return 6;
+            }
+            if (!_M_valid_pointer(_n)) { break; }
+            _r = _nr;
+        }
+    }
     return 0;
 };
 
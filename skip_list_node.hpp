@@ -28,8 +28,13 @@ template <typename _Value> struct skip_list_node : public node<_Value> {
     /**
      * @brief next pointers.
      *   _next[0] is the real next pointer in list, the others are index pointer.
+     *   the pointers follow the node in the same allocation, see @skip_list_alloc.
     */
     self** _next = nullptr;
+    /**
+     * @brief span widths, %_width[_i] is the number of steps from this node to %_next[_i] on the main list.
+    */
+    size_type* _width = nullptr;
     self* _prev = nullptr;
     size_type _height = 1;
 
@@ -0,0 +1,293 @@
+#ifndef _ASP_SLRU_TABLE_HPP_
+#define _ASP_SLRU_TABLE_HPP_
+
+#include "associative_container_aux.hpp"
+#include "hash_table.hpp"
+#include "list.hpp"
+
+#include "basic_io.hpp"
+
+namespace asp {
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<_Value>,
+ bool _TwoQueue = false
+> struct slru_table;
+
+namespace {
+template <typename _ExtOp> struct _select_slru_iter_action {
+    // _Tp == std::pair<list iterator, segment>
+    template <typename _Tp> auto operator()(const _Tp& _x) const {
+        return _ExtOp()(*_x.first);
+    }
+};
+struct _select_slru_ghost_action {
+    template <typename _Iter> auto operator()(_Iter _x) const {
+        return *_x;
+    }
+};
+};
+
+/**
+ * @brief cache structure of segmented LRU, a probationary and a protected segment
+ * @details
+ *   a new element enters the probationary segment, a hit there promotes it to the protected segment,
+ *   whose LRU one is demoted back to the front of probation when it exceeds %protected_capacity().
+ *   the victim is the LRU one of probation (of protected if probation is empty),
+ *   so elements used once, such as a scan, never push out the protected ones.
+ *   both segments are @list, one hash table maps a key to its list node and segment,
+ *   nodes are moved between the segments by %list::splice.
+ * @tparam _TwoQueue
+ *   true to use 2Q instead : probation is the FIFO A1in (a hit there doesn't move the element),
+ *   protected is the LRU Am. evicting from A1in (when it exceeds its share) keeps the key in the ghost FIFO A1out
+ *   of %ghost_capacity() keys, and only putting a key of A1out enters Am. otherwise the LRU one of Am is evicted.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue>
+struct slru_table {
+    typedef slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue> self;
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef list<_Value, _Alloc> list_t;
+    typedef list<_Key, typename std::allocator_traits<_Alloc>::template rebind_alloc<_Key>> ghost_list_t;
+    typedef typename list_t::iterator iterator;
+    typedef typename list_t::const_iterator const_iterator;
+    typedef typename ghost_list_t::iterator ghost_iterator;
+    enum segment : unsigned char { __PROBATION__ = 0, __PROTECTED__ };
+    typedef hash_table<_Key, std::pair<iterator, segment>, _select_slru_iter_action<_ExtKey>, true, _select_slru_iter_action<_ExtValue>, _Hash, _Alloc> hash_table_t;
+    typedef hash_table<_Key, ghost_iterator, _select_slru_ghost_action, true, _select_slru_ghost_action, _Hash, _Alloc> ghost_table_t;
+    typedef asso_container::type_traits<_Value, true> _ContainerTypeTraits;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+
+    static constexpr const size_type _S_default_protected_percent = 80;
+    // the size of A1out, in percent of the capacity (2Q only)
+    static constexpr const size_type _S_ghost_percent = 50;
+
+protected:
+    list_t _m_lists[2];
+    hash_table_t _h;
+    ghost_list_t _m_ghosts; // 2Q only
+    ghost_table_t _g;
+    size_type _m_capacity;
+    size_type _m_protected_percent;
+    size_type _m_protected_capacity;
+
+public:
+/// (de)constructor
+    // %_protected_percent : the share of the capacity for the protected segment (Am), the rest is probation (A1in)
+    slru_table(size_type _capacity, size_type _protected_percent = _S_default_protected_percent)
+     : _m_protected_percent(_protected_percent < 100 ? _protected_percent : 100) { _M_set_capacity(_capacity); }
+    slru_table(const self& _rhs) : _m_protected_percent(_rhs._m_protected_percent) { _M_assign(_rhs); }
+    self& operator=(const self& _rhs);
+    virtual ~slru_table() = default;
+
+    size_type size() const { return _h.size(); }
+    size_type capacity() const { return _m_capacity; }
+    size_type protected_capacity() const { return _m_protected_capacity; }
+    size_type ghost_capacity() const { return _TwoQueue ? _m_capacity * _S_ghost_percent / 100 : 0; }
+    bool empty() const { return size() == 0; }
+    void clear();
+    void resize(size_type _new_capacity);
+    const_iterator get(const key_type& _k);
+    void put(const value_type& _v);
+
+    const_iterator cend() const { return _m_lists[__PROBATION__].cend(); }
+
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, bool _Q>
+     friend std::ostream& operator<<(std::ostream& _os, const slru_table<_K, _T, _Ek, _Ev, _H, _A, _Q>& _x);
+
+    int check() const;
+
+protected:
+    size_type _M_probation_capacity() const { return _m_capacity - _m_protected_capacity; }
+    void _M_set_capacity(size_type _capacity);
+    void _M_assign(const self& _rhs);
+    // move %_i to the front of segment %_t
+    void _M_move(std::pair<iterator, segment>& _i, segment _t);
+    void _M_on_hit(std::pair<iterator, segment>& _i);
+    void _M_push_front(const value_type& _v, segment _s);
+    void _M_push_ghost(const key_type& _k);
+    // demote the overflow of protected (SLRU), then evict until %size() <= %capacity()
+    void _M_evict();
+};
+
+/// protected implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_set_capacity(size_type _capacity) -> void {
+    _m_capacity = _capacity;
+    _m_protected_capacity = _capacity * _m_protected_percent / 100;
+    if (_TwoQueue && _m_protected_capacity == _capacity && _capacity > 0) {
+        --_m_protected_capacity; // A1in can't be empty
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_assign(const self& _rhs) -> void {
+    _M_set_capacity(_rhs._m_capacity);
+    for (unsigned _s = __PROBATION__; _s <= __PROTECTED__; ++_s) {
+        _m_lists[_s] = _rhs._m_lists[_s];
+        for (iterator _i = _m_lists[_s].begin(); _i != _m_lists[_s].end(); ++_i) {
+            _h.insert({_i, segment(_s)});
+        }
+    }
+    _m_ghosts = _rhs._m_ghosts;
+    for (ghost_iterator _i = _m_ghosts.begin(); _i != _m_ghosts.end(); ++_i) {
+        _g.insert(_i);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_move(std::pair<iterator, segment>& _i, segment _t) -> void {
+    _m_lists[_t].splice(_m_lists[_t].cbegin(), _m_lists[_i.second], _i.first);
+    _i.second = _t;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_on_hit(std::pair<iterator, segment>& _i) -> void {
+    if (_i.second == __PROTECTED__) {
+        _m_lists[__PROTECTED__].move_2_front(_i.first);
+    }
+    else if (!_TwoQueue) {
+        _M_move(_i, __PROTECTED__);
+        _M_evict();
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_push_front(const value_type& _v, segment _s) -> void {
+    _m_lists[_s].push_front(_v);
+    _h.insert({_m_lists[_s].begin(), _s});
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_push_ghost(const key_type& _k) -> void {
+    const size_type _n = ghost_capacity();
+    if (_n == 0) return;
+    while (_m_ghosts.size() >= _n) {
+        _g.erase(_m_ghosts.back());
+        _m_ghosts.pop_back();
+    }
+    _m_ghosts.push_front(_k);
+    _g.insert(_m_ghosts.begin());
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::_M_evict() -> void {
+    list_t& _probation = _m_lists[__PROBATION__];
+    list_t& _protected = _m_lists[__PROTECTED__];
+    if (!_TwoQueue) {
+        while (_protected.size() > _m_protected_capacity) {
+            _M_move(*_h.find(_ExtKey()(_protected.back())), __PROBATION__);
+        }
+    }
+    while (size() > _m_capacity) {
+        segment _s = _probation.empty() ? __PROTECTED__ : __PROBATION__;
+        if (_TwoQueue && _probation.size() <= _M_probation_capacity() && !_protected.empty()) {
+            _s = __PROTECTED__;
+        }
+        const key_type _k = _ExtKey()(_m_lists[_s].back());
+        _h.erase(_k);
+        _m_lists[_s].pop_back();
+        if (_TwoQueue && _s == __PROBATION__) {
+            _M_push_ghost(_k);
+        }
+    }
+};
+
+/// public implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::operator=(const self& _rhs) -> self& {
+    if (&_rhs == this) return *this;
+    clear();
+    _m_protected_percent = _rhs._m_protected_percent;
+    _M_assign(_rhs);
+    return *this;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::clear() -> void {
+    _h.clear();
+    _g.clear();
+    for (auto& _l : _m_lists) {
+        _l.clear();
+    }
+    _m_ghosts.clear();
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::resize(size_type _new_capacity) -> void {
+    _M_set_capacity(_new_capacity);
+    _M_evict();
+    while (_m_ghosts.size() > ghost_capacity()) {
+        _g.erase(_m_ghosts.back());
+        _m_ghosts.pop_back();
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::get(const key_type& _k) -> const_iterator {
+    auto _i = _h.find(_k);
+    if (_i == _h.end()) return cend();
+    const iterator _r = _i->first;
+    _M_on_hit(*_i);
+    return _r;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::put(const value_type& _v) -> void {
+    if (_m_capacity == 0) return;
+    const key_type& _k = _ExtKey()(_v);
+    auto _i = _h.find(_k);
+    if (_i != _h.end()) {
+        // the value is replaced by a new node at the same place, then it's a hit
+        const segment _s = _i->second;
+        const iterator _n = _i->first;
+        _h.erase(_k);
+        const iterator _r = _m_lists[_s].insert(_m_lists[_s].erase(_n), _v);
+        _M_on_hit(*_h.insert({_r, _s}).first);
+        return;
+    }
+    segment _s = __PROBATION__;
+    if (_TwoQueue) {
+        auto _j = _g.find(_k);
+        if (_j != _g.end()) { // in A1out, seen again after leaving A1in
+            const ghost_iterator _n = *_j;
+            _g.erase(_k);
+            _m_ghosts.erase(_n);
+            _s = __PROTECTED__;
+        }
+    }
+    _M_push_front(_v, _s);
+    _M_evict();
+};
+
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A, bool _Q> auto
+operator<<(std::ostream& _os, const slru_table<_K, _T, _Ek, _Ev, _H, _A, _Q>& _x) -> std::ostream& {
+    typedef slru_table<_K, _T, _Ek, _Ev, _H, _A, _Q> _Table;
+    _os << "{probation: " << _x._m_lists[_Table::__PROBATION__] << ", protected: " << _x._m_lists[_Table::__PROTECTED__];
+    if (_Q) {
+        _os << ", ghosts: " << _x._m_ghosts;
+    }
+    return _os << '}';
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc, bool _TwoQueue> auto
+slru_table<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc, _TwoQueue>::check() const -> int {
+    if (size() > _m_capacity || (!_TwoQueue && _m_lists[__PROTECTED__].size() > _m_protected_capacity)) {
+        return 1;
+    }
+    if (_h.size() != _m_lists[__PROBATION__].size() + _m_lists[__PROTECTED__].size()) {
+        return 2;
+    }
+    for (unsigned _s = __PROBATION__; _s <= __PROTECTED__; ++_s) {
+        for (const_iterator _i = _m_lists[_s].cbegin(); _i != _m_lists[_s].cend(); ++_i) {
+            const auto _j = _h.find(_ExtKey()(*_i));
+            if (_j == _h.cend() || const_iterator(_j->first) != _i || _j->second != _s) {
+                return 3;
+            }
+        }
+    }
+    if (_m_ghosts.size() > ghost_capacity() || _g.size() != _m_ghosts.size()) {
+        return 4;
+    }
+    for (auto _i = _m_ghosts.cbegin(); _i != _m_ghosts.cend(); ++_i) {
+        if (_g.find(*_i) == _g.cend() || _h.find(*_i) != _h.cend()) {
+            return 4;
+        }
+    }
+    return 0;
+};
+
+};
+
+#endif // _ASP_SLRU_TABLE_HPP_
@@ -0,0 +1,206 @@
+#ifndef _ASP_SPLAY_TREE_HPP_
+#define _ASP_SPLAY_TREE_HPP_
+
+#include "rb_tree.hpp"
+
+namespace asp {
+
+template <bool _Semi, unsigned _Depth> struct splay_balance_policy;
+
+/**
+ * @brief self-adjusting binary search tree (Sleator & Tarjan), @rb_tree balanced by @splay_balance_policy
+ * @details
+ *   every insertion, erasure and non-const lookup splays the accessed node towards the root,
+ *   so frequently accessed keys stay near the root, and the amortized cost is O(log(n)),
+ *   which is close to the entropy bound on skewed (e.g. Zipfian) access.
+ *   const lookups (find, lower_bound, count ...) keep the shape, so they are safe for concurrent readers.
+ *   the tree may be linear in depth at times, and no operation of @rb_tree recurses on depth.
+ * @tparam _Policy @splay_balance_policy<_Semi, _Depth>
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Policy> class splay_tree;
+
+namespace __splay__ {
+/**
+ * @brief splay %_x to the root.
+ * @details
+ *   zig : parent of %_x is the root, rotate %_x up.
+ *   zig-zig : %_x and its parent are both left (right) children, rotate the parent up, then %_x.
+ *   zig-zag : otherwise, rotate %_x up twice.
+*/
+template <typename _Node> void _S_splay(_Node* _x, _Node* _header);
+/**
+ * @brief semi-splay %_x towards the root.
+ * @details same as @_S_splay, except that zig-zig only rotates the parent up and continues from the parent,
+ *   which roughly halves the depth of each node on the path with about half of the rotations.
+*/
+template <typename _Node> void _S_semi_splay(_Node* _x, _Node* _header);
+// @returns true if the depth of %_x (root at 0) is no more than %_d
+template <typename _Node> bool _S_depth_within(const _Node* _x, const _Node* _header, unsigned _d);
+};
+
+/**
+ * @brief balancing policy of @splay_tree, see @rb_balance_policy for the interface
+ * @tparam _Semi semi-splay instead of full splay
+ * @tparam _Depth lookups of nodes whose depth <= %_Depth don't restructure the tree (0 to always splay),
+ *   which limits the writes on read-mostly workloads, when the hot keys are already near the root.
+*/
+template <bool _Semi = false, unsigned _Depth = 0> struct splay_balance_policy {
+    template <typename _Node> static void _S_insert_rebalance(_Node* _x, _Node* _header) {
+        _S_adjust(_x, _header);
+    }
+    // splay the parent of the unlinked node
+    template <typename _Node> static void _S_erase_rebalance(_Node*, _Node* _x_parent, _Rb_tree_color, _Node* _header) {
+        if (_x_parent != _header) {
+            _S_adjust(_x_parent, _header);
+        }
+    }
+    // called on the last node visited by a lookup
+    template <typename _Node> static void _S_access(_Node* _x, _Node* _header) {
+        if (_Depth > 0 && __splay__::_S_depth_within(_x, _header, _Depth)) {
+            return;
+        }
+        _S_adjust(_x, _header);
+    }
+    // no balancing rules
+    template <typename _Node> static int _S_check(const _Node*) { return 0; }
+
+private:
+    template <typename _Node> static void _S_adjust(_Node* _x, _Node* _header) {
+        if (_Semi) {
+            __splay__::_S_semi_splay(_x, _header);
+        }
+        else {
+            __splay__::_S_splay(_x, _header);
+        }
+    }
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>, typename _Policy = splay_balance_policy<>>
+class splay_tree : public rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, rb_tree_compact_node<_Value>, _Policy> {
+public:
+    typedef splay_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Policy> self;
+    typedef rb_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, rb_tree_compact_node<_Value>, _Policy> base;
+    typedef typename base::key_type key_type;
+    typedef typename base::node_type node_type;
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+
+public:
+    splay_tree() = default;
+    splay_tree(const self& _s) : base(_s) {}
+    virtual ~splay_tree() = default;
+
+    using base::find;
+    using base::lower_bound;
+    using base::upper_bound;
+    using base::equal_range;
+    iterator find(const key_type& _k);
+    iterator lower_bound(const key_type& _k) { return _M_splay_bound(_k, false); }
+    iterator upper_bound(const key_type& _k) { return _M_splay_bound(_k, true); }
+    std::pair<iterator, iterator> equal_range(const key_type& _k);
+
+protected:
+    /**
+     * @brief lower (upper if %_upper) bound of %_k, and splay the last node on the search path.
+    */
+    iterator _M_splay_bound(const key_type& _k, bool _upper);
+};
+
+/**
+ * @brief @splay_tree with semi-splaying, with the template signature of @rb_tree.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp = std::less<_Key>, typename _Alloc = std::allocator<_Value>>
+using semi_splay_tree = splay_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, splay_balance_policy<true>>;
+
+/// __splay__ implement
+namespace __splay__ {
+template <typename _Node> void _S_splay(_Node* _x, _Node* _header) {
+    while (_x != _header->_M_parent()) {
+        _Node* const _p = _x->_M_parent();
+        if (_p == _header->_M_parent()) { // zig
+            __bitree__::_S_rotate_up(_x, _header);
+            break;
+        }
+        _Node* const _g = _p->_M_parent();
+        if ((_x == _p->_left) == (_p == _g->_left)) { // zig-zig
+            __bitree__::_S_rotate_up(_p, _header);
+            __bitree__::_S_rotate_up(_x, _header);
+        }
+        else { // zig-zag
+            __bitree__::_S_rotate_up(_x, _header);
+            __bitree__::_S_rotate_up(_x, _header);
+        }
+    }
+};
+template <typename _Node> void _S_semi_splay(_Node* _x, _Node* _header) {
+    while (_x != _header->_M_parent()) {
+        _Node* const _p = _x->_M_parent();
+        if (_p == _header->_M_parent()) { // zig
+            __bitree__::_S_rotate_up(_x, _header);
+            break;
+        }
+        _Node* const _g = _p->_M_parent();
+        if ((_x == _p->_left) == (_p == _g->_left)) { // zig-zig
+            __bitree__::_S_rotate_up(_p, _header);
+            _x = _p;
+        }
+        else { // zig-zag
+            __bitree__::_S_rotate_up(_x, _header);
+            __bitree__::_S_rotate_up(_x, _header);
+        }
+    }
+};
+template <typename _Node> bool _S_depth_within(const _Node* _x, const _Node* _header, unsigned _d) {
+    const _Node* const _root = _header->_M_parent();
+    for (unsigned _i = 0; _i <= _d; ++_i, _x = _x->_M_parent()) {
+        if (_x == _root) { return true; }
+    }
+    return false;
+};
+};
+
+
+/// splay_tree implement
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Policy>
+auto splay_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Policy>
+::_M_splay_bound(const key_type& _k, bool _upper) -> iterator {
+    node_type* _x = this->_M_begin();
+    node_type* _y = this->_M_end();
+    node_type* _z = nullptr; // last visited node
+    while (_x != nullptr) {
+        _z = _x;
+        if (_upper ? this->_M_key_compare(_k, base::_S_key(_x)) : !this->_M_key_compare(base::_S_key(_x), _k)) {
+            _y = _x;
+            _x = _x->_left;
+        }
+        else {
+            _x = _x->_right;
+        }
+    }
+    if (_z != nullptr) {
+        _Policy::_S_access(_z, this->_M_end());
+    }
+    return iterator(_y);
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Policy>
+auto splay_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Policy>
+::find(const key_type& _k) -> iterator {
+    iterator _j = _M_splay_bound(_k, false);
+    return (_j == this->end() || this->_M_key_compare(_k, base::_S_key(_j._ptr))) ? this->end() : _j;
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, bool _UniqueKey, typename _Comp, typename _Alloc, typename _Policy>
+auto splay_tree<_Key, _Value, _ExtKey, _UniqueKey, _Comp, _Alloc, _Policy>
+::equal_range(const key_type& _k) -> std::pair<iterator, iterator> {
+    // splaying keeps the nodes, the upper bound stays valid after splaying the lower bound
+    std::pair<iterator, iterator> _r = base::equal_range(_k);
+    if (_r.first != this->end()) {
+        _Policy::_S_access(_r.first._ptr, this->_M_end());
+    }
+    return _r;
+};
+
+};
+
+#endif // _ASP_SPLAY_TREE_HPP_
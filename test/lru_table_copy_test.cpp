@@ -0,0 +1,66 @@
+/**
+ * @brief copies of @lru_map / @lru_set must not refer to the source once it's destroyed
+ * @details g++ -std=c++17 -fsanitize=address -I.. lru_table_copy_test.cpp && ./a.out [seed]
+ *   each round fills a source at random (with ttls), copies it by construction and by assignment,
+ *   destroys the source, then keeps using the copies and compares them with the snapshot of the source.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../lru.hpp"
+
+typedef asp::lru_map<int, int> map_t;
+
+static std::vector<std::pair<int, int>> _content(const map_t& _m) {
+    std::vector<std::pair<int, int>> _r;
+    for (auto _i = _m.cbegin(); _i != _m.cend(); ++_i) {
+        _r.emplace_back(_i->first, _i->second);
+    }
+    return _r;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 _rng(argc > 1 ? std::atoi(argv[1]) : 1);
+    for (int _round = 0; _round < 200; ++_round) {
+        const unsigned _capacity = 1 + _rng() % 32;
+        map_t* _src = new map_t(_capacity);
+        for (int _i = 0; _i < 100; ++_i) {
+            const int _k = _rng() % 48;
+            if (_rng() % 4 == 0) { _src->put({_k, _i}, 1 + _rng() % 8); }
+            else if (_rng() % 2 == 0) { _src->put({_k, _i}); }
+            else { _src->get(_k); }
+        }
+        const auto _expected = _content(*_src);
+        map_t _copy(*_src);
+        map_t _assigned(1);
+        _assigned.put({-1, -1});
+        _assigned = *_src;
+        delete _src;
+        for (map_t* _m : {&_copy, &_assigned}) {
+            if (_content(*_m) != _expected || _m->check() != 0) {
+                std::printf("lru_table copy: mismatch, round %d\n", _round);
+                return 1;
+            }
+            for (const auto& _v : _expected) {
+                auto _i = _m->get(_v.first);
+                if (_i == _m->cend() || _i->second != _v.second) {
+                    std::printf("lru_table copy: lost key %d, round %d\n", _v.first, _round);
+                    return 1;
+                }
+            }
+            for (int _i = 0; _i < 100; ++_i) {
+                _m->put({int(_rng() % 96), _i});
+            }
+            _m->tick(4);
+            _m->tick(16);
+            if (_m->check() != 0) {
+                std::printf("lru_table copy: broken copy, round %d\n", _round);
+                return 1;
+            }
+        }
+    }
+    std::printf("lru_table copy: ok\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @brief randomized test of @rb_tree::cursor, every %seek() is compared with %lower_bound()
+ * @details g++ -std=c++17 -I.. rb_tree_cursor_test.cpp && ./a.out [seed]
+ *   the seeks go forward, backward and repeat the same key, including from the root and the leftmost.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../rb_tree.hpp"
+
+template <typename _Tree> int _test_cursor(unsigned _seed, const char* _name) {
+    std::mt19937 _rng(_seed);
+    for (int _round = 0; _round < 200; ++_round) {
+        _Tree _t;
+        const int _n = _rng() % 64;
+        const int _range = 2 + _rng() % 100;
+        for (int _i = 0; _i < _n; ++_i) {
+            _t.insert(int(_rng() % _range));
+        }
+        if (_t.check() != 0) {
+            std::printf("%s: broken tree, round %d\n", _name, _round);
+            return 1;
+        }
+        auto _c = _t.make_cursor();
+        int _k = int(_rng() % (_range + 2)) - 1;
+        for (int _i = 0; _i < 200; ++_i) {
+            switch (_rng() % 4) {
+            case 0: _k = int(_rng() % (_range + 2)) - 1; break;  // jump
+            case 1: _k += int(_rng() % 4); break;  // forward
+            case 2: _k -= int(_rng() % 4); break;  // backward
+            default: break;  // the same key again
+            }
+            if (_rng() % 50 == 0) {
+                _c.reset();
+            }
+            const auto _r = _c.seek(_k);
+            const auto _e = static_cast<const _Tree&>(_t).lower_bound(_k);
+            if (_r != _e || _c.position() != _e) {
+                std::printf("%s: seek(%d) != lower_bound, round %d step %d\n", _name, _k, _round, _i);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int _argc, char** _argv) {
+    const unsigned _seed = _argc > 1 ? unsigned(std::atoi(_argv[1])) : 1;
+    int _r = 0;
+    _r |= _test_cursor<asp::rb_tree<int, int, asp::_select_self, true>>(_seed, "rb_tree");
+    _r |= _test_cursor<asp::rb_tree<int, int, asp::_select_self, false>>(_seed, "rb_tree(multi)");
+    _r |= _test_cursor<asp::avl_tree<int, int, asp::_select_self, true>>(_seed, "avl_tree");
+    _r |= _test_cursor<asp::wavl_tree<int, int, asp::_select_self, false>>(_seed, "wavl_tree(multi)");
+    if (_r == 0) {
+        std::printf("rb_tree cursor: ok\n");
+    }
+    return _r;
+}
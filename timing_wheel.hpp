@@ -0,0 +1,318 @@
+#ifndef _ASP_TIMING_WHEEL_HPP_
+#define _ASP_TIMING_WHEEL_HPP_
+
+#include "hash_table.hpp"
+#include "list.hpp"
+#include <cstdint>
+#include <limits>
+
+#include "basic_io.hpp"
+
+namespace asp {
+
+// the time of the caller, in any unit (e.g. milliseconds)
+typedef unsigned long long tick_type;
+
+template <typename _Key,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<_Key>
+> class timing_wheel;
+
+template <typename _Key> struct timer_entry {
+    _Key key;
+    tick_type deadline;
+    unsigned short slot; // index of the list holding the entry
+};
+
+namespace {
+struct _select_timer_key {
+    template <typename _Iter> auto operator()(_Iter _x) const {
+        return _x->key;
+    }
+};
+};
+
+/**
+ * @brief deadlines of keys in a hierarchical timing wheel
+ * @details
+ *   %_S_levels wheels of %_S_slots slots, a slot of level l spans %_S_slots^l units of 2^%resolution_bits() time,
+ *   an entry is put in the lowest level whose slot doesn't contain the current unit,
+ *   entries too far away wait in an overflow list.
+ *   %advance() steps the current unit : when the digits of lower levels wrap to 0,
+ *   the current slot of a higher level is cascaded (its entries are placed again, into lower levels),
+ *   then the entries of the current slot of level 0 expire.
+ *   so an entry moves at most %_S_levels times. a bit mask per level marks the occupied slots,
+ *   %advance() jumps to the next unit where a slot is due, so it costs O(1) per due slot, not per unit.
+ *   the entries expire at the first unit not before their deadline (at most a unit late, never early),
+ *   %expired() compares the exact deadline.
+ *   each entry is a node of the slot lists, a hash table maps the key to its node,
+ *   so scheduling and cancelling is O(1), nodes are moved by %list::splice.
+ *   the slots are allocated by the first %schedule().
+*/
+template <typename _Key, typename _Hash, typename _Alloc> class timing_wheel {
+public:
+    typedef timing_wheel<_Key, _Hash, _Alloc> self;
+    typedef _Key key_type;
+    typedef timer_entry<_Key> entry_type;
+    typedef list<entry_type, typename std::allocator_traits<_Alloc>::template rebind_alloc<entry_type>> list_t;
+    typedef typename list_t::iterator iterator;
+    typedef hash_table<_Key, iterator, _select_timer_key, true, _select_self, _Hash, _Alloc> index_t;
+
+    static constexpr const unsigned _S_slot_bits = 6;
+    static constexpr const unsigned _S_slots = 1u << _S_slot_bits;
+    static constexpr const unsigned _S_levels = 4;
+    static constexpr const unsigned _S_overflow = _S_levels * _S_slots; // index of the overflow list
+    static constexpr const tick_type _S_never = std::numeric_limits<tick_type>::max();
+
+/// (de)constructor
+    explicit timing_wheel(unsigned _resolution_bits = 0, tick_type _now = 0)
+     : _m_now(_now), _m_cur(_now >> _resolution_bits), _m_resolution_bits(_resolution_bits) {}
+    timing_wheel(const self& _rhs) : _m_now(_rhs._m_now), _m_cur(_rhs._m_cur), _m_resolution_bits(_rhs._m_resolution_bits) { _M_assign(_rhs); }
+    self& operator=(const self& _rhs);
+    virtual ~timing_wheel() { delete[] _m_slots; }
+
+    size_type size() const { return _m_index.size(); }
+    bool empty() const { return _m_index.size() == 0; }
+    tick_type now() const { return _m_now; }
+    unsigned resolution_bits() const { return _m_resolution_bits; }
+    // cancel all, the time is kept
+    void clear();
+    // %_k expires at %_deadline, replacing its former deadline
+    void schedule(const key_type& _k, tick_type _deadline);
+    // @return whether %_k was scheduled
+    bool cancel(const key_type& _k);
+    // the deadline of %_k, %_S_never if it isn't scheduled
+    tick_type deadline(const key_type& _k) const;
+    bool expired(const key_type& _k) const { return deadline(_k) <= _m_now; }
+    /**
+     * @brief move the time to %_now (never backwards), expiring the entries due
+     * @param _expire : called with the key of each expired entry, after the entry is removed
+     * @return the number of expired entries
+    */
+    template <typename _Fn> size_type advance(tick_type _now, _Fn _expire);
+
+    template <typename _K, typename _H, typename _A> friend std::ostream& operator<<(std::ostream& _os, const timing_wheel<_K, _H, _A>& _x);
+
+    int check() const;
+
+protected:
+    list_t* _m_slots = nullptr;
+    index_t _m_index;
+    tick_type _m_now;
+    tick_type _m_cur; // the current unit, all slots before are processed
+    unsigned _m_resolution_bits;
+    // bit i of level l : slot i of level l isn't empty
+    std::uint64_t _m_occupied[_S_levels] = {};
+
+    void _M_assign(const self& _rhs);
+    // %_cascading : the current unit is being processed, so it's the earliest one, otherwise the next one is
+    unsigned _M_slot_of(tick_type _deadline, bool _cascading = false) const;
+    // move the entry of %_i to the back of the slot of its deadline
+    void _M_place(iterator _i, bool _cascading = false);
+    void _M_cascade(unsigned _slot);
+    // update the bit of %_slot
+    void _M_mark(unsigned _slot);
+    // the first unit after %_m_cur where a slot is due, %_target at most
+    tick_type _M_next_event(tick_type _target) const;
+};
+
+/// protected implement
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::_M_assign(const self& _rhs) -> void {
+    if (_rhs._m_slots == nullptr) return;
+    for (unsigned _s = 0; _s <= _S_overflow; ++_s) {
+        for (auto _i = _rhs._m_slots[_s].cbegin(); _i != _rhs._m_slots[_s].cend(); ++_i) {
+            schedule(_i->key, _i->deadline);
+        }
+    }
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::_M_slot_of(tick_type _deadline, bool _cascading) const -> unsigned {
+    // rounded up, so an entry never expires early
+    tick_type _u = (_deadline >> _m_resolution_bits) + ((_deadline & ((tick_type(1) << _m_resolution_bits) - 1)) != 0);
+    const tick_type _first = _cascading ? _m_cur : _m_cur + 1;
+    if (_u < _first) {
+        _u = _first;
+    }
+    for (unsigned _l = 0; _l < _S_levels; ++_l) {
+        const unsigned _shift = _S_slot_bits * (_l + 1);
+        if ((_u >> _shift) == (_m_cur >> _shift)) {
+            return _l * _S_slots + ((_u >> (_shift - _S_slot_bits)) & (_S_slots - 1));
+        }
+    }
+    return _S_overflow;
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::_M_place(iterator _i, bool _cascading) -> void {
+    const unsigned _t = _M_slot_of(_i->deadline, _cascading);
+    const unsigned _s = _i->slot;
+    _m_slots[_t].splice(_m_slots[_t].cend(), _m_slots[_s], _i);
+    _i->slot = _t;
+    _M_mark(_s);
+    _M_mark(_t);
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::_M_cascade(unsigned _slot) -> void {
+    // the overflow list may keep some, they are appended after the ones to process
+    for (size_type _n = _m_slots[_slot].size(); _n > 0; --_n) {
+        _M_place(_m_slots[_slot].begin(), true);
+    }
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::_M_mark(unsigned _slot) -> void {
+    if (_slot == _S_overflow) return;
+    const std::uint64_t _bit = std::uint64_t(1) << (_slot % _S_slots);
+    if (_m_slots[_slot].empty()) {
+        _m_occupied[_slot / _S_slots] &= ~_bit;
+    }
+    else {
+        _m_occupied[_slot / _S_slots] |= _bit;
+    }
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::_M_next_event(tick_type _target) const -> tick_type {
+    // the occupied slots of a level are all after its current digit
+    tick_type _next = _target;
+    for (unsigned _l = 0; _l < _S_levels; ++_l) {
+        if (_m_occupied[_l] == 0) continue;
+        const unsigned _shift = _S_slot_bits * _l;
+        const tick_type _base = _m_cur >> (_shift + _S_slot_bits) << (_shift + _S_slot_bits);
+        const tick_type _t = _base + (tick_type(__builtin_ctzll(_m_occupied[_l])) << _shift);
+        _next = _t < _next ? _t : _next;
+    }
+    if (!_m_slots[_S_overflow].empty()) {
+        const unsigned _shift = _S_slot_bits * _S_levels;
+        const tick_type _t = ((_m_cur >> _shift) + 1) << _shift;
+        _next = _t < _next ? _t : _next;
+    }
+    return _next;
+};
+
+/// public implement
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::operator=(const self& _rhs) -> self& {
+    if (&_rhs == this) return *this;
+    clear();
+    _m_now = _rhs._m_now;
+    _m_cur = _rhs._m_cur;
+    _m_resolution_bits = _rhs._m_resolution_bits;
+    _M_assign(_rhs);
+    return *this;
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::clear() -> void {
+    if (_m_slots == nullptr) return;
+    _m_index.clear();
+    for (unsigned _s = 0; _s <= _S_overflow; ++_s) {
+        _m_slots[_s].clear();
+    }
+    for (unsigned _l = 0; _l < _S_levels; ++_l) {
+        _m_occupied[_l] = 0;
+    }
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::schedule(const key_type& _k, tick_type _deadline) -> void {
+    if (_m_slots == nullptr) {
+        _m_slots = new list_t[_S_overflow + 1];
+    }
+    auto _j = _m_index.find(_k);
+    if (_j != _m_index.end()) {
+        iterator _i = *_j;
+        _i->deadline = _deadline;
+        _M_place(_i);
+        return;
+    }
+    const unsigned _t = _M_slot_of(_deadline);
+    _m_slots[_t].push_back({_k, _deadline, static_cast<unsigned short>(_t)});
+    _m_index.insert(--_m_slots[_t].end());
+    _M_mark(_t);
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::cancel(const key_type& _k) -> bool {
+    auto _j = _m_index.find(_k);
+    if (_j == _m_index.end()) return false;
+    // the index reads the key through the node, so it's erased first
+    const iterator _i = *_j;
+    const unsigned _s = _i->slot;
+    _m_index.erase(_k);
+    _m_slots[_s].erase(_i);
+    _M_mark(_s);
+    return true;
+};
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::deadline(const key_type& _k) const -> tick_type {
+    const auto _j = _m_index.find(_k);
+    return _j == _m_index.cend() ? _S_never : (*_j)->deadline;
+};
+template <typename _Key, typename _Hash, typename _Alloc> template <typename _Fn> auto
+timing_wheel<_Key, _Hash, _Alloc>::advance(tick_type _now, _Fn _expire) -> size_type {
+    if (_now <= _m_now) return 0;
+    _m_now = _now;
+    const tick_type _target = _now >> _m_resolution_bits;
+    size_type _n = 0;
+    while (_m_cur < _target) {
+        if (empty()) {
+            _m_cur = _target;
+            break;
+        }
+        _m_cur = _M_next_event(_target);
+        // from the top, so the entries cascaded fall into the slots cascaded next
+        if ((_m_cur & ((tick_type(1) << (_S_slot_bits * _S_levels)) - 1)) == 0) {
+            _M_cascade(_S_overflow);
+        }
+        for (unsigned _l = _S_levels - 1; _l > 0; --_l) {
+            if ((_m_cur & ((tick_type(1) << (_S_slot_bits * _l)) - 1)) == 0) {
+                _M_cascade(_l * _S_slots + ((_m_cur >> (_S_slot_bits * _l)) & (_S_slots - 1)));
+            }
+        }
+        const unsigned _s = _m_cur & (_S_slots - 1);
+        while (!_m_slots[_s].empty()) {
+            const key_type _k = _m_slots[_s].front().key;
+            _m_index.erase(_k);
+            _m_slots[_s].pop_front();
+            _M_mark(_s);
+            _expire(_k);
+            ++_n;
+        }
+    }
+    return _n;
+};
+
+template <typename _K, typename _H, typename _A> auto
+operator<<(std::ostream& _os, const timing_wheel<_K, _H, _A>& _x) -> std::ostream& {
+    typedef timing_wheel<_K, _H, _A> _Wheel;
+    _os << "{now: " << _x._m_now << ", timers: [";
+    bool _first = true;
+    for (unsigned _s = 0; _x._m_slots != nullptr && _s <= _Wheel::_S_overflow; ++_s) {
+        for (auto _i = _x._m_slots[_s].cbegin(); _i != _x._m_slots[_s].cend(); ++_i) {
+            _os << (_first ? "" : ", ") << _i->key << '@' << _i->deadline;
+            _first = false;
+        }
+    }
+    return _os << "]}";
+};
+
+template <typename _Key, typename _Hash, typename _Alloc> auto
+timing_wheel<_Key, _Hash, _Alloc>::check() const -> int {
+    if (_m_slots == nullptr) {
+        return _m_index.size() == 0 ? 0 : 1;
+    }
+    size_type _n = 0;
+    for (unsigned _s = 0; _s <= _S_overflow; ++_s) {
+        for (auto _i = _m_slots[_s].cbegin(); _i != _m_slots[_s].cend(); ++_i) {
+            const auto _j = _m_index.find(_i->key);
+            if (_i->slot != _s || _j == _m_index.cend() || &*(*_j) != &*_i) {
+                return 2;
+            }
+            ++_n;
+        }
+        if (_s < _S_overflow && _m_slots[_s].empty() == bool((_m_occupied[_s / _S_slots] >> (_s % _S_slots)) & 1)) {
+            return 3;
+        }
+    }
+    return _n == _m_index.size() ? 0 : 1;
+};
+
+};
+
+#endif // _ASP_TIMING_WHEEL_HPP_
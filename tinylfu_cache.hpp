@@ -0,0 +1,358 @@
+#ifndef _ASP_TINYLFU_CACHE_HPP_
+#define _ASP_TINYLFU_CACHE_HPP_
+
+#include "associative_container_aux.hpp"
+#include "hash_table.hpp"
+#include "list.hpp"
+#include <cstdint>
+
+#include "basic_io.hpp"
+
+namespace asp {
+
+template <typename _Key, typename _Hash = std::hash<_Key>> class count_min_sketch;
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue,
+ typename _Hash = std::hash<_Key>,
+ typename _Alloc = std::allocator<_Value>
+> struct tinylfu_cache;
+
+/**
+ * @brief approximate frequencies of keys in 4-bit counters, %_S_depth rows of %width() counters
+ * @details
+ *   16 counters are packed in a word, the frequency of a key is the minimum of its counters (one per row).
+ *   after %_S_sample_factor * %width() increments, all counters are halved (aging),
+ *   so the frequencies follow the recent history, and a counter saturates at 15.
+*/
+template <typename _Key, typename _Hash> class count_min_sketch {
+public:
+    typedef count_min_sketch<_Key, _Hash> self;
+    typedef _Key key_type;
+
+    static constexpr const size_type _S_depth = 4;
+    static constexpr const size_type _S_sample_factor = 10;
+
+/// (de)constructor
+    // %_n : the expected number of distinct keys, rounded up to a power of 2 (16 at least)
+    explicit count_min_sketch(size_type _n = 16) { _M_allocate(_n); }
+    count_min_sketch(const self& _rhs) = delete;
+    self& operator=(const self& _rhs) = delete;
+    virtual ~count_min_sketch() { delete[] _m_table; }
+
+    size_type width() const { return _m_width; }
+    // reallocate for %_n keys, all frequencies are forgotten
+    void resize(size_type _n) { delete[] _m_table; _M_allocate(_n); }
+    void clear();
+    size_type frequency(const key_type& _k) const;
+    void increment(const key_type& _k);
+
+protected:
+    std::uint64_t* _m_table = nullptr;
+    size_type _m_width = 0; // counters per row
+    size_type _m_additions = 0;
+
+    void _M_allocate(size_type _n);
+    // index of the counter of %_k in row %_d
+    size_type _M_index(std::uint64_t _h, size_type _d) const;
+    static std::uint64_t _S_spread(const key_type& _k);
+    // halve all counters
+    void _M_age();
+};
+
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::_M_allocate(size_type _n) -> void {
+    _m_width = 16;
+    while (_m_width < _n) {
+        _m_width <<= 1;
+    }
+    _m_table = new std::uint64_t[_S_depth * _m_width / 16];
+    clear();
+};
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::_S_spread(const key_type& _k) -> std::uint64_t {
+    // the std hash of integers is the identity, so mix it
+    std::uint64_t _h = static_cast<std::uint64_t>(_Hash()(_k));
+    _h ^= _h >> 33;
+    _h *= 0xff51afd7ed558ccdull;
+    _h ^= _h >> 33;
+    _h *= 0xc4ceb9fe1a85ec53ull;
+    return _h ^ (_h >> 33);
+};
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::_M_index(std::uint64_t _h, size_type _d) const -> size_type {
+    // double hashing
+    const std::uint32_t _h1 = static_cast<std::uint32_t>(_h);
+    const std::uint32_t _h2 = static_cast<std::uint32_t>(_h >> 32) | 1;
+    return _d * _m_width + ((_h1 + _d * _h2) & (_m_width - 1));
+};
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::_M_age() -> void {
+    for (size_type _i = 0; _i < _S_depth * _m_width / 16; ++_i) {
+        _m_table[_i] = (_m_table[_i] >> 1) & 0x7777777777777777ull;
+    }
+    _m_additions /= 2;
+};
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::clear() -> void {
+    for (size_type _i = 0; _i < _S_depth * _m_width / 16; ++_i) {
+        _m_table[_i] = 0;
+    }
+    _m_additions = 0;
+};
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::frequency(const key_type& _k) const -> size_type {
+    const std::uint64_t _h = _S_spread(_k);
+    size_type _ret = 15;
+    for (size_type _d = 0; _d < _S_depth; ++_d) {
+        const size_type _i = _M_index(_h, _d);
+        const size_type _c = (_m_table[_i / 16] >> (_i % 16 * 4)) & 0xf;
+        _ret = _c < _ret ? _c : _ret;
+    }
+    return _ret;
+};
+template <typename _Key, typename _Hash> auto
+count_min_sketch<_Key, _Hash>::increment(const key_type& _k) -> void {
+    const std::uint64_t _h = _S_spread(_k);
+    bool _added = false;
+    for (size_type _d = 0; _d < _S_depth; ++_d) {
+        const size_type _i = _M_index(_h, _d);
+        const size_type _shift = _i % 16 * 4;
+        if (((_m_table[_i / 16] >> _shift) & 0xf) != 0xf) {
+            _m_table[_i / 16] += std::uint64_t(1) << _shift;
+            _added = true;
+        }
+    }
+    if (_added && ++_m_additions == _S_sample_factor * _m_width) {
+        _M_age();
+    }
+};
+
+
+namespace {
+template <typename _ExtOp> struct _select_tinylfu_iter_action {
+    // _Tp == std::pair<list_t::iterator, segment>
+    template <typename _Tp> auto operator()(const _Tp& _x) const {
+        return _ExtOp()(*_x.first);
+    }
+};
+};
+
+/**
+ * @brief cache of W-TinyLFU : a window LRU, and a main segmented LRU guarded by a frequency sketch
+ * @details
+ *   a new element enters the window (%_S_window_percent of the capacity), which absorbs bursts.
+ *   the element leaving the window is a candidate of the main space, if it's full,
+ *   the candidate only replaces the victim (the LRU one in probation) if the sketch estimates it more frequent.
+ *   the main space is a segmented LRU : a hit in probation promotes the element to protected
+ *   (%_S_protected_percent of the main space), whose LRU one is demoted back to probation.
+ *   each access (%get() or %put()) increments the key in the @count_min_sketch,
+ *   which ages periodically, so the admission adapts and a scan can't flush the main space.
+ *
+ *   all elements are in one hash table, mapping a key to its list node and segment,
+ *   nodes are moved between segments by %list::splice.
+*/
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc>
+struct tinylfu_cache {
+    typedef tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc> self;
+    typedef _Key key_type;
+    typedef _Value value_type;
+    typedef list<_Value, _Alloc> list_t;
+    typedef typename list_t::iterator iterator;
+    typedef typename list_t::const_iterator const_iterator;
+    enum segment : unsigned char { __WINDOW__ = 0, __PROBATION__, __PROTECTED__ };
+    typedef hash_table<_Key, std::pair<iterator, segment>, _select_tinylfu_iter_action<_ExtKey>, true, _select_tinylfu_iter_action<_ExtValue>, _Hash, _Alloc> hash_table_t;
+    typedef asso_container::type_traits<_Value, true> _ContainerTypeTraits;
+    typedef typename _ContainerTypeTraits::mapped_type mapped_type;
+
+    static constexpr const size_type _S_window_percent = 1;
+    static constexpr const size_type _S_protected_percent = 80;
+
+protected:
+    list_t _m_lists[3]; // indexed by segment
+    hash_table_t _h;
+    count_min_sketch<_Key, _Hash> _m_sketch;
+    size_type _m_capacity;
+    size_type _m_window_capacity;
+    size_type _m_protected_capacity;
+
+public:
+/// (de)constructor
+    tinylfu_cache(size_type _capacity) : _m_sketch(_capacity) { _M_set_capacity(_capacity); }
+    tinylfu_cache(const self& _rhs) = delete;
+    self& operator=(const self& _rhs) = delete;
+    virtual ~tinylfu_cache() = default;
+
+    size_type size() const { return _h.size(); }
+    size_type capacity() const { return _m_capacity; }
+    bool empty() const { return size() == 0; }
+    void clear();
+    // the frequencies are forgotten
+    void resize(size_type _new_capacity);
+    const_iterator get(const key_type& _k);
+    void put(const value_type& _v);
+
+    const_iterator cend() const { return _m_lists[__WINDOW__].cend(); }
+    const count_min_sketch<_Key, _Hash>& sketch() const { return _m_sketch; }
+
+    template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A>
+     friend std::ostream& operator<<(std::ostream& _os, const tinylfu_cache<_K, _T, _Ek, _Ev, _H, _A>& _x);
+
+    int check() const;
+
+protected:
+    size_type _M_main_capacity() const { return _m_capacity - _m_window_capacity; }
+    size_type _M_main_size() const { return _m_lists[__PROBATION__].size() + _m_lists[__PROTECTED__].size(); }
+    void _M_set_capacity(size_type _capacity);
+    // move %_i (of %_s) to the front of segment %_t
+    void _M_move(std::pair<iterator, segment>& _i, segment _t);
+    void _M_on_hit(std::pair<iterator, segment>& _i);
+    void _M_erase(iterator _i, segment _s);
+    // the LRU one of probation, or protected if probation is empty
+    segment _M_victim_segment() const;
+    // keep the window, then the protected segment within their capacities
+    void _M_evict();
+};
+
+/// protected implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_set_capacity(size_type _capacity) -> void {
+    _m_capacity = _capacity;
+    _m_window_capacity = _capacity * _S_window_percent / 100;
+    if (_m_window_capacity == 0 && _capacity > 0) {
+        _m_window_capacity = 1;
+    }
+    _m_protected_capacity = _M_main_capacity() * _S_protected_percent / 100;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_move(std::pair<iterator, segment>& _i, segment _t) -> void {
+    _m_lists[_t].splice(_m_lists[_t].cbegin(), _m_lists[_i.second], _i.first);
+    _i.second = _t;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_on_hit(std::pair<iterator, segment>& _i) -> void {
+    if (_i.second != __PROBATION__) {
+        _m_lists[_i.second].move_2_front(_i.first);
+        return;
+    }
+    _M_move(_i, __PROTECTED__);
+    if (_m_lists[__PROTECTED__].size() > _m_protected_capacity) {
+        auto _d = _h.find(_ExtKey()(_m_lists[__PROTECTED__].back()));
+        _M_move(*_d, __PROBATION__);
+    }
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_erase(iterator _i, segment _s) -> void {
+    _h.erase(_ExtKey()(*_i));
+    _m_lists[_s].erase(_i);
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_victim_segment() const -> segment {
+    return _m_lists[__PROBATION__].empty() ? __PROTECTED__ : __PROBATION__;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::_M_evict() -> void {
+    list_t& _window = _m_lists[__WINDOW__];
+    while (_window.size() > _m_window_capacity) {
+        auto _c = _h.find(_ExtKey()(_window.back()));
+        if (_M_main_size() < _M_main_capacity()) {
+            _M_move(*_c, __PROBATION__);
+            continue;
+        }
+        if (_M_main_capacity() == 0) {
+            _M_erase(_c->first, __WINDOW__);
+            continue;
+        }
+        // the admission : the candidate has to be more frequent than the victim
+        const segment _vs = _M_victim_segment();
+        const iterator _v = --_m_lists[_vs].end();
+        if (_m_sketch.frequency(_ExtKey()(*_c->first)) > _m_sketch.frequency(_ExtKey()(*_v))) {
+            _M_erase(_v, _vs);
+            _M_move(*_c, __PROBATION__);
+        }
+        else {
+            _M_erase(_c->first, __WINDOW__);
+        }
+    }
+};
+
+/// public implement
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::clear() -> void {
+    _h.clear();
+    for (auto& _l : _m_lists) {
+        _l.clear();
+    }
+    _m_sketch.clear();
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::resize(size_type _new_capacity) -> void {
+    _M_set_capacity(_new_capacity);
+    _m_sketch.resize(_new_capacity);
+    // the main space shrinks from its LRU end, then the window drains into it
+    while (_M_main_size() > _M_main_capacity()) {
+        const segment _vs = _M_victim_segment();
+        _M_erase(--_m_lists[_vs].end(), _vs);
+    }
+    while (_m_lists[__PROTECTED__].size() > _m_protected_capacity) {
+        _M_move(*_h.find(_ExtKey()(_m_lists[__PROTECTED__].back())), __PROBATION__);
+    }
+    _M_evict();
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::get(const key_type& _k) -> const_iterator {
+    _m_sketch.increment(_k);
+    auto _i = _h.find(_k);
+    if (_i == _h.end()) return cend();
+    _M_on_hit(*_i);
+    return _i->first;
+};
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::put(const value_type& _v) -> void {
+    if (_m_capacity == 0) return;
+    const key_type& _k = _ExtKey()(_v);
+    _m_sketch.increment(_k);
+    auto _i = _h.find(_k);
+    if (_i != _h.end()) {
+        // the value is replaced by a new node in the same segment
+        const segment _s = _i->second;
+        _M_erase(_i->first, _s);
+        _m_lists[_s].push_front(_v);
+        auto _n = _h.insert({_m_lists[_s].begin(), _s}).first;
+        _M_on_hit(*_n);
+        return;
+    }
+    _m_lists[__WINDOW__].push_front(_v);
+    _h.insert({_m_lists[__WINDOW__].begin(), __WINDOW__});
+    _M_evict();
+};
+
+template <typename _K, typename _T, typename _Ek, typename _Ev, typename _H, typename _A> auto
+operator<<(std::ostream& _os, const tinylfu_cache<_K, _T, _Ek, _Ev, _H, _A>& _x) -> std::ostream& {
+    typedef tinylfu_cache<_K, _T, _Ek, _Ev, _H, _A> _Cache;
+    return _os << "{window: " << _x._m_lists[_Cache::__WINDOW__]
+     << ", probation: " << _x._m_lists[_Cache::__PROBATION__]
+     << ", protected: " << _x._m_lists[_Cache::__PROTECTED__] << '}';
+};
+
+template <typename _Key, typename _Value, typename _ExtKey, typename _ExtValue, typename _Hash, typename _Alloc> auto
+tinylfu_cache<_Key, _Value, _ExtKey, _ExtValue, _Hash, _Alloc>::check() const -> int {
+    if (_m_lists[__WINDOW__].size() > _m_window_capacity || _M_main_size() > _M_main_capacity()
+     || _m_lists[__PROTECTED__].size() > _m_protected_capacity) {
+        return 1;
+    }
+    if (_h.size() != _m_lists[__WINDOW__].size() + _M_main_size()) {
+        return 2;
+    }
+    for (unsigned _s = __WINDOW__; _s <= __PROTECTED__; ++_s) {
+        for (const_iterator _i = _m_lists[_s].cbegin(); _i != _m_lists[_s].cend(); ++_i) {
+            const auto _j = _h.find(_ExtKey()(*_i));
+            if (_j == _h.cend() || const_iterator(_j->first) != _i || _j->second != _s) {
+                return 3;
+            }
+        }
+    }
+    return 0;
+};
+
+};
+
+#endif // _ASP_TINYLFU_CACHE_HPP_
@@ -9,6 +9,7 @@ namespace asp {
 
 template <typename _Tp> struct bitree_node;
 template <typename _Tp> struct bitree_header;
+template <typename _Node> struct bitree_augment;
 
 /**
  * @brief the canonical structure of an ordered binary tree
@@ -36,6 +37,8 @@ template <typename _Node> _Node* _S_minimum(_Node* _x);
 
 template <typename _Node> void _S_left_rotate(_Node* _x, _Node* _header);
 template <typename _Node> void _S_right_rotate(_Node* _x, _Node* _header);
+// rotate %_x up to the place of its parent (%_x must not be the root)
+template <typename _Node> void _S_rotate_up(_Node* _x, _Node* _header);
 /**
  * @brief find the least node (r) greater than %_x
  * @details 4 cases :
@@ -59,6 +62,18 @@ template <typename _Node> _Node* _S_bitree_node_decrease(_Node* _x);
 template <typename _Comp, typename _ExtKey, typename _Node> int _S_check(const _Node* _header, size_type _n);
 };
 
+/**
+ * @brief augmentation of binary tree nodes (e.g. subtree max in @interval_tree_node)
+ * @details %_S_update(_x) recomputes the augmented data of %_x from its value and children,
+ *   the tree calls it on every node whose subtree has changed, from bottom to top,
+ *   including the two nodes of each rotation in @__bitree__ helpers.
+ *   it does nothing by default, augmented node types specialize it with %value = true.
+*/
+template <typename _Node> struct bitree_augment {
+    static constexpr bool value = false;
+    static void _S_update(_Node*) {}
+};
+
 template <typename _Tp> struct bitree_node : node<_Tp> {
     typedef node<_Tp> base;
     typedef bitree_node<_Tp> self;
@@ -97,6 +112,14 @@ template <typename _Tp> struct bitree_node : node<_Tp> {
 
     void reset() { _parent = nullptr; _left = nullptr; _right = nullptr; }
 
+    /**
+     * @brief parent accessors used by @__bitree__ helpers.
+     * @details nodes that pack extra bits into the parent link (e.g. @rb_tree_compact_node)
+     *   provide the same pair of functions instead of a plain %_parent field.
+    */
+    self* _M_parent() const { return _parent; }
+    void _M_set_parent(self* _p) { _parent = _p; }
+
     void hook_left(self* const _p) {
         
     }
@@ -206,11 +229,11 @@ template <typename _Node> void _S_left_rotate(_Node* _x, _Node* _header) {
     if (_right_child == nullptr) {
         return ;
     }
-    _Node* _this_parent = _x->_parent;
-    _right_child->_parent = _this_parent;
+    _Node* _this_parent = _x->_M_parent();
+    _right_child->_M_set_parent(_this_parent);
     if (_this_parent != nullptr) {
-        if (_x == _header->_parent) {
-            _header->_parent = _right_child;
+        if (_x == _header->_M_parent()) {
+            _header->_M_set_parent(_right_child);
         }
         else if (_x == _this_parent->_left) {
             _this_parent->_left = _right_child;
@@ -221,21 +244,23 @@ template <typename _Node> void _S_left_rotate(_Node* _x, _Node* _header) {
     }
     _x->_right = _right_child->_left;
     if (_right_child->_left != nullptr) {
-        _right_child->_left->_parent = _x;
+        _right_child->_left->_M_set_parent(_x);
     }
     _right_child->_left = _x;
-    _x->_parent = _right_child;
+    _x->_M_set_parent(_right_child);
+    bitree_augment<_Node>::_S_update(_x);
+    bitree_augment<_Node>::_S_update(_right_child);
 }
 template <typename _Node> void _S_right_rotate(_Node* _x, _Node* _header) {
     _Node* _left_child = _x->_left;
     if (_left_child == nullptr) {
         return ;
     }
-    _Node* _this_parent = _x->_parent;
-    _left_child->_parent = _this_parent;
+    _Node* _this_parent = _x->_M_parent();
+    _left_child->_M_set_parent(_this_parent);
     if (_this_parent != nullptr) {
-        if (_x == _header->_parent) {
-            _header->_parent = _left_child;
+        if (_x == _header->_M_parent()) {
+            _header->_M_set_parent(_left_child);
         }
         else if (_x == _this_parent->_left) {
             _this_parent->_left = _left_child;
@@ -246,11 +271,22 @@ template <typename _Node> void _S_right_rotate(_Node* _x, _Node* _header) {
     }
     _x->_left = _left_child->_right;
     if (_left_child->_right != nullptr) {
-        _left_child->_right->_parent = _x;
+        _left_child->_right->_M_set_parent(_x);
     }
     _left_child->_right = _x;
-    _x->_parent = _left_child;
+    _x->_M_set_parent(_left_child);
+    bitree_augment<_Node>::_S_update(_x);
+    bitree_augment<_Node>::_S_update(_left_child);
 }
+template <typename _Node> void _S_rotate_up(_Node* _x, _Node* _header) {
+    _Node* const _p = _x->_M_parent();
+    if (_x == _p->_left) {
+        _S_right_rotate(_p, _header);
+    }
+    else {
+        _S_left_rotate(_p, _header);
+    }
+};
 
 template <typename _Node> _Node* _S_bitree_node_increase(_Node* _x) {
     if (_x->_right != nullptr) {  // for case 4
@@ -260,13 +296,13 @@ template <typename _Node> _Node* _S_bitree_node_increase(_Node* _x) {
         }
     }
     else {
-        _Node* _y = _x->_parent;
+        _Node* _y = _x->_M_parent();
         while (_y != nullptr && _x == _y->_right) {
             // for case 1, 2
             // find the first node in %_x's ancestor nodes,
             // whose r-child's power won't equal to the original %_x
             _x = _y;
-            _y = _y->_parent;
+            _y = _y->_M_parent();
         }
         if (_x->_right != _y) { // for case 3, used for bitree_header, which manage the nodes
             _x = _y;
@@ -275,7 +311,7 @@ template <typename _Node> _Node* _S_bitree_node_increase(_Node* _x) {
     return _x;
 };
 template <typename _Node> _Node* _S_bitree_node_decrease(_Node* _x) {
-    if (_x->_parent->_parent == _x) {  // for case 2
+    if (_x->_M_parent()->_M_parent() == _x) {  // for case 2
         _x = _x->_right;
     }
     else if (_x->_left != nullptr) {  // for case 1
@@ -286,12 +322,12 @@ template <typename _Node> _Node* _S_bitree_node_decrease(_Node* _x) {
         _x = _y;
     }
     else {
-        _Node* _y = _x->_parent;
+        _Node* _y = _x->_M_parent();
         while (_y != nullptr && _x == _y->_left) {  // for case 3, 4
             // find the first node in %_x's ancestor nodes,
             // whose l-child's power won't equal to the original %_x
             _x = _y;
-            _y = _y->_parent;
+            _y = _y->_M_parent();
         }
         _x = _y;
     }
@@ -306,7 +342,7 @@ template <typename _Node> _Node* _S_bitree_node_decrease(_Node* _x) {
  *   3 : error in %_node_count .
 */
 template <typename _Comp, typename _ExtKey, typename _Node> int _S_check(const _Node* _header, size_type _n) {
-    const _Node* _root = _header->_parent;
+    const _Node* _root = _header->_M_parent();
     if (_root == nullptr) { return 0; }
     const _Node* _leftmost = _S_minimum(_root);
     const _Node* _rightmost = _S_maximum(_root);
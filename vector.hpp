@@ -113,8 +113,8 @@ public:
     }
     value_type& front() { return *(m_data.start); }
     const value_type& front() const { return *(m_data.start); }
-    value_type& back() { return *(m_data.end - 1); }
-    const value_type& back() const { return *(m_data.end - 1); }
+    value_type& back() { return *(m_data.finish - 1); }
+    const value_type& back() const { return *(m_data.finish - 1); }
     pointer data() { return m_data.start; }
     const pointer data() const { return m_data.start; }
 
@@ -183,13 +183,20 @@ public:
         }
     }
 
+    // exchange the storage with %_x, the allocators are assumed to be equal
+    void swap(self& _x) {
+        std::swap(this->m_data.start, _x.m_data.start);
+        std::swap(this->m_data.finish, _x.m_data.finish);
+        std::swap(this->m_data.end_of_storage, _x.m_data.end_of_storage);
+    }
+
     /// allocator
     allocator_type get_allocator() const {
         return allocator_type(this->m_data);
     }
 
     /// ostream
-    template <typename _R> friend std::ostream& operator<<(std::ostream& os, const vector<_R>& v) {
+    friend std::ostream& operator<<(std::ostream& os, const self& v) {
         os << '[';
         for (auto p = v.cbegin(); p != v.cend(); ++p) {
             os << p;